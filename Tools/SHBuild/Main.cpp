@@ -11,13 +11,13 @@
 /*!	\file Main.cpp
 \ingroup MaintenanceTools
 \brief 宿主构建工具：递归查找源文件并编译和静态链接。
-\version r3589
+\version r3653
 \author FrankHB <frankhb1989@gmail.com>
 \since build 473
 \par 创建时间:
 	2014-02-06 14:33:55 +0800
 \par 修改时间:
-	2017-06-27 15:39 +0800
+	2017-08-06 17:05 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -39,8 +39,15 @@ See readme file for details.
 //	NPL::Install*;
 #include YFM_YSLib_Core_YConsole // for YSLib::Consoles;
 #include <ystdex/concurrency.h> // for ystdex::task_pool;
+#include <atomic> // for std::atomic;
+#include <random> // for std::random_device;
 #include YFM_YCLib_Host // for platform_ex::EncodeArg, platform_ex::DecodeArg,
-//	platform_ex::Terminal, platform_ex::SetEnvironmentVariable;
+//	platform_ex::Terminal, platform_ex::SetEnvironmentVariable,
+//	platform_ex::FetchPersistentCommandOutput, platform_ex::FetchProcessOutput,
+//	platform_ex::FetchCommandOutput;
+#if !YCL_Win32
+#	include <sys/resource.h> // for ::rusage, ::getrusage, RUSAGE_CHILDREN;
+#endif
 
 using namespace YSLib;
 using namespace IO;
@@ -123,6 +130,13 @@ size_t MaxJobs(0);
 BuildMode Mode(BuildMode::AR);
 //! \since build 556
 string TargetName;
+//! \since build 816
+//@{
+size_t UnityBatchSize(0);
+set<string> UnityExcludedFiles;
+//@}
+//! \since build 817
+string TraceFile;
 const struct Option
 {
 	const char *prefix, *name = {}, *option_arg;
@@ -247,6 +261,29 @@ const struct Option
 		" Default value is '1'.",
 		"If this option occurs more than once, only the last one is"
 		" effective."}},
+	{"-xunity,", "unity batch size", "BATCH_SIZE", [](opt_uint uval){
+		PrintInfo("Set unity batch size = " + to_string(uval) + '.');
+		UnityBatchSize = size_t(uval);
+	}, 0x10000UL, {"Max count of source files merged into each generated"
+		" unity translation unit in a directory.",
+		"Files with same compiler command in a directory are merged in the"
+		" order of names. Generated sources are put in the output directory."
+		" If this value is not more than 1, unity build is disabled. Default"
+		" value is 0.", OPT_des_last}},
+	{"-xux,", "unity excluded files", "FILE_NAME", [](string&& val){
+		PrintInfo("Source file " + Quote(val) + " should be excluded from"
+			" unity build.");
+		UnityExcludedFiles.emplace(std::move(val));
+	}, {"The name of source file which should be built separately when unity"
+		" build is enabled.", OPT_des_mul}},
+	{"-xtrace,", "trace file", "FILE_PATH", [](string&& val){
+		PrintInfo("Build trace file is switched to " + Quote(val) + '.');
+		TraceFile = std::move(val);
+	}, {"The path of the build trace file to be written in Chrome trace event"
+		" format after building.", "If this option is set, timing of phases and"
+		" jobs are recorded, and a summary of the slowest translation units,"
+		" job time, pool utilization and critical path is printed.",
+		OPT_des_last}},
 	{"-xn,", "Target name", "OBJ_NAME", [](string&& val){
 		PrintInfo("Target name is switched to " + Quote(val) + '.');
 		TargetName = std::move(val);
@@ -265,7 +302,13 @@ const array<const char*, 3> DeEnvs[]{
 	{{"SHBuild_CFLAGS", "", "Flags used in command options when the C complier"
 		" is called."}},
 	{{"SHBuild_CXXFLAGS", "", "Flags used in command options when the C++"
-		" complier is called."}}
+		" complier is called."}},
+	{{"SHBuild_ObjectCacheDir", "", "Directory of the object cache keyed by"
+		" the preprocessed source and the command line. Empty value disables"
+		" the cache."}},
+	{{"SHBuild_ObjectCacheSize", "1073741824", "Max size in bytes of the"
+		" object cache. Least recently used entries exceeding the size are"
+		" removed after build."}}
 };
 //@}
 
@@ -337,6 +380,58 @@ CheckedLoad(const char* name, std::istream& is, NPL::A1::REPLContext& context)
 //! \since build 797
 ArgumentsVector CommandArguments;
 
+/*!
+\brief 查找命令行第一个词指定的可执行文件路径。
+\return 若在 PATH 中找到则为路径，否则为命令名。
+\note 用于持久化命令缓冲的依赖项；不处理转义。
+\since build 813
+*/
+string
+SearchCommandExecutable(const string& cmd)
+{
+	const auto b(cmd.find_first_not_of(" \t"));
+
+	if(b == string::npos)
+		return {};
+
+	const bool quoted(cmd[b] == '"');
+	const auto e(quoted ? cmd.find('"', b + 1)
+		: cmd.find_first_of(" \t", b));
+	const auto name(cmd.substr(b + size_t(quoted), e == string::npos
+		? string::npos : e - b - size_t(quoted)));
+
+	if(name.find_first_of("/\\") == string::npos)
+	{
+		string paths;
+#if YCL_Win32
+		const char delim(';');
+#else
+		const char delim(':');
+#endif
+
+		FetchEnvironmentVariable(paths, "PATH");
+		for(size_t pos(0); pos < paths.length(); )
+		{
+			const auto next(std::min(paths.find(delim, pos), paths.length()));
+
+			if(next != pos)
+			{
+				auto res(paths.substr(pos, next - pos) + '/' + name);
+
+				if(ufexists(res.c_str()))
+					return res;
+#if YCL_Win32
+				res += ".exe";
+				if(ufexists(res.c_str()))
+					return res;
+#endif
+			}
+			pos = next + 1;
+		}
+	}
+	return name;
+}
+
 //! \since build 796
 YB_NONNULL(1) void
 RunNPLFromStream(const char* name, std::istream&& is)
@@ -369,6 +464,27 @@ RunNPLFromStream(const char* name, std::istream&& is)
 		}, term);
 		return ReductionStatus::Retained;
 	});
+	// NOTE: Same to %system-get, but results are cached persistently in the
+	//	directory specified by environment variable %SHBuild_CommandCacheDir
+	//	if it is not empty. Environment variables affecting lookup of the
+	//	command and results of %pkg-config are part of the key. Results with
+	//	nonzero exit status are not cached.
+	RegisterStrict(root, "system-get-cached", [](TermNode& term){
+		CallUnaryAs<const string>([&](const string& cmd){
+			string dir;
+
+			FetchEnvironmentVariable(dir, "SHBuild_CommandCacheDir");
+
+			auto res(FetchPersistentCommandOutput(cmd, dir, {"SHELL", "PATH",
+				"PKG_CONFIG_PATH", "PKG_CONFIG_LIBDIR"},
+				{SearchCommandExecutable(cmd)}));
+
+			term.Clear();
+			term.AddValue(MakeIndex(0), ystdex::trim(std::move(res.first)));
+			term.AddValue(MakeIndex(1), res.second);
+		}, term);
+		return ReductionStatus::Retained;
+	});
 	RegisterStrictUnary<const string>(root, "load", [&](const string& src){
 		platform::ifstream ifs(src, std::ios_base::in);
 
@@ -398,6 +514,764 @@ RunNPLFromStream(const char* name, std::istream&& is)
 	CheckedLoad(name, is, context);
 }
 
+
+//! \since build 814
+//@{
+#if YCL_Win32
+/*!
+\brief 按 Win32 命令行的引用规则分解简单命令行为参数。
+\return 是否只包含不需要命令解释器处理的参数。
+\since build 823
+
+支持空白符分隔和双引号；反斜杠仅在双引号前转义，
+	规则同 \c ::CommandLineToArgvW 。
+遇到需要 cmd 展开、重定向或复合命令的未引用字符或换行符时失败，
+	此时应由命令解释器执行。
+*/
+bool
+SplitCommandArguments(const string& cmd, vector<string>& args)
+{
+	string arg;
+	bool in_arg{}, quoted{};
+
+	args.clear();
+	for(size_t i(0); i < cmd.length(); ++i)
+	{
+		const char c(cmd[i]);
+
+		switch(c)
+		{
+		case ' ':
+		case '\t':
+			if(quoted)
+				break;
+			if(in_arg)
+			{
+				args.push_back(std::move(arg));
+				arg.clear();
+				in_arg = {};
+			}
+			continue;
+		case '\n':
+		case '\r':
+			return {};
+		case '"':
+			quoted = !quoted;
+			in_arg = true;
+			continue;
+		case '\\':
+			{
+				const auto e(cmd.find_first_not_of('\\', i));
+				const auto n(e == string::npos ? cmd.length() - i : e - i);
+
+				if(e != string::npos && cmd[e] == '"')
+				{
+					arg.append(n / 2, '\\');
+					if(n % 2 != 0)
+						arg += '"';
+					else
+						quoted = !quoted;
+					i = e;
+				}
+				else
+				{
+					arg.append(n, '\\');
+					i += n - 1;
+				}
+			}
+			in_arg = true;
+			continue;
+		case '%':
+			// NOTE: Variables are expanded by %cmd even in quotes.
+			return {};
+		default:
+			if(!quoted && string_view("&|<>()^!").find(c) != string_view::npos)
+				return {};
+		}
+		arg += c;
+		in_arg = true;
+	}
+	if(quoted)
+		return {};
+	if(in_arg)
+		args.push_back(std::move(arg));
+	return !args.empty();
+}
+#else
+/*!
+\brief 按 POSIX 命令解释器的引用规则分解简单命令行为参数。
+\return 是否只包含不需要命令解释器处理的参数。
+
+支持空白符分隔、单引号、双引号和反斜杠转义；遇到需要展开、重定向或复合命令的
+	未引用字符或换行符时失败，此时应由命令解释器执行。
+*/
+bool
+SplitCommandArguments(const string& cmd, vector<string>& args)
+{
+	string arg;
+	bool in_arg{}, assignable(true);
+
+	args.clear();
+	for(size_t i(0); i < cmd.length(); ++i)
+	{
+		const char c(cmd[i]);
+
+		switch(c)
+		{
+		case '\n':
+			// NOTE: Unquoted newlines separate commands.
+			return {};
+		case ' ':
+		case '\t':
+			if(in_arg)
+			{
+				args.push_back(std::move(arg));
+				arg.clear();
+				yunseq(in_arg = {}, assignable = {});
+			}
+			continue;
+		case '\'':
+			{
+				const auto e(cmd.find('\'', i + 1));
+
+				if(e == string::npos)
+					return {};
+				arg.append(cmd, i + 1, e - i - 1);
+				i = e;
+			}
+			break;
+		case '"':
+			for(++i; i < cmd.length() && cmd[i] != '"'; ++i)
+			{
+				if(cmd[i] == '$' || cmd[i] == '`')
+					return {};
+				if(cmd[i] == '\\' && i + 1 < cmd.length()
+					&& string_view("$`\"\\\n").find(cmd[i + 1])
+					!= string_view::npos)
+					++i;
+				arg += cmd[i];
+			}
+			if(i == cmd.length())
+				return {};
+			break;
+		case '\\':
+			if(++i == cmd.length())
+				return {};
+			arg += cmd[i];
+			break;
+		case '#':
+		case '~':
+			if(!in_arg)
+				return {};
+			arg += c;
+			break;
+		case '=':
+			// NOTE: Variable assignments are not supported.
+			if(assignable)
+				return {};
+			arg += c;
+			break;
+		default:
+			if(string_view("|&;<>()$`*?[").find(c) != string_view::npos)
+				return {};
+			arg += c;
+		}
+		in_arg = true;
+	}
+	if(in_arg)
+		args.push_back(std::move(arg));
+	return !args.empty();
+}
+#endif
+
+//! \brief 作业输出互斥量，保证并发作业的输出不交错。
+std::mutex JobOutputMutex;
+
+/*!
+\brief 执行命令并取标准输出和标准错误上的结果。
+\return 输出和命令的返回值。
+\since build 815
+
+对简单命令不经过命令解释器直接创建进程执行，否则使用命令解释器。
+Win32 平台：创建进程失败时使用命令解释器重新执行，以支持命令解释器的内建命令。
+*/
+pair<string, int>
+FetchCommandResult(const string& cmd)
+{
+	pair<string, int> res;
+
+	try
+	{
+		vector<string> args;
+
+#if YCL_Win32
+		// NOTE: Commands built in %cmd are not programs, so they are retried by
+		//	the command interpreter after creation of the process failed.
+		if(SplitCommandArguments(cmd, args))
+			TryRet(FetchProcessOutput(args))
+			CatchIgnore(std::system_error&)
+		res = FetchCommandOutput(("(" + cmd + ") 2>&1").c_str());
+#else
+		if(SplitCommandArguments(cmd, args))
+			res = FetchProcessOutput(args);
+		else
+			res = FetchCommandOutput(("exec 2>&1; " + cmd).c_str());
+#endif
+	}
+	catch(std::system_error& e)
+	{
+		PrintInfo("Failed executing command: " + string(e.what()) + '.', Err,
+			LogGroup::Command);
+		// NOTE: Same to exit code of POSIX command interpreter for commands
+		//	not found.
+		res.second = 127;
+	}
+	return res;
+}
+
+/*!
+\brief 执行命令并在结束后整体输出标准输出和标准错误上的结果。
+\return 命令的返回值。
+\sa FetchCommandResult
+*/
+int
+RunCommand(const string& cmd)
+{
+	const auto res(FetchCommandResult(cmd));
+
+	if(!res.first.empty())
+	{
+		std::lock_guard<std::mutex> lck(JobOutputMutex);
+
+		// XXX: Errors are ignored.
+		std::fwrite(res.first.data(), 1, res.first.size(), stderr);
+		std::fflush(stderr);
+	}
+	return res.second;
+}
+//@}
+
+
+//! \since build 815
+//@{
+/*!
+\brief 计算内容散列值。
+\return 以两个不同初始值的 64 位 FNV-1a 散列值组成的 32 位十六进制数字符串。
+\note 不保证抗碰撞攻击，仅用于标识缓冲项。
+*/
+string
+HashContent(const string& str)
+{
+	std::uint64_t h1(0xCBF29CE484222325ULL), h2(0x6C62272E07BB0142ULL);
+	char buf[33];
+
+	for(const auto c : str)
+	{
+		const auto b(std::uint64_t(static_cast<unsigned char>(c)));
+
+		yunseq(h1 = (h1 ^ b) * 0x100000001B3ULL,
+			h2 = (h2 ^ (b + 0x9EULL)) * 0x100000001B3ULL);
+	}
+	std::snprintf(buf, sizeof(buf), "%016llx%016llx",
+		static_cast<unsigned long long>(h1),
+		static_cast<unsigned long long>(h2));
+	return buf;
+}
+
+/*!
+\brief 目标文件缓冲。
+
+以预处理结果、编译命令行和编译器标识的散列值为键，在本地目录中保存目标文件及其
+	依赖文件。命中时以硬链接恢复目标文件，失败时复制。
+写入的缓冲项先保存为临时文件再重命名，因此多个进程可并发使用同一目录。
+缓冲项的修改时间在命中时更新，用于按最近最少使用的顺序清理超过大小限制的缓冲项。
+*/
+class ObjectCache final : private ystdex::noncopyable
+{
+private:
+	string directory;
+	std::uint64_t max_size;
+	mutable std::atomic<size_t> hits{0}, misses{0}, uncached{0};
+
+public:
+	ObjectCache(string dir, std::uint64_t size)
+		: directory(std::move(dir)), max_size(size)
+	{
+		EnsureDirectory(directory);
+	}
+
+	DefGetter(const ynothrow, const string&, Directory, directory)
+
+	/*!
+	\brief 按缓冲编译。
+	\return 编译命令或恢复缓冲项的结果。
+	\note 参数依次为编译器命令、编译命令行、预处理命令行、目标文件和依赖文件路径。
+	*/
+	int
+	Compile(const string&, const string&, const string&, const string&,
+		const string&) const;
+
+	//! \brief 按最近最少使用的顺序清理超过大小限制的缓冲项。
+	void
+	Evict() const;
+
+	//! \brief 打印命中率统计。
+	void
+	PrintStatistics() const;
+
+private:
+	bool
+	Restore(const string&, const string&, const string&) const;
+
+	void
+	Store(const string&, const string&, const string&) const;
+
+	static void
+	StoreFile(const string&, const string&, bool);
+};
+
+int
+ObjectCache::Compile(const string& cmd, const string& cmd_line,
+	const string& pp_line, const string& ofile, const string& dfile) const
+{
+	const auto pp(FetchCommandResult(pp_line));
+
+	if(pp.second == 0)
+	{
+		const auto& exe(SearchCommandExecutable(cmd));
+		string key(exe);
+
+		key += '@';
+		TryExpr(key += to_string(GetFileModificationTimeOf(exe.c_str(),
+			true).count()))
+		CatchIgnore(std::exception&)
+		key += '\0' + cmd_line + '\0' + pp.first;
+
+		const auto name(directory + '/' + HashContent(key));
+
+		if(Restore(name, ofile, dfile))
+		{
+			++hits;
+			PrintInfo("Object cache hit: " + Quote(ofile) + '.', Informative,
+				LogGroup::Build);
+			return 0;
+		}
+		++misses;
+		// NOTE: The output can be a hard link to a cache entry, which shall
+		//	not be overwritten in place by the compiler.
+		uremove(ofile.c_str());
+
+		const int res(RunCommand(cmd_line));
+
+		if(res == 0)
+			FilterExceptions([&]{
+				Store(name, ofile, dfile);
+			}, "storing object cache entry");
+		return res;
+	}
+	++uncached;
+	uremove(ofile.c_str());
+	return RunCommand(cmd_line);
+}
+
+void
+ObjectCache::Evict() const
+{
+	struct Entry
+	{
+		platform::FileTime Time;
+		std::uint64_t Size;
+		string Name;
+	};
+	vector<Entry> entries;
+	std::uint64_t total(0);
+
+	TraverseChildren(directory, [&](NodeCategory c, NativePathView npv){
+		const auto& name(String(npv).GetMBCS());
+
+		if(!bool(c & NodeCategory::Directory) && name.length() == 34
+			&& ystdex::ends_with(name, ".o"))
+			FilterExceptions([&]{
+				const auto path(directory + '/' + name);
+				const auto p_file(OpenFile(path.c_str(),
+					omode_convb(std::ios_base::in)));
+				auto size(p_file->GetSize());
+
+				TryExpr(size += OpenFile((path.substr(0, path.length() - 1)
+					+ 'd').c_str(), omode_convb(std::ios_base::in))->GetSize())
+				CatchIgnore(std::system_error&)
+				total += size;
+				entries.push_back({p_file->GetModificationTime(), size,
+					path.substr(0, path.length() - 1)});
+			}, "checking object cache entry");
+	});
+	if(total > max_size)
+	{
+		size_t n(0);
+
+		std::sort(entries.begin(), entries.end(),
+			[](const Entry& x, const Entry& y) ynothrow{
+			return x.Time < y.Time;
+		});
+		for(const auto& entry : entries)
+		{
+			if(total <= max_size)
+				break;
+			// NOTE: The object file is removed first to make the entry
+			//	invisible to concurrent readers.
+			uremove((entry.Name + 'o').c_str());
+			uremove((entry.Name + 'd').c_str());
+			total -= entry.Size;
+			++n;
+		}
+		PrintInfo("Evicted " + to_string(n) + " object cache entr"
+			+ (n == 1 ? "y." : "ies."), Informative, LogGroup::Build);
+	}
+}
+
+void
+ObjectCache::PrintStatistics() const
+{
+	const size_t n_hits(hits), n_misses(misses), n_uncached(uncached);
+
+	if(n_hits + n_misses + n_uncached != 0)
+		PrintInfo(ystdex::sfmt("Object cache: %zu hit(s), %zu miss(es), %zu"
+			" uncacheable, hit rate %.1f%%.", n_hits, n_misses, n_uncached,
+			n_hits + n_misses != 0 ? 100. * n_hits / (n_hits + n_misses) : 0.),
+			Informative, LogGroup::Build);
+}
+
+bool
+ObjectCache::Restore(const string& name, const string& ofile,
+	const string& dfile) const
+{
+	const auto entry_o(name + ".o"), entry_d(name + ".d");
+
+	try
+	{
+		if(ufexists(entry_o.c_str()) && ufexists(entry_d.c_str()))
+		{
+			// NOTE: The dependency file is copied since it would be rewritten
+			//	in place by the compiler.
+			CopyFile(dfile.c_str(), entry_d.c_str());
+			uremove(ofile.c_str());
+			// TODO: Use reflink when supported by the file system.
+			TryExpr(CreateHardLink(ofile.c_str(), entry_o.c_str()))
+			CatchExpr(std::system_error&,
+				CopyFile(ofile.c_str(), entry_o.c_str()))
+			// NOTE: Update modification time both for least recently use
+			//	order and for the later dependency check of the output.
+			OpenFile(entry_o.c_str(), omode_convb(std::ios_base::in
+				| std::ios_base::out))->SetModificationTime(
+				std::chrono::duration_cast<platform::FileTime>(
+				system_clock::now().time_since_epoch()));
+			return true;
+		}
+	}
+	catch(std::exception& e)
+	{
+		// NOTE: The entry may be evicted concurrently.
+		PrintInfo("Failed restoring object cache entry " + Quote(name) + ": "
+			+ e.what(), Debug, LogGroup::Build);
+		uremove(ofile.c_str());
+	}
+	return {};
+}
+
+void
+ObjectCache::Store(const string& name, const string& ofile,
+	const string& dfile) const
+{
+	// NOTE: The object file is stored last as the mark of complete entry.
+	StoreFile(name + ".d", dfile, {});
+	StoreFile(name + ".o", ofile, true);
+}
+
+void
+ObjectCache::StoreFile(const string& dst, const string& src, bool link)
+{
+	static std::atomic<unsigned long> counter{0};
+	static const auto seed(std::random_device{}());
+	const auto tmp(dst + '.' + to_string(seed) + '.' + to_string(++counter)
+		+ ".tmp");
+
+	try
+	{
+		if(link)
+			TryExpr(CreateHardLink(tmp.c_str(), src.c_str()))
+			CatchExpr(std::system_error&, CopyFile(tmp.c_str(), src.c_str()))
+		else
+			CopyFile(tmp.c_str(), src.c_str());
+		// NOTE: On Win32 the existing entry is kept when renaming fails.
+		if(std::rename(tmp.c_str(), dst.c_str()) != 0)
+			uremove(tmp.c_str());
+	}
+	catch(...)
+	{
+		uremove(tmp.c_str());
+		throw;
+	}
+}
+//@}
+
+
+#if !YCL_Win32
+/*!
+\brief 取已终止并被等待的子进程的用户和系统 CPU 时间。
+\return 失败时为零。
+\since build 823
+*/
+pair<nanoseconds, nanoseconds>
+FetchChildrenCPUTimes() ynothrow
+{
+	::rusage ru;
+
+	if(::getrusage(RUSAGE_CHILDREN, &ru) == 0)
+		return {seconds(ru.ru_utime.tv_sec) + microseconds(ru.ru_utime.tv_usec),
+			seconds(ru.ru_stime.tv_sec) + microseconds(ru.ru_stime.tv_usec)};
+	return {};
+}
+#endif
+
+
+/*!
+\brief 构建时间跟踪。
+\note 线程安全。
+\since build 817
+
+记录各阶段和作业的起止时间，输出 Chrome 跟踪事件格式的 JSON 文件和统计摘要。
+*/
+class BuildTrace final : private ystdex::noncopyable
+{
+public:
+	using TimePoint = steady_clock::time_point;
+
+private:
+	struct Event
+	{
+		string Category;
+		string Name;
+		TimePoint Start, End;
+		size_t Thread;
+		//! \brief 作业在任务池中等待的时间。
+		nanoseconds Wait;
+	};
+
+	TimePoint start{steady_clock::now()};
+#if !YCL_Win32
+	//! \since build 823
+	pair<nanoseconds, nanoseconds> cpu_start{FetchChildrenCPUTimes()};
+#endif
+	mutable std::mutex mtx{};
+	mutable vector<Event> events{};
+	mutable map<std::thread::id, size_t> threads{};
+
+public:
+	//! \brief 记录事件。
+	void
+	Record(string, string, TimePoint, TimePoint = steady_clock::now(),
+		nanoseconds = {}) const;
+
+	/*!
+	\brief 包装作业函数以记录执行和等待时间。
+	\note 等待时间从调用此函数开始计算。
+	*/
+	std::function<int()>
+	Wrap(string, string, std::function<int()>) const;
+
+	/*!
+	\brief 打印统计摘要：最慢的作业、时间统计、任务池利用率和关键路径。
+	\note 关键路径从最后完成的作业开始，沿同一线程上占用任务池的作业回溯，
+		并包括链接。
+	\note 非 Win32 平台：同时打印子进程的 CPU 时间。
+	*/
+	void
+	PrintSummary(size_t) const;
+
+	//! \brief 写入 Chrome 跟踪事件格式的 JSON 文件。
+	void
+	Write(const string&) const;
+};
+
+void
+BuildTrace::Record(string cat, string name, TimePoint b, TimePoint e,
+	nanoseconds wait) const
+{
+	std::lock_guard<std::mutex> lck(mtx);
+	const auto tid(threads.emplace(std::this_thread::get_id(),
+		threads.size()).first->second);
+
+	events.push_back({std::move(cat), std::move(name), b, e, tid, wait});
+}
+
+std::function<int()>
+BuildTrace::Wrap(string cat, string name, std::function<int()> f) const
+{
+	const auto queued(steady_clock::now());
+
+	return [=]{
+		const auto b(steady_clock::now());
+		const auto gd(ystdex::make_guard([&]{
+			Record(cat, name, b, steady_clock::now(), b - queued);
+		}));
+
+		return f();
+	};
+}
+
+void
+BuildTrace::PrintSummary(size_t n_jobs) const
+{
+	std::lock_guard<std::mutex> lck(mtx);
+	const auto print(std::bind(PrintInfo, _1, Informative, LogGroup::Build));
+	const auto ms([](nanoseconds d){
+		return ystdex::sfmt("%.3fms", duration<double, std::milli>(d).count());
+	});
+	const auto wall(steady_clock::now() - start);
+	vector<const Event*> jobs;
+	nanoseconds job_time{}, wait_time{};
+	TimePoint jobs_begin(TimePoint::max()), jobs_end(start);
+	const Event* p_link{};
+
+	for(const auto& evt : events)
+		if(evt.Category == "compile")
+		{
+			jobs.push_back(&evt);
+			yunseq(job_time += evt.End - evt.Start, wait_time += evt.Wait,
+				jobs_begin = std::min(jobs_begin, evt.Start - evt.Wait),
+				jobs_end = std::max(jobs_end, evt.End));
+		}
+		else if(evt.Category == "link")
+			p_link = &evt;
+	std::sort(jobs.begin(), jobs.end(), [](const Event* x, const Event* y){
+		return x->End - x->Start > y->End - y->Start;
+	});
+	print("Build trace summary:");
+	print("Wall time: " + ms(wall) + ", total job time: " + ms(job_time)
+		+ ", total waiting time in pool: " + ms(wait_time) + '.');
+	if(!jobs.empty())
+	{
+		const auto span(jobs_end - jobs_begin);
+
+		if(span.count() > 0 && n_jobs != 0)
+			print(ystdex::sfmt("Pool utilization: %.1f%% of %zu job slot(s).",
+				100. * job_time.count() / (double(span.count()) * n_jobs),
+				n_jobs));
+		print("Slowest translation units:");
+		for(size_t i(0); i < std::min<size_t>(jobs.size(), 10); ++i)
+			print("  " + ms(jobs[i]->End - jobs[i]->Start) + ' '
+				+ jobs[i]->Name);
+	}
+#if !YCL_Win32
+	{
+		const auto cpu(FetchChildrenCPUTimes());
+		const auto user(cpu.first - cpu_start.first),
+			sys(cpu.second - cpu_start.second);
+
+		if(wall.count() > 0 && (user + sys).count() > 0)
+			print("CPU time of child processes: " + ms(user) + " user + "
+				+ ms(sys) + ystdex::sfmt(" system, %.2f times of wall time.",
+				double((user + sys).count()) / double(wall.count())));
+	}
+#endif
+
+	// NOTE: Compilation jobs do not depend on each other, but a job queued
+	//	in the pool waits for the slot freed by the previous job run on the
+	//	same thread. Without the pool all jobs are run in sequence. So the
+	//	critical path is traced back from the last finished job through such
+	//	jobs, and the link waits for all jobs.
+	vector<const Event*> path;
+	nanoseconds compile_time{};
+
+	if(!jobs.empty())
+		for(auto p(*std::max_element(jobs.begin(), jobs.end(),
+			[](const Event* x, const Event* y){
+			return x->End < y->End;
+		})); p;)
+		{
+			const auto queued(p->Start - p->Wait);
+			const Event* p_prev{};
+
+			path.push_back(p);
+			compile_time += p->End - p->Start;
+			for(const auto q : jobs)
+				if(q->Thread == p->Thread && q->End <= p->Start
+					&& (n_jobs <= 1 || q->End > queued)
+					&& (!p_prev || q->End > p_prev->End))
+					p_prev = q;
+			p = p_prev;
+		}
+
+	const auto path_start(path.empty() ? (p_link ? p_link->Start : start)
+		: path.back()->Start);
+	const auto path_end(p_link ? p_link->End
+		: (path.empty() ? start : path.front()->End));
+	const auto link_time(p_link ? p_link->End - p_link->Start : nanoseconds());
+
+	print("Critical path: " + ms(path_end - start) + " = " + ms(path_start
+		- start) + " before jobs + " + ms(compile_time) + " compiling "
+		+ to_string(path.size()) + " job(s) + " + ms(link_time) + " linking"
+		+ (p_link ? ' ' + p_link->Name : string()) + " + " + ms(path_end
+		- path_start - compile_time - link_time) + " waiting between them.");
+	for(size_t i(0); i < std::min<size_t>(path.size(), 10); ++i)
+	{
+		const auto& evt(*path[path.size() - 1 - i]);
+
+		print("  " + ms(evt.End - evt.Start) + ' ' + evt.Name);
+	}
+	if(path.size() > 10)
+		print("  ... and " + to_string(path.size() - 10) + " more job(s).");
+}
+
+void
+BuildTrace::Write(const string& path) const
+{
+	std::lock_guard<std::mutex> lck(mtx);
+	const auto escape([](const string& str){
+		string res;
+
+		for(const auto c : str)
+			if(c == '"' || c == '\\')
+				(res += '\\') += c;
+			else if(static_cast<unsigned char>(c) < 0x20)
+				res += ystdex::sfmt("\\u%04x", unsigned(c));
+			else
+				res += c;
+		return res;
+	});
+	const auto us([this](TimePoint t){
+		return duration_cast<microseconds>(t - start).count();
+	});
+
+	if(ofstream ofs{path, std::ios_base::out | std::ios_base::trunc})
+	{
+		bool first(true);
+
+		ofs << "{\"traceEvents\":[";
+		for(const auto& evt : events)
+		{
+			if(!first)
+				ofs << ',';
+			first = {};
+			ofs << "\n{\"name\":\"" << escape(evt.Name) << "\",\"cat\":\""
+				<< evt.Category << "\",\"ph\":\"X\",\"ts\":" << us(evt.Start)
+				<< ",\"dur\":" << duration_cast<microseconds>(evt.End
+				- evt.Start).count() << ",\"pid\":1,\"tid\":" << evt.Thread
+				<< ",\"args\":{\"wait_us\":" << duration_cast<microseconds>(
+				evt.Wait).count() << "}}";
+		}
+		ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		if(ofs.flush())
+		{
+			PrintInfo("Build trace written to " + Quote(path) + '.',
+				Informative, LogGroup::Build);
+			return;
+		}
+	}
+	PrintInfo("Failed writing build trace " + Quote(path) + '.', Warning,
+		LogGroup::Build);
+}
+
 } // unnamed namespace;
 
 
@@ -413,6 +1287,10 @@ private:
 	string flags{};
 	//! \since build 624
 	mutable vector<std::future<int>> futures{};
+	//! \since build 815
+	unique_ptr<ObjectCache> p_cache{};
+	//! \since build 817
+	unique_ptr<BuildTrace> p_trace{};
 
 public:
 	set<string> IgnoredDirs{};
@@ -425,6 +1303,13 @@ public:
 	BuildMode Mode = BuildMode::AR;
 	//! \since build 556
 	string TargetName{};
+	//! \since build 816
+	//@{
+	size_t UnityBatchSize = 0;
+	set<string> UnityExcludedFiles{};
+	//@}
+	//! \since build 817
+	string TraceFile{};
 
 	BuildContext(size_t n)
 		: jobs(n)
@@ -445,26 +1330,52 @@ public:
 	//! \since build 547
 	PDefH(const string&, GetEnv, const string& name) const
 		ImplRet(Envs.at(name))
+	//! \since build 815
+	DefGetter(const ynothrow, observer_ptr<const ObjectCache>, ObjectCachePtr,
+		make_observer(p_cache.get()))
+	//! \since build 817
+	DefGetter(const ynothrow, observer_ptr<const BuildTrace>, TracePtr,
+		make_observer(p_trace.get()))
 
 	void
 	Build();
 
+	/*!
+	\brief 若启用构建时间跟踪，包装作业函数以记录时间，否则直接返回作业函数。
+	\since build 817
+	*/
+	PDefH(std::function<int()>, Traced, string cat, string name,
+		std::function<int()> f) const
+		ImplRet(p_trace ? p_trace->Wrap(std::move(cat), std::move(name),
+			std::move(f)) : f)
+
 	//! \since build 540
+	PDefH(int, Call, const string& cmd, size_t n = 0) const
+		ImplRet(Call(cmd, std::bind(RunCommand, cmd), n))
+	/*!
+	\brief 调用命令。
+	\note 第一参数为用于日志的命令，第二参数为实际执行的操作。
+	\since build 815
+	*/
 	int
-	Call(const string&, size_t n = 0) const;
+	Call(const string&, std::function<int()>, size_t n = 0) const;
 
 	//! \since build 539
 	//@{
 	PDefH(void, CallWithException, const string& cmd, size_t n = 0) const
 		ImplExpr(CheckResult(Call(cmd, n)))
+	//! \since build 815
+	PDefH(void, CallWithException, const string& cmd, std::function<int()> f,
+		size_t n = 0) const
+		ImplExpr(CheckResult(Call(cmd, std::move(f), n)))
 
 	static PDefH(void, CheckResult, int ret)
 		ImplExpr(ret == 0 ? void() : raise_exception(ret))
 	//@}
 
-	//! \since build 540
+	//! \since build 815
 	int
-	RunTask(const string&) const;
+	RunTask(const string&, std::function<int()>) const;
 };
 
 
@@ -527,15 +1438,17 @@ BuildFile(const Rule& rule)
 	{
 		const auto& ofullname(rule.Source.second.VerifyAsMBCS());
 		bool build{true};
+		auto dfullname(ofullname);
+
+		YAssert(!dfullname.empty(), "Invalid output name found.");
+		// FIXME: Correct replacement when extension of %ofullname is not 1
+		//	character.
+		dfullname.back() = 'd';
+
+		const auto deps_start(steady_clock::now());
 
 		try
 		{
-			auto dfullname(ofullname);
-
-			YAssert(!dfullname.empty(), "Invalid output name found.");
-			// FIXME: Correct replacement when extension of %ofullname is not
-			//	1 character.
-			dfullname.back() = 'd';
 			if(ifstream tf{dfullname, std::ios_base::in})
 			{
 				const auto printd(std::bind(PrintInfo, _1, _2,
@@ -554,12 +1467,33 @@ BuildFile(const Rule& rule)
 			}
 		}
 		CatchIgnore(std::exception&)
+		if(const auto p_trace = bctx.GetTracePtr())
+			p_trace->Record("deps", fullname, deps_start);
 		if(build)
 		{
+			const auto& flags(bctx.GetFlags(cmd_type));
+			const auto& cmd_line(cmd + " -MMD -c " + flags + ' '
+				+ quote(fullname) + " -o " + quote(ofullname));
+
 			print("Compile file: " + Quote(ipth.back().GetMBCS()) + '.',
 				Informative);
-			bctx.CallWithException(cmd + " -MMD -c " + bctx.GetFlags(
-				cmd_type) + ' ' + quote(fullname) + " -o " + quote(ofullname));
+			if(const auto p_cache = bctx.GetObjectCachePtr())
+			{
+				// NOTE: Warnings are disabled to keep the output of the
+				//	preprocessor clean. They are still reported by the
+				//	compilation on cache misses.
+				const auto& pp_line(cmd + " -E -w " + flags + ' '
+					+ quote(fullname));
+
+				bctx.CallWithException(cmd_line, bctx.Traced("compile",
+					fullname, [=]{
+					return p_cache->Compile(cmd, cmd_line, pp_line, ofullname,
+						dfullname);
+				}));
+			}
+			else
+				bctx.CallWithException(cmd_line, bctx.Traced("compile",
+					fullname, std::bind(RunCommand, cmd_line)));
 		}
 		return {ofullname};
 	}
@@ -568,6 +1502,46 @@ BuildFile(const Rule& rule)
 	return {};
 }
 
+/*!
+\brief 生成包含指定源文件的合并翻译单元。
+\note 内容不变时不写入文件，以保持修改时间用于依赖检查。
+\since build 816
+*/
+template<typename _tIn>
+void
+GenerateUnitySource(const string& dst, const Path& ipth, _tIn first, _tIn last)
+{
+	const auto print(std::bind(PrintInfo, _1, _2, LogGroup::Build));
+	string content("// Unity translation unit generated by SHBuild.\n");
+
+	for(; first != last; ++first)
+		// XXX: Paths with quotes or backslashes are not escaped.
+		content += "#include \"" + to_string(MakeNormalizedAbsolute(ipth
+			/ *first)).GetMBCS() + "\"\n";
+	if(ifstream ifs{dst, std::ios_base::in | std::ios_base::binary})
+	{
+		const string old{std::istreambuf_iterator<char>(ifs),
+			std::istreambuf_iterator<char>()};
+
+		if(old == content)
+		{
+			print("Unity source " + Quote(dst) + " is up-to-date.", Debug);
+			return;
+		}
+	}
+	if(ofstream ofs{dst, std::ios_base::out | std::ios_base::trunc
+		| std::ios_base::binary})
+	{
+		ofs << content;
+		if(ofs.flush())
+		{
+			print("Generated unity source " + Quote(dst) + '.', Informative);
+			return;
+		}
+	}
+	raise_exception(2, "Failed writing unity source " + Quote(dst) + '.');
+}
+
 Value
 SearchDirectory(const Rule& rule, const ActionContext& actx)
 {
@@ -578,6 +1552,8 @@ SearchDirectory(const Rule& rule, const ActionContext& actx)
 	vector<pair<string, string>> src_files;
 	const auto print(std::bind(PrintInfo, _1, _2, LogGroup::Search));
 
+	const auto scan_start(steady_clock::now());
+
 	print("Searching path: " + Quote(path) + " ...", Notice);
 	TraverseChildren(path, [&](NodeCategory c, NativePathView npv){
 		const auto& name(String(npv).GetMBCS());
@@ -605,6 +1581,8 @@ SearchDirectory(const Rule& rule, const ActionContext& actx)
 			}
 		}
 	});
+	if(const auto p_trace = rule.Context.GetTracePtr())
+		p_trace->Record("scan", path, scan_start);
 	for(const auto& name : subdirs)
 		ystdex::vector_concat(ofiles,
 			actx(make_pair(ipth / name, opth / name)));
@@ -615,16 +1593,62 @@ SearchDirectory(const Rule& rule, const ActionContext& actx)
 		+ '.', Informative);
 	if(snum != 0)
 	{
-		EnsureOutputDirectory(opth.VerifyAsMBCS());
-		for(const auto& pr : src_files)
-		{
-			const auto& name(pr.second);
-			auto ofile(actx(make_pair(ipth / name, opth / (name + ".o"))));
+		const auto build([&](const Path& src, const Path& obj){
+			auto ofile(actx(make_pair(src, obj)));
 
 			// XXX: Check size.
 			if(!ofile.empty() && !ofile.front().empty())
 				ofiles.push_back(std::move(ofile.front()));
+		});
+		const auto& bctx(rule.Context);
+
+		EnsureOutputDirectory(opth.VerifyAsMBCS());
+		if(bctx.UnityBatchSize > 1)
+		{
+			// NOTE: Sources are merged by same command in the order of names
+			//	to keep the content of generated sources stable.
+			map<string, vector<string>> groups;
+			size_t n_group(0);
+
+			for(auto& pr : src_files)
+				if(ystdex::exists(bctx.UnityExcludedFiles, pr.second))
+				{
+					print("Source file " + Quote(pr.second)
+						+ " is excluded from unity build.", Informative);
+					build(ipth / pr.second, opth / (pr.second + ".o"));
+				}
+				else
+					groups[pr.first].push_back(std::move(pr.second));
+			for(auto& pr : groups)
+			{
+				auto& names(pr.second);
+				const auto n(names.size());
+
+				std::sort(names.begin(), names.end());
+				for(size_t i(0); i < n; i += bctx.UnityBatchSize)
+				{
+					const auto e(std::min(i + bctx.UnityBatchSize, n));
+
+					if(e - i == 1)
+						build(ipth / names[i], opth / (names[i] + ".o"));
+					else
+					{
+						const auto uname("SHBuild_unity_" + to_string(n_group)
+							+ '_' + to_string(i / bctx.UnityBatchSize) + '.'
+							+ GetExtensionOf(names.front()));
+
+						GenerateUnitySource(to_string(opth / uname).GetMBCS(),
+							ipth, std::next(names.cbegin(), ptrdiff_t(i)),
+							std::next(names.cbegin(), ptrdiff_t(e)));
+						build(opth / uname, opth / (uname + ".o"));
+					}
+				}
+				++n_group;
+			}
 		}
+		else
+			for(const auto& pr : src_files)
+				build(ipth / pr.second, opth / (pr.second + ".o"));
 	}
 	return ofiles;
 }
@@ -670,7 +1694,33 @@ BuildContext::Build()
 	PrintInfo("Absolute path " + Quote(to_string(ipath).GetMBCS()) + " recognized.");
 	if(!VerifyDirectory(in))
 		raise_exception(1, "SRCPATH is not existed.");
+	if(!TraceFile.empty())
+		p_trace.reset(new BuildTrace());
+
+	const auto gd(ystdex::make_guard([this]() ynothrow{
+		if(p_trace)
+			FilterExceptions([this]{
+				p_trace->PrintSummary(jobs.get_max_task_num());
+				p_trace->Write(TraceFile);
+			}, "writing build trace");
+	}));
+
 	EnsureOutputDirectory(OutputDir);
+	if(!GetEnv("SHBuild_ObjectCacheDir").empty())
+	{
+		const auto& dir(GetEnv("SHBuild_ObjectCacheDir"));
+		std::uint64_t size(0);
+
+		TryExpr(size = ystdex::ston<std::uint64_t>(
+			GetEnv("SHBuild_ObjectCacheSize")))
+		CatchExpr(std::exception&, PrintInfo("Invalid object cache size "
+			+ Quote(GetEnv("SHBuild_ObjectCacheSize")) + " ignored.", Warning))
+		PrintInfo("Object cache directory: " + Quote(dir) + '.');
+		TryExpr(p_cache.reset(new ObjectCache(dir, size == 0
+			? std::uint64_t(1) << 30 : size)))
+		CatchExpr(std::system_error&, PrintInfo("Failed creating object cache"
+			" directory " + Quote(dir) + ", the cache is disabled.", Warning))
+	}
 	std::for_each(next(Options.begin()), Options.end(), [&](const string& opt){
 		flags += ' ' + opt;
 	});
@@ -699,10 +1749,21 @@ BuildContext::Build()
 		// TODO: Optimize for job dependency.
 		if(jobs.get_max_task_num() > 1)
 		{
+			const auto wait_start(steady_clock::now());
+
 			print("Wait for unfinished tasks before linking ...", Notice);
 			jobs.reset();
+			if(p_trace)
+				p_trace->Record("wait", "unfinished tasks", wait_start);
 		}
 		CheckResult(GetLastResult());
+		if(p_cache)
+		{
+			p_cache->PrintStatistics();
+			FilterExceptions([this]{
+				p_cache->Evict();
+			}, "evicting object cache entries");
+		}
 
 		const auto onum(ofiles.size());
 
@@ -755,7 +1816,8 @@ BuildContext::Build()
 							Warning);
 					PrintInfo("Deleted file " + Quote(target) + '.', Debug);
 				}
-				CallWithException(str, 1);
+				CallWithException(str, Traced("link", target,
+					std::bind(RunCommand, str)), 1);
 			}
 		}
 		else
@@ -785,16 +1847,16 @@ BuildContext::Build()
 }
 
 int
-BuildContext::Call(const string& cmd, size_t n) const
+BuildContext::Call(const string& cmd, std::function<int()> f, size_t n) const
 {
 	if(n == 0)
 		n = jobs.get_max_task_num();
 	PrintInfo(n <= 1 ? cmd : "Task enqueued.", Debug, LogGroup::Command);
-	return n <= 1 ? usystem(cmd.c_str()) : RunTask(cmd);
+	return n <= 1 ? f() : RunTask(cmd, std::move(f));
 }
 
 int
-BuildContext::RunTask(const string& cmd) const
+BuildContext::RunTask(const string& cmd, std::function<int()> f) const
 {
 	{
 		std::lock_guard<std::mutex> lck(job_mtx);
@@ -806,9 +1868,9 @@ BuildContext::RunTask(const string& cmd) const
 	// TODO: Blocked. Use ISO C++14 lambda initializers to simplify
 	//	implementation and optimize copy of %cmd.
 	// TODO: Reduce memory footprint.
-	futures.push_back(jobs.wait([&, cmd]{
+	futures.push_back(jobs.wait([&, cmd, f]{
 		PrintInfo(cmd, Debug, LogGroup::Command);
-		const int res(usystem(cmd.c_str()));
+		const int res(f());
 		{
 			std::lock_guard<std::mutex> lck(job_mtx);
 
@@ -960,7 +2022,10 @@ main(int argc, char* argv[])
 				if(!OutputDir.empty())
 					ctx.OutputDir = std::move(OutputDir);
 				yunseq(ctx.IgnoredDirs = std::move(IgnoredDirs),
-					ctx.Options = std::move(args), ctx.Mode = Mode);
+					ctx.Options = std::move(args), ctx.Mode = Mode,
+					ctx.UnityBatchSize = UnityBatchSize,
+					ctx.UnityExcludedFiles = std::move(UnityExcludedFiles),
+					ctx.TraceFile = std::move(TraceFile));
 				if(!TargetName.empty())
 					ctx.TargetName = std::move(TargetName);
 				PrintInfo("OutputDir = " + ctx.OutputDir);
@@ -63,6 +63,17 @@ export SHBuild_Debug
 export SHBuild_Static
 
 SHBuild_Dest="$SHBuild_BuildPrefix.$SHBuild_Conf"
+# NOTE: The command cache is kept in the YSLib build directory if it is known,
+#	otherwise it is not persistent unless specified by the caller. No
+#	directory is created in the source tree.
+if [[ "$SHBuild_CommandCacheDir" == '' && "$YSLib_BuildDir" != '' ]]; then
+	SHBuild_CommandCacheDir="$YSLib_BuildDir/.command-cache"
+fi
+if [[ "$SHBuild_CommandCacheDir" != '' ]]; then
+	mkdir -p "$SHBuild_CommandCacheDir" 2> /dev/null \
+		|| SHBuild_CommandCacheDir=''
+fi
+export SHBuild_CommandCacheDir
 SHBOPT="-xd,$SHBuild_Dest -xid,include -xmode,2 $@"
 . $SHBuild_Bin/SHBuild-common.sh
 if hash gcc-ar > /dev/null; then
@@ -105,9 +116,11 @@ if [[ "$SHBuild_Env_OS" == 'Win32' ]]; then
 else
 	: ${SHBuild_YSLib_Platform:=$SHBuild_Env_OS}
 	SHBuild_YF_SystemLibs='-Wl,-dy -lxcb -lpthread'
-	SHBuild_YF_CFlags_freetype="`pkg-config --cflags freetype2 2> /dev/null`"
+	SHBuild_YF_CFlags_freetype="`SHBuild_GetCached \
+		'pkg-config --cflags freetype2 2> /dev/null'`"
 	: ${SHBuild_YF_CFlags_freetype:='-I/usr/include'}
-	SHBuild_YF_Libs_freetype="`pkg-config --libs freetype2 2> /dev/null`"
+	SHBuild_YF_Libs_freetype="`SHBuild_GetCached \
+		'pkg-config --libs freetype2 2> /dev/null'`"
 	: ${SHBuild_YF_Libs_freetype:='-lfreetype'}
 	SHBuild_YF_Libs_freetype="-Wl,-dy $SHBuild_YF_Libs_freetype"
 fi
@@ -128,6 +128,17 @@ SHBuild_2w()
 	cygpath -w "$1" 2> /dev/null || SHBuild_Put "$1"
 }
 
+# Runs the command line "$1" and outputs its result. The result is cached by
+#	"$SHBuild" in directory specified by %SHBuild_CommandCacheDir if it is not
+#	empty. The command is run directly when "$SHBuild" is not usable.
+SHBuild_GetCached()
+{
+	"$SHBuild" -xlogfl,0 -xcmd,RunNPL '$let ((res system-get-cached
+		(first (rest (() cmd-get-args))))) $if (eqv? (first (rest res)) 0)
+		(puts (first res)) (SHBuild_RaiseError_ "")' "$1" 2> /dev/null \
+		|| sh -c "$1"
+}
+
 SHBuild_Install()
 {
 	hash rsync > /dev/null 2>& 1 && rsync -a "$1" "$2" || cp -fr "$1" "$2"
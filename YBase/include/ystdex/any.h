@@ -11,13 +11,13 @@
 /*!	\file any.h
 \ingroup YStandardEx
 \brief 动态泛型类型。
-\version r3072
+\version r3200
 \author FrankHB <frankhb1989@gmail.com>
 \since build 247
 \par 创建时间:
 	2011-09-26 07:55:44 +0800
 \par 修改时间:
-	2017-06-08 16:46 +0800
+	2017-07-23 16:12 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -237,25 +237,46 @@ enum base_op : op_code
 	get_holder_type,
 	//! \note 要求已构造对象类型 holder* 。
 	get_holder_ptr,
+	/*!
+	\note 要求无构造目标对象；转移后销毁源对象。
+	\since build 802
+	*/
+	transfer,
 	//! \since build 355
 	end_base_op
 };
 
 
+/*!
+\brief 动态泛型对象的内部存储。
+\note 大小不小于 sizeof(void*) ，对齐不小于 yalignof(void*) ，以保存操作的结果。
+\since build 802
+*/
+template<size_t _vSize = sizeof(void*), size_t _vAlign = yalignof(void*)>
+using basic_any_storage
+	= standard_layout_storage<aligned_storage_t<_vSize, _vAlign>>;
+
 //! \since build 352
-using any_storage = standard_layout_storage<aligned_storage_t<sizeof(void*),
-	yalignof(void*)>>;
+using any_storage = basic_any_storage<>;
+
+//! \since build 802
+template<class _tStorage>
+using basic_any_manager = void(*)(_tStorage&, _tStorage&, op_code);
+
 //! \since build 352
-using any_manager = void(*)(any_storage&, any_storage&, op_code);
+using any_manager = basic_any_manager<any_storage>;
 
 /*!
 \brief 使用指定处理器初始化存储。
 \since build 687
 */
-template<class _tHandler, typename... _tParams>
-any_manager
-construct(any_storage& storage, _tParams&&... args)
+template<class _tHandler, class _tStorage, typename... _tParams>
+basic_any_manager<_tStorage>
+construct(_tStorage& storage, _tParams&&... args)
 {
+	static_assert(is_same<typename _tHandler::storage_type, _tStorage>(),
+		"Mismatched storage type of handler found.");
+
 	_tHandler::init(storage, yforward(args)...);
 	return _tHandler::manage;
 }
@@ -272,9 +293,9 @@ yconstexpr const struct use_holder_t{} use_holder{};
 \brief 动态泛型对象处理器。
 \since build 671
 */
-template<typename _type,
+template<typename _type, class _tStorage = any_storage,
 	bool _bStoredLocally = and_<is_nothrow_move_constructible<_type>,
-	is_aligned_storable<any_storage, _type>>::value>
+	is_aligned_storable<_tStorage, _type>>::value>
 class value_handler
 {
 public:
@@ -283,45 +304,73 @@ public:
 	using value_type = _type;
 	using local_storage = bool_<_bStoredLocally>;
 	//@}
+	//! \since build 802
+	using storage_type = _tStorage;
 
 	//! \since build 595
 	//@{
 	static void
-	copy(any_storage& d, const any_storage& s)
+	copy(storage_type& d, const storage_type& s)
 	{
 		try_init(is_copy_constructible<value_type>(), local_storage(), d,
 			get_reference(s));
 	}
 
 	static void
-	dispose(any_storage& d) ynothrowv
+	dispose(storage_type& d) ynothrowv
 	{
 		dispose_impl(local_storage(), d);
 	}
 
+	/*!
+	\brief 转移第二参数中的对象至第一参数中，并销毁第二参数中的对象。
+	\since build 802
+	*/
+	static void
+	relocate(storage_type& d, storage_type& s) ynothrow
+	{
+		relocate_impl(local_storage(), d, s);
+	}
+
 private:
 	static void
-	dispose_impl(false_, any_storage& d) ynothrowv
+	dispose_impl(false_, storage_type& d) ynothrowv
+	{
+		delete d.template access<value_type*>();
+	}
+	static void
+	dispose_impl(true_, storage_type& d) ynothrowv
 	{
-		delete d.access<value_type*>();
+		d.template destroy<value_type>();
 	}
+
+	//! \since build 802
+	//@{
 	static void
-	dispose_impl(true_, any_storage& d) ynothrowv
+	relocate_impl(false_, storage_type& d, storage_type& s) ynothrow
 	{
-		d.destroy<value_type>();
+		d.template construct<value_type*>(s.template access<value_type*>());
 	}
+	static void
+	relocate_impl(true_, storage_type& d, storage_type& s) ynothrow
+	{
+		d.template construct<value_type>(
+			std::move(s.template access<value_type>()));
+		s.template destroy<value_type>();
+	}
+	//@}
 	//@}
 
 public:
 	//! \since build 692
 	//@{
 	static value_type*
-	get_pointer(any_storage& s)
+	get_pointer(storage_type& s)
 	{
 		return get_pointer_impl(local_storage(), s);
 	}
 	static const value_type*
-	get_pointer(const any_storage& s)
+	get_pointer(const storage_type& s)
 	{
 		return get_pointer_impl(local_storage(), s);
 	}
@@ -330,22 +379,22 @@ private:
 	//! \since build 729
 	//@{
 	static value_type*
-	get_pointer_impl(false_, any_storage& s)
+	get_pointer_impl(false_, storage_type& s)
 	{
-		return s.access<value_type*>();
+		return s.template access<value_type*>();
 	}
 	static const value_type*
-	get_pointer_impl(false_, const any_storage& s)
+	get_pointer_impl(false_, const storage_type& s)
 	{
-		return s.access<const value_type*>();
+		return s.template access<const value_type*>();
 	}
 	static value_type*
-	get_pointer_impl(true_, any_storage& s)
+	get_pointer_impl(true_, storage_type& s)
 	{
 		return std::addressof(get_reference_impl(true_(), s));
 	}
 	static const value_type*
-	get_pointer_impl(true_, const any_storage& s)
+	get_pointer_impl(true_, const storage_type& s)
 	{
 		return std::addressof(get_reference_impl(true_(), s));
 	}
@@ -353,12 +402,12 @@ private:
 
 public:
 	static value_type&
-	get_reference(any_storage& s)
+	get_reference(storage_type& s)
 	{
 		return get_reference_impl(local_storage(), s);
 	}
 	static const value_type&
-	get_reference(const any_storage& s)
+	get_reference(const storage_type& s)
 	{
 		return get_reference_impl(local_storage(), s);
 	}
@@ -367,7 +416,7 @@ private:
 	//! \since build 729
 	//@{
 	static value_type&
-	get_reference_impl(false_, any_storage& s)
+	get_reference_impl(false_, storage_type& s)
 	{
 		const auto p(get_pointer_impl(false_(), s));
 
@@ -375,7 +424,7 @@ private:
 		return *p;
 	}
 	static const value_type&
-	get_reference_impl(false_, const any_storage& s)
+	get_reference_impl(false_, const storage_type& s)
 	{
 		const auto p(get_pointer_impl(false_(), s));
 
@@ -383,14 +432,14 @@ private:
 		return *p;
 	}
 	static value_type&
-	get_reference_impl(true_, any_storage& s)
+	get_reference_impl(true_, storage_type& s)
 	{
-		return s.access<value_type>();
+		return s.template access<value_type>();
 	}
 	static const value_type&
-	get_reference_impl(true_, const any_storage& s)
+	get_reference_impl(true_, const storage_type& s)
 	{
-		return s.access<const value_type>();
+		return s.template access<const value_type>();
 	}
 	//@}
 	//@}
@@ -399,7 +448,7 @@ public:
 	//! \since build 595
 	template<typename... _tParams>
 	static void
-	init(any_storage& d, _tParams&&... args)
+	init(storage_type& d, _tParams&&... args)
 	{
 		init_impl(local_storage(), d, yforward(args)...);
 	}
@@ -408,22 +457,22 @@ private:
 	//! \since build 729
 	template<typename... _tParams>
 	static YB_ATTR(always_inline) void
-	init_impl(false_, any_storage& d, _tParams&&... args)
+	init_impl(false_, storage_type& d, _tParams&&... args)
 	{
-		d.construct<value_type*>(new value_type(yforward(args)...));
+		d.template construct<value_type*>(new value_type(yforward(args)...));
 	}
 	//! \since build 729
 	template<typename... _tParams>
 	static YB_ATTR(always_inline) void
-	init_impl(true_, any_storage& d, _tParams&&... args)
+	init_impl(true_, storage_type& d, _tParams&&... args)
 	{
-		d.construct<value_type>(yforward(args)...);
+		d.template construct<value_type>(yforward(args)...);
 	}
 
 public:
 	//! \since build 692
 	static void
-	manage(any_storage& d, any_storage& s, op_code op)
+	manage(storage_type& d, storage_type& s, op_code op)
 	{
 		switch(op)
 		{
@@ -444,6 +493,9 @@ public:
 			break;
 		case get_holder_ptr:
 			d = static_cast<holder*>(nullptr);
+			break;
+		case transfer:
+			relocate(d, s);
 		}
 	}
 
@@ -458,7 +510,7 @@ private:
 	//! \since build 729
 	template<class _bInPlace, typename... _tParams>
 	static YB_ATTR(always_inline) void
-	try_init(true_, _bInPlace b, any_storage& d, _tParams&&... args)
+	try_init(true_, _bInPlace b, storage_type& d, _tParams&&... args)
 	{
 		init_impl(b, d, yforward(args)...);
 	}
@@ -469,23 +521,25 @@ private:
 \brief 动态泛型引用处理器。
 \since build 352
 */
-template<typename _type>
-class ref_handler : public value_handler<_type*>
+template<typename _type, class _tStorage = any_storage>
+class ref_handler : public value_handler<_type*, _tStorage>
 {
 public:
 	using value_type = _type;
-	using base = value_handler<value_type*>;
+	using base = value_handler<value_type*, _tStorage>;
+	//! \since build 802
+	using storage_type = _tStorage;
 
 	//! \since build 692
 	static value_type*
-	get_pointer(any_storage& s)
+	get_pointer(storage_type& s)
 	{
 		return base::get_reference(s);
 	}
 
 	//! \since build 692
 	static value_type&
-	get_reference(any_storage& s)
+	get_reference(storage_type& s)
 	{
 		yassume(get_pointer(s));
 		return *get_pointer(s);
@@ -495,7 +549,7 @@ public:
 	template<typename _tWrapper,
 		yimpl(typename = enable_if_t<is_reference_wrapper<_tWrapper>::value>)>
 	static auto
-	init(any_storage& d, _tWrapper x)
+	init(storage_type& d, _tWrapper x)
 		-> decltype(base::init(d, std::addressof(x.get())))
 	{
 		base::init(d, std::addressof(x.get()));
@@ -503,7 +557,7 @@ public:
 
 	//! \since build 692
 	static void
-	manage(any_storage& d, any_storage& s, op_code op)
+	manage(storage_type& d, storage_type& s, op_code op)
 	{
 		switch(op)
 		{
@@ -524,18 +578,20 @@ public:
 \brief 动态泛型持有者处理器。
 \since build 352
 */
-template<typename _tHolder>
-class holder_handler : public value_handler<_tHolder>
+template<typename _tHolder, class _tStorage = any_storage>
+class holder_handler : public value_handler<_tHolder, _tStorage>
 {
 	static_assert(is_convertible<_tHolder&, holder&>(),
 		"Invalid holder type found.");
 
 public:
-	using base = value_handler<_tHolder>;
+	using base = value_handler<_tHolder, _tStorage>;
+	//! \since build 802
+	using storage_type = _tStorage;
 
 	//! \since build 595
 	static _tHolder*
-	get_holder_pointer(any_storage& s)
+	get_holder_pointer(storage_type& s)
 	{
 		return base::get_pointer(s);
 	}
@@ -543,21 +599,21 @@ public:
 private:
 	//! \since build 729
 	static void
-	init(false_, any_storage& d, std::unique_ptr<_tHolder> p)
+	init(false_, storage_type& d, std::unique_ptr<_tHolder> p)
 	{
-		d.construct<_tHolder*>(p.release());
+		d.template construct<_tHolder*>(p.release());
 	}
 	//! \since build 729
 	static void
-	init(true_, any_storage& d, std::unique_ptr<_tHolder> p)
+	init(true_, storage_type& d, std::unique_ptr<_tHolder> p)
 	{
-		d.construct<_tHolder>(std::move(*p));
+		d.template construct<_tHolder>(std::move(*p));
 	}
 
 public:
 	//! \since build 395
 	static void
-	init(any_storage& d, std::unique_ptr<_tHolder> p)
+	init(storage_type& d, std::unique_ptr<_tHolder> p)
 	{
 		init(typename base::local_storage(), d, std::move(p));
 	}
@@ -566,7 +622,7 @@ public:
 
 	//! \since build 692
 	static void
-	manage(any_storage& d, any_storage& s, op_code op)
+	manage(storage_type& d, storage_type& s, op_code op)
 	{
 		switch(op)
 		{
@@ -594,12 +650,12 @@ public:
 \brief 根据类型选择引用或值处理器。
 \since build 355
 */
-template<typename _type>
+template<typename _type, class _tStorage = any_storage>
 struct wrap_handler
 {
 	using value_type = remove_reference_t<unwrap_reference_t<_type>>;
-	using type = cond_t<is_reference_wrapper<_type>, ref_handler<value_type>,
-		value_handler<value_type>>;
+	using type = cond_t<is_reference_wrapper<_type>,
+		ref_handler<value_type, _tStorage>, value_handler<value_type, _tStorage>>;
 };
 
 } // namespace any_ops;
@@ -684,11 +740,16 @@ public:
 namespace details
 {
 
+//! \since build 802
+template<class _tStorage>
 struct any_base
 {
+	using storage_type = _tStorage;
+	using manager_type = any_ops::basic_any_manager<storage_type>;
+
 	//! \since build 692
-	mutable any_ops::any_storage storage{};
-	any_ops::any_manager manager{};
+	mutable storage_type storage{};
+	manager_type manager{};
 
 	any_base() = default;
 	template<class _tHandler, typename... _tParams>
@@ -706,17 +767,37 @@ protected:
 	~any_base() = default;
 
 public:
-	YB_API any_ops::any_storage&
-	call(any_ops::any_storage&, any_ops::op_code) const;
+	storage_type&
+	call(storage_type& t, any_ops::op_code op) const
+	{
+		yconstraint(manager);
 
-	YB_API void
-	clear() ynothrowv;
+		manager(t, storage, op);
+		return t;
+	}
+
+	void
+	clear() ynothrowv
+	{
+		destroy();
+		manager = {};
+	}
 
 	void
-	copy(const any_base&);
+	copy(const any_base& a)
+	{
+		yconstraint(manager);
+
+		manager(storage, a.storage, any_ops::clone);
+	}
 
 	void
-	destroy() ynothrowv;
+	destroy() ynothrowv
+	{
+		yconstraint(manager);
+
+		manager(storage, storage, any_ops::destroy);
+	}
 
 	//! \since build 717
 	bool
@@ -727,21 +808,46 @@ public:
 
 	//! \pre 断言：\c manager 。
 	//@{
-	YB_API void*
-	get() const ynothrowv;
+	void*
+	get() const ynothrowv
+	{
+		return unchecked_access<void*>(default_init, any_ops::get_ptr);
+	}
 
-	YB_API any_ops::holder*
-	get_holder() const;
+	any_ops::holder*
+	get_holder() const
+	{
+		return unchecked_access<any_ops::holder*>(default_init,
+			any_ops::get_holder_ptr);
+	}
 
 	//! \since build 692
-	any_ops::any_storage&
+	storage_type&
 	get_storage() const
 	{
 		return storage;
 	}
 
-	YB_API void
-	swap(any_base&) ynothrow;
+	/*!
+	\note 使用处理器转移存储的对象，不按字节交换存储。
+	\since build 802
+	*/
+	void
+	swap(any_base& a) ynothrow
+	{
+		if(&a != this && (manager || a.manager))
+		{
+			storage_type t;
+
+			if(manager)
+				manager(t, storage, any_ops::transfer);
+			if(a.manager)
+				a.manager(storage, a.storage, any_ops::transfer);
+			if(manager)
+				manager(a.storage, t, any_ops::transfer);
+			std::swap(manager, a.manager);
+		}
+	}
 
 	template<typename _type>
 	_type*
@@ -758,16 +864,20 @@ public:
 			? static_cast<const _type*>(get()) : nullptr;
 	}
 
-	YB_API const type_info&
-	type() const ynothrowv;
+	const type_info&
+	type() const ynothrowv
+	{
+		return
+			*unchecked_access<const type_info*>(default_init, any_ops::get_type);
+	}
 
 	//! \since build 717
 	template<typename _type, typename... _tParams>
 	inline _type
 	unchecked_access(any_ops::op_code op, _tParams&&... args) const
 	{
-		any_ops::any_storage t;
-		const auto gd(t.pun<_type>(yforward(args)...));
+		storage_type t;
+		const auto gd(t.template pun<_type>(yforward(args)...));
 
 		return unchecked_access<_type>(t, op);
 	}
@@ -776,46 +886,46 @@ public:
 	inline _type
 	unchecked_access(default_init_t, any_ops::op_code op) const
 	{
-		any_ops::any_storage t;
-		const auto gd(t.pun_default<_type>());
+		storage_type t;
+		const auto gd(t.template pun_default<_type>());
 
 		return unchecked_access<_type>(t, op);
 	}
 	//! \since build 686
 	template<typename _type>
 	inline _type
-	unchecked_access(any_ops::any_storage& t, any_ops::op_code op) const
+	unchecked_access(storage_type& t, any_ops::op_code op) const
 	{
-		return call(t, op).access<_type>();
+		return call(t, op).template access<_type>();
 	}
 	//@}
 };
 
 
-template<class _tAny>
+template<class _tAny, class _tStorage>
 struct any_emplace
 {
 	template<typename _type, typename... _tParams>
 	void
 	emplace(_tParams&&... args)
 	{
-		emplace_with_handler<any_ops::value_handler<decay_t<_type>>>(
-			yforward(args)...);
+		emplace_with_handler<any_ops::value_handler<decay_t<_type>,
+			_tStorage>>(yforward(args)...);
 	}
 	//! \since build 717
 	template<typename _type, typename _tOther, typename... _tParams>
 	void
 	emplace(std::initializer_list<_tOther> il, _tParams&&... args)
 	{
-		emplace_with_handler<any_ops::value_handler<decay_t<_type>>>(
-			il, yforward(args)...);
+		emplace_with_handler<any_ops::value_handler<decay_t<_type>,
+			_tStorage>>(il, yforward(args)...);
 	}
 	template<typename _tHolder, typename... _tParams>
 	void
 	emplace(any_ops::use_holder_t, _tParams&&... args)
 	{
-		emplace_with_handler<any_ops::holder_handler<decay_t<_tHolder>>>(
-			yforward(args)...);
+		emplace_with_handler<any_ops::holder_handler<decay_t<_tHolder>,
+			_tStorage>>(yforward(args)...);
 	}
 
 	template<typename _tHandler, typename... _tParams>
@@ -840,36 +950,50 @@ struct any_emplace
 \warning 非虚析构。
 \see WG21 N4606 20.8.3[any.class] 。
 \see http://www.boost.org/doc/libs/1_53_0/doc/html/any/reference.html#any.ValueType 。
-\since build 331
+\since build 802
+
+满足内部存储的大小和对齐要求且转移构造不抛出异常的对象直接保存在内部存储中，
+否则动态分配。内部存储类型参数为 YStandardEx 扩展。
 */
-class YB_API any : private details::any_base, private details::any_emplace<any>
+template<class _tStorage = any_ops::any_storage>
+class basic_any : private details::any_base<_tStorage>,
+	private details::any_emplace<basic_any<_tStorage>, _tStorage>
 {
 	//! \since build 737
-	friend details::any_emplace<any>;
+	friend details::any_emplace<basic_any, _tStorage>;
+
+private:
+	using any_base = details::any_base<_tStorage>;
+	using any_emplace = details::any_emplace<basic_any, _tStorage>;
+
+	using any_base::manager;
 
 public:
+	using storage_type = _tStorage;
+
 	//! \post \c !has_value() 。
 	yconstfn
-	any() ynothrow = default;
+	basic_any() ynothrow = default;
 	/*!
 	\note 引用包装类型的处理为 YStandardEx 扩展，此时不具有所有权。
 	\warning 引用包装存储无视 cv 修饰符。访问不检查动态类型，应注意避免未定义行为。
 	\since build 448
 	*/
-	template<typename _type, yimpl(typename = exclude_self_t<any, _type>)>
+	template<typename _type,
+		yimpl(typename = exclude_self_t<basic_any, _type>)>
 	inline
-	any(_type&& x)
-		: any(any_ops::with_handler_t<
-		_t<any_ops::wrap_handler<decay_t<_type>>>>(), yforward(x))
+	basic_any(_type&& x)
+		: basic_any(any_ops::with_handler_t<
+		_t<any_ops::wrap_handler<decay_t<_type>, _tStorage>>>(), yforward(x))
 	{}
 	//! \note YStandardEx 扩展。
 	//@{
 	//! \since build 717
 	template<typename _type, typename... _tParams>
 	inline
-	any(in_place_type_t<_type>, _tParams&&... args)
-		: any(any_ops::with_handler_t<any_ops::value_handler<_type>>(),
-		yforward(args)...)
+	basic_any(in_place_type_t<_type>, _tParams&&... args)
+		: basic_any(any_ops::with_handler_t<
+		any_ops::value_handler<_type, _tStorage>>(), yforward(args)...)
 	{}
 	/*!
 	\brief 构造：使用指定持有者。
@@ -878,72 +1002,83 @@ public:
 	//@{
 	template<typename _tHolder>
 	inline
-	any(any_ops::use_holder_t, std::unique_ptr<_tHolder> p)
-		: any(any_ops::with_handler_t<any_ops::holder_handler<_tHolder>>(),
-		std::move(p))
+	basic_any(any_ops::use_holder_t, std::unique_ptr<_tHolder> p)
+		: basic_any(any_ops::with_handler_t<
+		any_ops::holder_handler<_tHolder, _tStorage>>(), std::move(p))
 	{}
 	template<typename _tHolder>
 	inline
-	any(any_ops::use_holder_t, _tHolder&& h)
-		: any(any_ops::with_handler_t<
-		any_ops::holder_handler<decay_t<_tHolder>>>(), yforward(h))
+	basic_any(any_ops::use_holder_t, _tHolder&& h)
+		: basic_any(any_ops::with_handler_t<
+		any_ops::holder_handler<decay_t<_tHolder>, _tStorage>>(), yforward(h))
 	{}
 	//! \since build 717
 	template<typename _tHolder, typename... _tParams>
 	inline
-	any(any_ops::use_holder_t, in_place_type_t<_tHolder>, _tParams&&... args)
-		: any(any_ops::with_handler_t<any_ops::holder_handler<_tHolder>>(),
-		yforward(args)...)
+	basic_any(any_ops::use_holder_t, in_place_type_t<_tHolder>,
+		_tParams&&... args)
+		: basic_any(any_ops::with_handler_t<
+		any_ops::holder_handler<_tHolder, _tStorage>>(), yforward(args)...)
 	{}
 	//@}
 	template<typename _type>
 	inline
-	any(_type&& x, any_ops::use_holder_t)
-		: any(any_ops::with_handler_t<any_ops::holder_handler<
-		any_ops::value_holder<decay_t<_type>>>>(), yforward(x))
+	basic_any(_type&& x, any_ops::use_holder_t)
+		: basic_any(any_ops::with_handler_t<any_ops::holder_handler<
+		any_ops::value_holder<decay_t<_type>>, _tStorage>>(), yforward(x))
 	{}
 	//! \since build 687
 	template<class _tHandler, typename... _tParams>
 	inline
-	any(any_ops::with_handler_t<_tHandler> t, _tParams&&... args)
+	basic_any(any_ops::with_handler_t<_tHandler> t, _tParams&&... args)
 		: any_base(t, yforward(args)...)
 	{}
 	//@}
-	any(const any&);
-	any(any&& a) ynothrow
-		: any()
+	basic_any(const basic_any& a)
+		: any_base(a)
+	{
+		if(manager)
+			any_base::copy(a);
+	}
+	basic_any(basic_any&& a) ynothrow
+		: basic_any()
 	{
 		a.swap(*this);
 	}
 	//! \since build 382
-	~any();
+	~basic_any()
+	{
+		if(manager)
+			any_base::destroy();
+	}
 
 	//! \since build 687
-	template<typename _type, yimpl(typename = exclude_self_t<any, _type>)>
-	any&
+	template<typename _type,
+		yimpl(typename = exclude_self_t<basic_any, _type>)>
+	basic_any&
 	operator=(_type&& x)
 	{
-		any(yforward(x)).swap(*this);
+		basic_any(yforward(x)).swap(*this);
 		return *this;
 	}
 	/*!
 	\brief 复制赋值：使用复制和交换。
 	\since build 332
 	*/
-	any&
-	operator=(const any& a)
+	basic_any&
+	operator=(const basic_any& a)
 	{
-		any(a).swap(*this);
+		basic_any(a).swap(*this);
 		return *this;
 	}
 	/*!
 	\brief 转移赋值：使用复制和交换。
 	\since build 332
 	*/
-	any&
-	operator=(any&& a) ynothrow
+	basic_any&
+	operator=(basic_any&& a) ynothrow
 	{
-		any(std::move(a)).swap(*this);
+		basic_any(std::move(a)).swap(*this);
 		return *this;
 	}
 
@@ -980,20 +1115,24 @@ protected:
 public:
 	//! \since build 717
 	void
-	reset() ynothrow;
+	reset() ynothrow
+	{
+		if(manager)
+			any_base::clear();
+	}
 
 	/*!
 	\note YStandardEx 扩展。
 	\since build 687
 	*/
 	//@{
-	using any_emplace<any>::emplace;
+	using any_emplace::emplace;
 
-	using any_emplace<any>::emplace_with_handler;
+	using any_emplace::emplace_with_handler;
 	//@}
 
 	void
-	swap(any& a) ynothrow
+	swap(basic_any& a) ynothrow
 	{
 		any_base::swap(a);
 	}
@@ -1063,7 +1202,13 @@ public:
 	//@}
 };
 
-//! \relates any
+/*!
+\brief 使用默认内部存储的动态泛型对象。
+\since build 331
+*/
+using any = basic_any<>;
+
+//! \relates basic_any
 //@{
 //! \see WG21 N4606 20.8.4[any.nonmembers] 。
 //@{
@@ -1071,8 +1216,9 @@ public:
 \brief 交换对象。
 \since build 398
 */
+template<class _tStorage>
 inline void
-swap(any& x, any& y) ynothrow
+swap(basic_any<_tStorage>& x, basic_any<_tStorage>& y) ynothrow
 {
 	x.swap(y);
 }
@@ -1109,17 +1255,17 @@ make_any(std::initializer_list<_tOther> il, _tParams&&... args)
 */
 //@{
 //@{
-template<typename _type>
+template<typename _type, class _tStorage>
 inline _type*
-any_cast(any* p) ynothrow
+any_cast(basic_any<_tStorage>* p) ynothrow
 {
-	return p ? p->target<_type>() : nullptr;
+	return p ? p->template target<_type>() : nullptr;
 }
-template<typename _type>
+template<typename _type, class _tStorage>
 inline const _type*
-any_cast(const any* p) ynothrow
+any_cast(const basic_any<_tStorage>* p) ynothrow
 {
-	return p ? p->target<_type>() : nullptr;
+	return p ? p->template target<_type>() : nullptr;
 }
 //@}
 /*!
@@ -1127,9 +1273,9 @@ any_cast(const any* p) ynothrow
 	!= ystdex::type_id<remove_reference_t<_tValue>>()</tt> 。
 */
 //@{
-template<typename _tValue>
+template<typename _tValue, class _tStorage>
 _tValue
-any_cast(any& x)
+any_cast(basic_any<_tStorage>& x)
 {
 	static_assert(is_any_cast_dest<_tValue>(),
 		"Invalid cast destination type found.");
@@ -1138,9 +1284,9 @@ any_cast(any& x)
 		return static_cast<_tValue>(*p);
 	throw bad_any_cast(x.type(), ystdex::type_id<_tValue>());
 }
-template<typename _tValue>
+template<typename _tValue, class _tStorage>
 _tValue
-any_cast(const any& x)
+any_cast(const basic_any<_tStorage>& x)
 {
 	static_assert(is_any_cast_dest<_tValue>(),
 		"Invalid cast destination type found.");
@@ -1150,9 +1296,9 @@ any_cast(const any& x)
 	throw bad_any_cast(x.type(), ystdex::type_id<_tValue>());
 }
 //! \since build 671
-template<typename _tValue>
+template<typename _tValue, class _tStorage>
 _tValue
-any_cast(any&& x)
+any_cast(basic_any<_tStorage>&& x)
 {
 	static_assert(is_any_cast_dest<_tValue>(),
 		"Invalid cast destination type found.");
@@ -1171,8 +1317,9 @@ any_cast(any&& x)
 \brief 判断是否持有相同对象。
 \since build 748
 */
+template<class _tStorage>
 inline bool
-hold_same(const any& x, const any& y)
+hold_same(const basic_any<_tStorage>& x, const basic_any<_tStorage>& y)
 {
 	return x.get() == y.get();
 }
@@ -1186,9 +1333,9 @@ hold_same(const any& x, const any& y)
 \pre 断言： <tt>p && p->has_value()
 	&& p->unchecked_type() == ystdex::type_id<_type>()</tt> 。
 */
-template<typename _type>
+template<typename _type, class _tStorage>
 inline _type*
-unchecked_any_cast(any* p) ynothrowv
+unchecked_any_cast(basic_any<_tStorage>* p) ynothrowv
 {
 	yconstraint(p && p->has_value()
 		&& p->unchecked_type() == ystdex::type_id<_type>());
@@ -1199,9 +1346,9 @@ unchecked_any_cast(any* p) ynothrowv
 \pre 断言： <tt>p && p->has_value()
 	&& p->unchecked_type() == ystdex::type_id<const _type>()</tt> 。
 */
-template<typename _type>
+template<typename _type, class _tStorage>
 inline const _type*
-unchecked_any_cast(const any* p) ynothrowv
+unchecked_any_cast(const basic_any<_tStorage>* p) ynothrowv
 {
 	yconstraint(p && p->has_value()
 		&& p->unchecked_type() == ystdex::type_id<const _type>());
@@ -1216,18 +1363,18 @@ unchecked_any_cast(const any* p) ynothrowv
 */
 //@{
 //! \pre 断言： <tt>p && p->type() == ystdex::type_id<_type>()</tt> 。
-template<typename _type>
+template<typename _type, class _tStorage>
 inline _type*
-unsafe_any_cast(any* p) ynothrowv
+unsafe_any_cast(basic_any<_tStorage>* p) ynothrowv
 {
 	yconstraint(p && p->type() == ystdex::type_id<_type>());
 	return static_cast<_type*>(p->get());
 }
 
 //! \pre 断言： <tt>p && p->type() == ystdex::type_id<const _type>()</tt> 。
-template<typename _type>
+template<typename _type, class _tStorage>
 inline const _type*
-unsafe_any_cast(const any* p) ynothrowv
+unsafe_any_cast(const basic_any<_tStorage>* p) ynothrowv
 {
 	yconstraint(p && p->type() == ystdex::type_id<const _type>());
 	return static_cast<const _type*>(p->get());
@@ -11,13 +11,13 @@
 /*!	\file memory.hpp
 \ingroup YStandardEx
 \brief 存储和智能指针特性。
-\version r2527
+\version r2528
 \author FrankHB <frankhb1989@gmail.com>
 \since build 209
 \par 创建时间:
 	2011-05-14 12:25:13 +0800
 \par 修改时间:
-	2017-04-29 10:05 +0800
+	2017-07-27 22:05 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -249,6 +249,161 @@ struct class_allocator : std::allocator<_type>
 template<typename _type>
 using local_allocator = cond_t<and_<has_mem_new<_type, size_t>,
 	has_mem_delete<_type*>>, class_allocator<_type>, std::allocator<_type>>;
+
+
+/*!
+\brief 线程局部的固定大小块池。
+\note 空闲块使用链表保存，块直接由 ::operator new 分配，可在线程间转移所有权。
+\note 实现支持 thread_local 时为每线程实例，否则为全局静态实例。
+\warning 对不支持 thread_local 的实现非线程安全。
+\sa YB_HAS_THREAD_LOCAL
+\since build 809
+
+保存至多 _vMaxFree 个空闲块以复用，超出时直接释放。线程退出后释放的块不再保存。
+*/
+template<size_t _vSize, size_t _vMaxFree = 4096>
+class block_pool
+{
+public:
+	//! \brief 块大小：至少可保存一个指针。
+	static yconstexpr const size_t block_size
+		= _vSize < sizeof(void*) ? sizeof(void*) : _vSize;
+
+private:
+	//! \note 平凡析构，以允许在 guard 析构后访问。
+	struct state
+	{
+		void* head;
+		size_t count;
+		bool closed;
+	};
+	struct guard
+	{
+		~guard()
+		{
+			auto& st(get_state());
+
+			st.closed = true;
+			while(st.head)
+			{
+				const auto p(st.head);
+
+				st.head = *static_cast<void**>(p);
+				::operator delete(p);
+			}
+			st.count = 0;
+		}
+	};
+
+	static state&
+	get_state() ynothrow
+	{
+#if YB_HAS_THREAD_LOCAL
+		thread_local state st;
+		thread_local guard gd;
+#else
+		static state st;
+		static guard gd;
+#endif
+
+		static_cast<void>(gd);
+		return st;
+	}
+
+public:
+	static void*
+	allocate()
+	{
+		auto& st(get_state());
+
+		if(const auto p = st.head)
+		{
+			st.head = *static_cast<void**>(p);
+			--st.count;
+			return p;
+		}
+		return ::operator new(block_size);
+	}
+
+	static void
+	deallocate(void* p) ynothrow
+	{
+		auto& st(get_state());
+
+		if(!st.closed && st.count < _vMaxFree)
+		{
+			*static_cast<void**>(p) = st.head;
+			st.head = p;
+			++st.count;
+		}
+		else
+			::operator delete(p);
+	}
+};
+
+template<size_t _vSize, size_t _vMaxFree>
+yconstexpr const size_t block_pool<_vSize, _vMaxFree>::block_size;
+
+
+/*!
+\brief 池分配器：单个对象使用线程局部的 block_pool 分配。
+\note 无状态且所有实例相等，因此容器间转移和交换不重新分配节点。
+\note 适合作为节点容器的分配器；分配多个对象时直接使用 ::operator new 。
+\note 允许使用不完整类型实例化。
+\since build 809
+*/
+template<typename _type>
+class pooled_allocator
+{
+public:
+	using value_type = _type;
+	using propagate_on_container_copy_assignment = true_;
+	using propagate_on_container_move_assignment = true_;
+	using propagate_on_container_swap = true_;
+	using is_always_equal = true_;
+
+	yconstfn
+	pooled_allocator() ynothrow = default;
+	template<typename _tOther>
+	yconstfn
+	pooled_allocator(const pooled_allocator<_tOther>&) ynothrow
+	{}
+
+	_type*
+	allocate(size_t n)
+	{
+		if(n == 1)
+			return static_cast<_type*>(block_pool<sizeof(_type)>::allocate());
+		if(n > size_t(-1) / sizeof(_type))
+			throw std::bad_alloc();
+		return static_cast<_type*>(::operator new(n * sizeof(_type)));
+	}
+
+	void
+	deallocate(_type* p, size_t n) ynothrow
+	{
+		if(n == 1)
+			block_pool<sizeof(_type)>::deallocate(p);
+		else
+			::operator delete(p);
+	}
+
+	template<typename _tOther>
+	friend yconstfn bool
+	operator==(const pooled_allocator&, const pooled_allocator<_tOther>&)
+		ynothrow
+	{
+		return true;
+	}
+
+	template<typename _tOther>
+	friend yconstfn bool
+	operator!=(const pooled_allocator&, const pooled_allocator<_tOther>&)
+		ynothrow
+	{
+		return {};
+	}
+};
 //@}
 //@}
 
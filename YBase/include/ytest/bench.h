@@ -0,0 +1,235 @@
+﻿/*
+	© 2017 FrankHB.
+
+	This file is part of the YSLib project, and may only be used,
+	modified, and distributed under the terms of the YSLib project
+	license, LICENSE.TXT.  By continuing to use, modify, or distribute
+	this file you indicate that you have read the license and
+	understand and accept it fully.
+*/
+
+/*!	\file bench.h
+\ingroup YTest
+\brief 统计基准测试工具。
+\version r1
+\author FrankHB <frankhb1989@gmail.com>
+\since build 818
+\par 创建时间:
+	2017-08-02 10:05:32 +0800
+\par 修改时间:
+	2017-08-02 10:05 +0800
+\par 文本编码:
+	UTF-8
+\par 模块名称:
+	YTest::Bench
+*/
+
+
+#ifndef YB_INC_ytest_bench_h_
+#define YB_INC_ytest_bench_h_ 1
+
+#include "timing.hpp" // for ytest::timing::once, ytest::size_t;
+#include <cstdint> // for std::uint64_t;
+#include <string>
+#include <vector>
+#include <functional>
+#include <iosfwd> // for std::ostream;
+
+namespace ytest
+{
+
+/*!
+\brief 基准测试命名空间。
+\since build 818
+*/
+namespace bench
+{
+
+/*!
+\brief 阻止编译器优化移除对象的计算结果。
+\note GCC 和 Clang 使用空内联汇编，其它实现使用 volatile 访问。
+*/
+template<typename _type>
+inline void
+do_not_optimize(const _type& v)
+{
+#if YB_IMPL_GNUCPP || YB_IMPL_CLANGPP
+	asm volatile("" : : "g"(&v) : "memory");
+#else
+	const volatile auto p(&v);
+
+	yunused(p);
+#endif
+}
+
+//! \brief 阻止编译器跨越调用重排内存访问。
+inline void
+clobber_memory()
+{
+#if YB_IMPL_GNUCPP || YB_IMPL_CLANGPP
+	asm volatile("" : : : "memory");
+#endif
+}
+
+
+/*!
+\brief 基准测试函数：参数为需要执行的迭代次数。
+\note 迭代内应使用 do_not_optimize 保持被测试的计算。
+*/
+using function = std::function<void(size_t)>;
+
+
+/*!
+\brief 统计样本的分位数。
+\pre 样本非空且已按升序排列。
+\pre 断言：第二参数在 [0, 1] 内。
+\note 使用相邻样本的线性插值。
+*/
+YB_API double
+percentile(const std::vector<double>&, double);
+
+
+//! \brief 基准测试结果。
+struct YB_API result
+{
+	std::string name;
+	//! \brief 每个样本的迭代次数。
+	size_t iterations = 0;
+	//! \brief 样本：每次迭代的纳秒数，按升序排列。
+	std::vector<double> samples{};
+	double min = 0, max = 0, mean = 0, median = 0, stddev = 0, p90 = 0,
+		p99 = 0;
+	//! \brief 超出 Tukey 围栏（ 1.5 倍四分位距）的样本数。
+	size_t outliers = 0;
+	//! \brief 是否具有硬件计数器结果。
+	bool has_counters = {};
+	//! \brief 每次迭代的 CPU 周期数和缓存未命中数。
+	double cycles = 0, cache_misses = 0;
+	//! \brief 和基线比较的中位数比值，无基线时为 0 。
+	double baseline_ratio = 0;
+	//! \brief 是否相对基线退化。
+	bool regressed = {};
+
+	/*!
+	\brief 从未排序的样本计算统计量。
+	\pre 样本非空。
+	*/
+	void
+	update_statistics();
+};
+
+
+//! \brief 输出格式。
+enum class format
+{
+	text,
+	json,
+	csv
+};
+
+
+//! \brief 运行选项。
+struct YB_API options
+{
+	//! \brief 名称过滤：非空时仅运行名称包含此子串的基准测试。
+	std::string filter{};
+	//! \brief 每个样本的最短纳秒数，用于自动确定迭代次数。
+	double min_sample_ns = 1e6;
+	//! \brief 样本数。
+	size_t samples = 30;
+	//! \brief 预热样本数：执行但不统计。
+	size_t warmup = 2;
+	//! \brief 是否尝试读取硬件计数器。
+	bool counters = true;
+	format output_format = format::text;
+	//! \brief 输出文件路径：为空时使用标准输出。
+	std::string output{};
+	//! \brief 基线文件路径：必须为 CSV 格式的输出。
+	std::string baseline{};
+	//! \brief 判断退化的中位数增长比例阈值。
+	double threshold = 0.1;
+
+	/*!
+	\brief 解析命令行参数。
+	\return 是否所有参数都被识别。
+
+	支持以下参数：
+	--bench-filter=NAME --bench-samples=N --bench-warmup=N
+	--bench-min-time-ms=MS --bench-format=text|json|csv --bench-output=PATH
+	--bench-baseline=PATH --bench-threshold=RATIO --bench-no-counters 。
+	*/
+	bool
+	parse(int, char*[]);
+};
+
+
+//! \brief 基准测试注册表。
+class YB_API registry
+{
+private:
+	std::vector<std::pair<std::string, function>> entries{};
+
+public:
+	//! \brief 取静态对象。
+	static registry&
+	instance();
+
+	void
+	add(std::string, function);
+
+	/*!
+	\brief 运行所有匹配过滤的基准测试。
+	\return 相对基线退化的基准测试数。
+	\throw std::runtime_error 打开输出或基线文件失败。
+	*/
+	size_t
+	run(const options&, std::ostream&) const;
+};
+
+
+/*!
+\brief 运行单个基准测试。
+\note 先倍增迭代次数直至单个样本不短于最短时间，再预热并采样。
+*/
+YB_API result
+run(const std::string&, const function&, const options& = {});
+
+/*!
+\brief 输出结果。
+\note 文本格式标注退化的结果。
+*/
+YB_API void
+write(std::ostream&, const std::vector<result>&, format);
+
+/*!
+\brief 读取 CSV 格式的基线结果，和结果比较并标注退化。
+\return 退化的结果数。
+\note 仅比较名称相同的结果的中位数。
+*/
+YB_API size_t
+compare(std::istream&, std::vector<result>&, double);
+
+
+//! \brief 注册辅助对象：构造时注册基准测试。
+struct YB_API registrar
+{
+	registrar(std::string, function);
+};
+
+} // namespace bench;
+
+} // namespace ytest;
+
+/*!
+\brief 定义并注册基准测试。
+\note 第一参数为名称，第二参数为函数体中迭代次数的参数名。
+\since build 818
+*/
+#define YTEST_BENCH(_name, _n) \
+	static void ytest_bench_##_name(ytest::size_t); \
+	static const ytest::bench::registrar \
+		ytest_bench_registrar_##_name(#_name, ytest_bench_##_name); \
+	static void ytest_bench_##_name(ytest::size_t _n)
+
+#endif
+
@@ -0,0 +1,532 @@
+﻿/*
+	© 2017 FrankHB.
+
+	This file is part of the YSLib project, and may only be used,
+	modified, and distributed under the terms of the YSLib project
+	license, LICENSE.TXT.  By continuing to use, modify, or distribute
+	this file you indicate that you have read the license and
+	understand and accept it fully.
+*/
+
+/*!	\file bench.cpp
+\ingroup YTest
+\brief 统计基准测试工具。
+\version r7
+\author FrankHB <frankhb1989@gmail.com>
+\since build 818
+\par 创建时间:
+	2017-08-02 10:05:32 +0800
+\par 修改时间:
+	2017-08-05 10:45 +0800
+\par 文本编码:
+	UTF-8
+\par 模块名称:
+	YTest::Bench
+*/
+
+
+#include "ytest/bench.h"
+#include <algorithm> // for std::sort, std::max;
+#include <cassert> // for assert;
+#include <chrono> // for std::chrono::steady_clock, std::chrono::duration;
+#include <cmath> // for std::floor, std::sqrt;
+#include <cstdlib> // for std::strtod, std::strtoul;
+#include <cstring> // for std::strncmp, std::strcmp, std::strlen;
+#include <fstream> // for std::ifstream, std::ofstream;
+#include <iomanip> // for std::setw, std::setprecision;
+#include <iostream> // for std::cout;
+#include <sstream> // for std::istringstream;
+#include <stdexcept> // for std::runtime_error;
+#if __linux__
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace ytest
+{
+
+namespace bench
+{
+
+namespace
+{
+
+//! \brief 单个样本的计数器读数。
+struct counter_values
+{
+	std::uint64_t cycles = 0, cache_misses = 0;
+};
+
+
+/*!
+\brief 硬件性能计数器组。
+\note 仅 Linux 使用 perf_event_open 实现；打开失败时不可用，不抛出异常。
+*/
+class counter_group
+{
+private:
+#if __linux__
+	int fd_cycles = -1, fd_misses = -1;
+#endif
+
+public:
+	counter_group(bool enabled)
+	{
+#if __linux__
+		if(enabled)
+		{
+			fd_cycles = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+			if(fd_cycles != -1)
+				fd_misses = open_counter(PERF_COUNT_HW_CACHE_MISSES,
+					fd_cycles);
+			if(fd_misses == -1)
+				close_all();
+		}
+#else
+		yunused(enabled);
+#endif
+	}
+	~counter_group()
+	{
+#if __linux__
+		close_all();
+#endif
+	}
+
+	bool
+	available() const ynothrow
+	{
+#if __linux__
+		return fd_misses != -1;
+#else
+		return {};
+#endif
+	}
+
+	void
+	start() const
+	{
+#if __linux__
+		if(available())
+		{
+			::ioctl(fd_cycles, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			::ioctl(fd_cycles, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		}
+#endif
+	}
+
+	counter_values
+	stop() const
+	{
+		counter_values res;
+
+#if __linux__
+		if(available())
+		{
+			::ioctl(fd_cycles, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+			// NOTE: Layout for %PERF_FORMAT_GROUP: count, then values.
+			std::uint64_t buf[3]{};
+
+			if(::read(fd_cycles, buf, sizeof(buf)) == ssize_t(sizeof(buf))
+				&& buf[0] == 2)
+				yunseq(res.cycles = buf[1], res.cache_misses = buf[2]);
+		}
+#endif
+		return res;
+	}
+
+private:
+#if __linux__
+	static int
+	open_counter(std::uint64_t config, int group_fd)
+	{
+		::perf_event_attr attr{};
+
+		yunseq(attr.type = PERF_TYPE_HARDWARE, attr.size = sizeof(attr),
+			attr.config = config, attr.read_format = PERF_FORMAT_GROUP);
+		// NOTE: Bit-fields cannot be bound to the parameters of %yunseq.
+		attr.disabled = group_fd == -1 ? 1 : 0;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return int(::syscall(__NR_perf_event_open, &attr, 0, -1, group_fd,
+			0));
+	}
+
+	void
+	close_all() ynothrow
+	{
+		if(fd_misses != -1)
+			::close(fd_misses);
+		if(fd_cycles != -1)
+			::close(fd_cycles);
+		yunseq(fd_cycles = -1, fd_misses = -1);
+	}
+#endif
+};
+
+
+//! \brief 计时单个样本，返回纳秒数。
+double
+time_sample(const function& f, size_t n)
+{
+	using namespace std::chrono;
+
+	return duration<double, std::nano>(timing::once(steady_clock::now, f, n))
+		.count();
+}
+
+const char*
+match_option(const char* arg, const char* name)
+{
+	const auto len(std::strlen(name));
+
+	return std::strncmp(arg, name, len) == 0 ? arg + len : nullptr;
+}
+
+//! \brief 转义 JSON 字符串。
+std::string
+escape_json(const std::string& str)
+{
+	std::string res;
+
+	for(const char c : str)
+		switch(c)
+		{
+		case '"':
+		case '\\':
+			res += '\\';
+			res += c;
+			break;
+		case '\n':
+			res += "\\n";
+			break;
+		default:
+			if(static_cast<unsigned char>(c) >= 0x20)
+				res += c;
+		}
+	return res;
+}
+
+std::vector<std::string>
+split_csv_line(const std::string& line)
+{
+	std::vector<std::string> res;
+	std::istringstream iss(line);
+	std::string field;
+
+	while(std::getline(iss, field, ','))
+	{
+		if(!field.empty() && field.back() == '\r')
+			field.pop_back();
+		res.push_back(field);
+	}
+	return res;
+}
+
+} // unnamed namespace;
+
+
+double
+percentile(const std::vector<double>& sorted, double p)
+{
+	assert(!sorted.empty());
+	assert(p >= 0 && p <= 1);
+
+	const double pos(p * double(sorted.size() - 1));
+	const auto lo(size_t(std::floor(pos)));
+
+	return lo + 1 < sorted.size() ? sorted[lo] + (pos - double(lo))
+		* (sorted[lo + 1] - sorted[lo]) : sorted[lo];
+}
+
+
+void
+result::update_statistics()
+{
+	assert(!samples.empty());
+	std::sort(samples.begin(), samples.end());
+
+	double sum(0);
+
+	for(const auto s : samples)
+		sum += s;
+	yunseq(min = samples.front(), max = samples.back(),
+		mean = sum / double(samples.size()), median = percentile(samples, .5),
+		p90 = percentile(samples, .9), p99 = percentile(samples, .99));
+
+	double var(0);
+
+	for(const auto s : samples)
+		var += (s - mean) * (s - mean);
+	stddev = samples.size() > 1 ? std::sqrt(var / double(samples.size() - 1))
+		: 0;
+
+	const double q1(percentile(samples, .25)), q3(percentile(samples, .75)),
+		fence((q3 - q1) * 1.5);
+
+	outliers = 0;
+	for(const auto s : samples)
+		if(s < q1 - fence || s > q3 + fence)
+			++outliers;
+}
+
+
+bool
+options::parse(int argc, char* argv[])
+{
+	bool res(true);
+
+	for(int i(1); i < argc; ++i)
+	{
+		const char* const arg(argv[i]);
+		const char* val;
+
+		if((val = match_option(arg, "--bench-filter=")))
+			filter = val;
+		else if((val = match_option(arg, "--bench-samples=")))
+			samples = std::max<size_t>(std::strtoul(val, {}, 10), 1);
+		else if((val = match_option(arg, "--bench-warmup=")))
+			warmup = std::strtoul(val, {}, 10);
+		else if((val = match_option(arg, "--bench-min-time-ms=")))
+			min_sample_ns = std::strtod(val, {}) * 1e6;
+		else if((val = match_option(arg, "--bench-format=")))
+		{
+			if(std::strcmp(val, "json") == 0)
+				output_format = format::json;
+			else if(std::strcmp(val, "csv") == 0)
+				output_format = format::csv;
+			else if(std::strcmp(val, "text") == 0)
+				output_format = format::text;
+			else
+				res = {};
+		}
+		else if((val = match_option(arg, "--bench-output=")))
+			output = val;
+		else if((val = match_option(arg, "--bench-baseline=")))
+			baseline = val;
+		else if((val = match_option(arg, "--bench-threshold=")))
+			threshold = std::strtod(val, {});
+		else if(std::strcmp(arg, "--bench-no-counters") == 0)
+			counters = {};
+		else if(std::strcmp(arg, "--bench") != 0)
+			res = {};
+	}
+	return res;
+}
+
+
+registry&
+registry::instance()
+{
+	static registry reg;
+
+	return reg;
+}
+
+void
+registry::add(std::string name, function f)
+{
+	entries.emplace_back(std::move(name), std::move(f));
+}
+
+size_t
+registry::run(const options& opts, std::ostream& os) const
+{
+	std::vector<result> results;
+
+	for(const auto& entry : entries)
+		if(opts.filter.empty()
+			|| entry.first.find(opts.filter) != std::string::npos)
+			results.push_back(bench::run(entry.first, entry.second, opts));
+
+	size_t regressions(0);
+
+	if(!opts.baseline.empty())
+	{
+		std::ifstream ifs(opts.baseline);
+
+		if(!ifs)
+			throw std::runtime_error("Failed opening baseline file '"
+				+ opts.baseline + "'.");
+		regressions = compare(ifs, results, opts.threshold);
+	}
+	if(opts.output.empty())
+		write(os, results, opts.output_format);
+	else
+	{
+		std::ofstream ofs(opts.output);
+
+		if(!ofs)
+			throw std::runtime_error("Failed opening output file '"
+				+ opts.output + "'.");
+		write(ofs, results, opts.output_format);
+	}
+	return regressions;
+}
+
+
+result
+run(const std::string& name, const function& f, const options& opts)
+{
+	result res;
+	size_t n(1);
+
+	res.name = name;
+	// NOTE: Scale iterations until one sample is long enough to be measured
+	//	reliably by the clock.
+	for(double t(time_sample(f, n)); t < opts.min_sample_ns
+		&& n < (size_t(1) << 40); t = time_sample(f, n))
+		n = t * 10 < opts.min_sample_ns ? n * 10 : n * 2;
+	res.iterations = n;
+	for(size_t i(0); i != opts.warmup; ++i)
+		time_sample(f, n);
+
+	counter_group counters(opts.counters);
+	counter_values total;
+
+	res.samples.reserve(opts.samples);
+	for(size_t i(0); i != opts.samples; ++i)
+	{
+		counters.start();
+		res.samples.push_back(time_sample(f, n) / double(n));
+
+		const auto v(counters.stop());
+
+		yunseq(total.cycles += v.cycles, total.cache_misses += v.cache_misses);
+	}
+	res.update_statistics();
+	if(counters.available())
+	{
+		const double cnt(double(n) * double(opts.samples));
+
+		yunseq(res.has_counters = true, res.cycles = double(total.cycles) / cnt,
+			res.cache_misses = double(total.cache_misses) / cnt);
+	}
+	return res;
+}
+
+
+void
+write(std::ostream& os, const std::vector<result>& results, format fmt)
+{
+	const auto flags(os.flags());
+	const auto prec(os.precision());
+
+	// NOTE: Fixed notation keeps the output stable for tools tracking trends.
+	os << std::fixed << std::setprecision(fmt == format::text ? 2 : 3);
+	switch(fmt)
+	{
+	case format::json:
+		os << "[\n";
+		for(size_t i(0); i != results.size(); ++i)
+		{
+			const auto& r(results[i]);
+
+			os << "  {\"name\": \"" << escape_json(r.name)
+				<< "\", \"iterations\": " << r.iterations << ", \"samples\": "
+				<< r.samples.size() << ", \"median_ns\": " << r.median
+				<< ", \"mean_ns\": " << r.mean << ", \"stddev_ns\": "
+				<< r.stddev << ", \"min_ns\": " << r.min << ", \"max_ns\": "
+				<< r.max << ", \"p90_ns\": " << r.p90 << ", \"p99_ns\": "
+				<< r.p99 << ", \"outliers\": " << r.outliers;
+			if(r.has_counters)
+				os << ", \"cycles\": " << r.cycles << ", \"cache_misses\": "
+					<< r.cache_misses;
+			if(r.baseline_ratio > 0)
+				os << ", \"baseline_ratio\": " << r.baseline_ratio
+					<< ", \"regressed\": " << (r.regressed ? "true" : "false");
+			os << (i + 1 != results.size() ? "},\n" : "}\n");
+		}
+		os << "]\n";
+		break;
+	case format::csv:
+		os << "name,iterations,samples,median_ns,mean_ns,stddev_ns,min_ns,"
+			"max_ns,p90_ns,p99_ns,outliers,cycles,cache_misses\n";
+		for(const auto& r : results)
+		{
+			os << r.name << ',' << r.iterations << ',' << r.samples.size()
+				<< ',' << r.median << ',' << r.mean << ',' << r.stddev << ','
+				<< r.min << ',' << r.max << ',' << r.p90 << ',' << r.p99 << ','
+				<< r.outliers << ',';
+			if(r.has_counters)
+				os << r.cycles << ',' << r.cache_misses;
+			else
+				os << ',';
+			os << '\n';
+		}
+		break;
+	default:
+		for(const auto& r : results)
+		{
+			os << std::left << std::setw(32) << r.name << std::right
+				<< " median " << std::setw(12) << r.median << " ns  p90 "
+				<< std::setw(12) << r.p90 << " ns  p99 " << std::setw(12)
+				<< r.p99 << " ns  stddev " << std::setw(10) << r.stddev
+				<< " ns  x" << r.iterations;
+			if(r.outliers != 0)
+				os << "  outliers " << r.outliers;
+			if(r.has_counters)
+				os << "  cycles " << r.cycles << "  cache-misses "
+					<< r.cache_misses;
+			if(r.baseline_ratio > 0)
+				os << "  baseline x" << r.baseline_ratio
+					<< (r.regressed ? "  REGRESSED" : "");
+			os << '\n';
+		}
+	}
+	yunseq(os.flags(flags), os.precision(prec));
+}
+
+size_t
+compare(std::istream& is, std::vector<result>& results, double threshold)
+{
+	std::string line;
+	size_t median_idx(size_t(-1)), regressions(0);
+
+	if(std::getline(is, line))
+	{
+		const auto header(split_csv_line(line));
+
+		for(size_t i(0); i != header.size(); ++i)
+			if(header[i] == "median_ns")
+				median_idx = i;
+	}
+	if(median_idx == size_t(-1))
+		throw std::runtime_error("Invalid baseline: missing median column.");
+	while(std::getline(is, line))
+	{
+		const auto fields(split_csv_line(line));
+
+		if(fields.size() > median_idx)
+		{
+			const double base(std::strtod(fields[median_idx].c_str(), {}));
+
+			if(base > 0)
+				for(auto& r : results)
+					if(r.name == fields[0])
+					{
+						r.baseline_ratio = r.median / base;
+						if(r.baseline_ratio > 1 + threshold)
+						{
+							r.regressed = true;
+							++regressions;
+						}
+					}
+		}
+	}
+	return regressions;
+}
+
+
+registrar::registrar(std::string name, function f)
+{
+	registry::instance().add(std::move(name), std::move(f));
+}
+
+} // namespace bench;
+
+} // namespace ytest;
+
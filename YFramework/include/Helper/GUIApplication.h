@@ -1,5 +1,5 @@
 ﻿/*
-	© 2012-2016 FrankHB.
+	© 2012-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file GUIApplication.h
 \ingroup Helper
 \brief GUI 应用程序。
-\version r557
+\version r566
 \author FrankHB <frankhb1989@gmail.com>
 \since build 398
 \par 创建时间:
 	2013-04-11 10:02:53 +0800
 \par 修改时间:
-	2016-09-01 12:05 +0800
+	2017-08-06 10:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -33,6 +33,7 @@
 #include YFM_Helper_HostWindow // for Host::Window;
 #include YFM_YCLib_NativeAPI
 #include YFM_YSLib_Core_YApplication // for Application;
+#include YFM_YSLib_Core_YClock // for Timers::Duration, Timers::TimePoint;
 #include <ystdex/cast.hpp> // for ystdex::polymorphic_downcast;
 #include YFM_Helper_GUIShell
 #include YFM_YCLib_HostedGUI
@@ -212,6 +213,14 @@ private:
 
 	//! \since build 692
 	ystdex::call_once_init<InitBlock, once_flag> init;
+	/*!
+	\brief 请求的唤醒时刻。
+	\sa RequestWakeUp
+	\since build 799
+	*/
+	Timers::TimePoint wake_deadline{Timers::TimePoint::max()};
+	//! \since build 799
+	mutable mutex wake_mutex{};
 
 public:
 	/*!
@@ -221,6 +230,18 @@ public:
 	用于主消息队列的消息循环中控制后台消息生成策略的全局消息优先级。
 	*/
 	Messaging::Priority UIResponseLimit = 0x40;
+	/*!
+	\brief 空闲时阻塞等待的最长时间。
+	\note 仅对支持阻塞等待的实现有效；为零时不阻塞。
+	\sa DealMessage
+	\since build 799
+
+	主消息队列为空时，消息循环阻塞直至以下时刻中最早的一个：
+	有新消息；宿主事件通过 Application::Wake 唤醒；通过 RequestWakeUp 请求的时刻；
+	GUI 保持输入状态需要检查的时刻；以此成员指定的时间超时。
+	超时限制仅用于保证非事件驱动的状态改变最终被处理。
+	*/
+	Timers::Duration MaxIdleWait{std::chrono::milliseconds(250)};
 
 	/*!
 	\brief 无参数构造。
@@ -238,21 +259,42 @@ public:
 	//! \since build 570
 	GUIHost&
 	GetGUIHostRef() const ynothrow;
+	/*!
+	\brief 取主消息队列为空时消息循环阻塞等待的时间。
+	\note 线程安全。
+	\note 非宿主实现或 Android 平台输入由轮询取得，总是为零。
+	\since build 799
+	*/
+	Timers::Duration
+	GetIdleWaitDuration() const;
 
 	/*!
 	\brief 处理当前消息。
 	\return 循环条件。
 	\note 线程安全：全局消息队列互斥访问。
 	\note 优先级小于 UIResponseLimit 的消息时视为后台消息，否则为前台消息。
-	\note 消息在响应消息后移除。
-	\warning 应保证不移除正在被响应的消息。
+	\note 消息在响应前从主消息队列中移出。
 
 	若主消息队列为空，处理空闲消息，否则从主消息队列取出并分发消息。
 	当取出的消息的标识为 SM_Quit 时视为终止循环。
 	对后台消息，分发前调用后台消息处理程序：分发空闲消息并可进行时序控制。
+	处理空闲消息前，以 GetIdleWaitDuration 的结果作为超时调用 WaitForMessage ，
+	若等待后主消息队列非空则改为处理队列中的消息。
 	*/
 	bool
 	DealMessage();
+
+	/*!
+	\brief 请求在不晚于指定时刻唤醒空闲的消息循环。
+	\note 线程安全。
+	\note 多次请求时保留最早的时刻；到达后自动清除。
+	\since build 799
+
+	用于不通过消息队列部署且需要按时检查的计时器等状态。
+	若请求的时刻早于当前等待结束的时刻，唤醒等待的线程以重新计算等待时间。
+	*/
+	void
+	RequestWakeUp(Timers::TimePoint) override;
 };
 
 
@@ -301,6 +343,8 @@ inline PDefH(GUIHost&, FetchGUIHost, )
 \brief 执行程序主消息循环。
 \throw GeneralEvent 激活主 shell 失败。
 \note 对宿主实现，设置退出所有窗口时向 YSLib 发送退出消息。
+\note 空闲时阻塞等待。
+\sa GUIApplication::DealMessage
 \since build 399
 */
 YF_API void
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2013-2016 FrankHB.
+	© 2013-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file HostedUI.h
 \ingroup Helper
 \brief 宿主环境支持的用户界面。
-\version r479
+\version r480
 \author FrankHB <frankhb1989@gmail.com>
 \since build 389
 \par 创建时间:
 	2013-03-17 10:22:29 +0800
 \par 修改时间:
-	2016-12-10 00:56 +0800
+	2017-08-05 17:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -193,6 +193,7 @@ ActOnHover_ShowTopLevelAt(UI::IWidget& sender, UI::Widget& wgt, _func f)
 /*!
 \brief 以参数指定的悬停状态，绑定悬停指定部件上时在宿主作为提示显示的顶层部件。
 \return 插入被悬停部件的事件 CursorOver 和 Leave 的迭代器。
+\warning 返回的迭代器在下一次修改对应事件的事件响应前有效。
 \exception BadEvent 异常中立：由 FetchEvent 抛出。
 \exception std::bad_cast 异常中立：由 FetchEvent 抛出。
 \note 不完全强异常安全：只保证由 FetchEvent 调用抛出异常时未添加事件处理器。
@@ -11,13 +11,13 @@
 /*!	\file Dependency.h
 \ingroup NPL
 \brief 依赖管理。
-\version r152
+\version r154
 \author FrankHB <frankhb1989@gmail.com>
 \since build 623
 \par 创建时间:
 	2015-08-09 22:12:37 +0800
 \par 修改时间:
-	2017-01-04 12:52 +0800
+	2017-07-30 19:27 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -87,7 +87,10 @@ inline PDefH(void, InstallFile, const string& dst, const string& src)
 	ImplExpr(InstallFile(dst.c_str(), src.c_str()))
 //@}
 
-//! \brief 安装目录：复制目录树。
+/*!
+\brief 安装目录：复制目录树。
+\note 支持多线程时在任务池中并发安装文件。
+*/
 //@{
 //! \since build 659
 YF_API void
@@ -144,6 +147,16 @@ namespace Forms
 \todo 语法形式文档。
 
 加载 SHBuild 自举使用的公共语法形式。
+自 build 812 起，支持以下并发求值的语法形式：
+future <expression> ：创建期值，并发规约表达式；
+force <object> ：等待期值的规约结果，对其它对象结果为参数的值；
+parallel-map <applicative> <list> ：并发以列表的每个元素为参数调用应用子。
+并发规约使用线程池，在支持多线程的平台上并发执行。其中的环境隔离规则如下：
+每个并发的规约使用调用时的环境的副本，复制规则同 copy-environment ，
+	因此定义不影响其它规约使用的环境；
+表达式和参数在调用时被复制，结果在 force 或 parallel-map 返回时被复制；
+闭包的静态环境不被复制，在并发规约完成前不应被修改；
+在并发规约中嵌套的 future 和 parallel-map 直接在当前线程中规约。
 */
 YF_API void
 LoadNPLContextForSHBuild(REPLContext&);
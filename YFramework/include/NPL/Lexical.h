@@ -11,13 +11,13 @@
 /*!	\file Lexical.h
 \ingroup NPL
 \brief NPL 词法处理。
-\version r1550
+\version r1553
 \author FrankHB <frankhb1989@gmail.com>
 \since build 335
 \par 创建时间:
 	2012-08-03 23:04:28 +0800
 \par 修改时间:
-	2017-06-13 15:41 +0800
+	2017-08-02 20:10 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -304,13 +304,23 @@ EscapeLiteral(string_view);
 
 /*!
 \brief 编码 XML 字符串。
+\pre 断言：参数的数据指针非空。
 \see http://www.w3.org/TR/2006/REC-xml11-20060816/#charsets 。
 
 允许 XML 1.1 字符，仅对空字符使用 YTraceDe 进行警告。
 仅对 XML 1.0 和 XML 1.1 规定的有条件使用字符 \c & 、 \c < 和 \c > 生成转义序列。
 */
+//@{
 YF_API string
 EscapeXML(string_view);
+/*!
+\brief 按顺序以编码结果的各个部分调用第二参数。
+\note 不需要转义的连续字符作为一个部分整体传递，转义序列作为单独的部分传递。
+\since build 820
+*/
+YF_API void
+EscapeXML(string_view, std::function<void(string_view)>);
+//@}
 
 /*!
 \brief 修饰字符串为字面量。
@@ -11,13 +11,13 @@
 /*!	\file NPLA.h
 \ingroup NPL
 \brief NPLA 公共接口。
-\version r2122
+\version r2130
 \author FrankHB <frankhb1989@gmail.com>
 \since build 663
 \par 创建时间:
 	2016-01-07 10:32:34 +0800
 \par 修改时间:
-	2017-07-12 14:07 +0800
+	2017-08-05 14:20 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -284,12 +284,14 @@ ConvertAttributeNodeString(const TermNode&);
 \throw LoggedEvent 不符合最后一个参数约定的内容被解析。
 \throw ystdex::unimplemented 指定 ParseOption::Strict 时解析未实现内容。
 \sa ConvertStringNode
+\sa WriteDocumentNode
 \see http://okmij.org/ftp/Scheme/SXML.html#Annotations 。
 \todo 支持 *ENTITY* 和 *NAMESPACES* 标签。
 
 转换 SXML 文档节点为 XML 。
 尝试使用 ConvertStringNode 转换字符串节点，若失败作为非叶子节点递归转换。
 因为当前 SXML 规范未指定注解(annotation) ，所以直接忽略。
+结果和使用相同参数调用 WriteDocumentNode 输出的内容相同。
 */
 YF_API string
 ConvertDocumentNode(const TermNode&, IndentGenerator = DefaultGenerateIndent,
@@ -304,17 +306,36 @@ ConvertStringNode(const TermNode&);
 
 /*!
 \brief 打印 SContext::Analyze 分析取得的 SXML 语法树节点并刷新流。
+\note 不构造中间字符串，直接输出到流。
 \see ConvertDocumentNode
 \see SContext::Analyze
 \see Session
 
-参数节点中取第一个节点作为 SXML 文档节点调用 ConvertStringNode 输出并刷新流。
+参数节点中取第一个节点作为 SXML 文档节点，
+	输出和 ConvertDocumentNode 转换结果除第一个字符外相同的内容并刷新流。
 */
 YF_API void
 PrintSyntaxNode(std::ostream& os, const TermNode&,
 	IndentGenerator = DefaultGenerateIndent, size_t = 0);
 //@}
 
+/*!
+\brief 输出 SXML 文档节点为 XML 。
+\exception LoggedEvent 不符合最后一个参数约定的内容被解析。
+\exception ystdex::unimplemented 指定 ParseOption::Strict 时解析未实现内容。
+\note 抛出异常时，之前的内容可能已被输出。
+\note 时间和空间复杂度和输出的大小线性相关。
+\sa ConvertDocumentNode
+\since build 820
+
+使用和 ConvertDocumentNode 相同的规则转换 SXML 文档节点，直接输出到流中。
+字符串节点使用 EscapeXML 按区间转义后输出。
+*/
+YF_API void
+WriteDocumentNode(std::ostream&, const TermNode&,
+	IndentGenerator = DefaultGenerateIndent, size_t = 0,
+	ParseOption = ParseOption::Normal);
+
 
 //! \since build 599
 //@{
@@ -1055,6 +1076,20 @@ public:
 	EvaluationPasses EvaluateList{};
 	LiteralPasses EvaluateLiteral{};
 	GuardPasses Guard{};
+	/*!
+	\brief 尾上下文：非空时指定之后规约当前项使用的上下文。
+	\note 由规约实现在调用处理器后取得并清除，用于实现不嵌套规约调用的尾调用。
+	\sa TailTerm
+	\since build 811
+	*/
+	shared_ptr<ContextNode> TailContext{};
+	/*!
+	\brief 尾项：非空时指定允许作为尾调用被调用者继续规约的项。
+	\note 由规约实现在调用处理器前设置并在调用后清除。
+	\note 处理器只对此项进行尾调用，并在进行尾调用时清除此项。
+	\since build 823
+	*/
+	observer_ptr<const TermNode> TailTerm{};
 
 	DefDeCtor(ContextNode)
 	/*!
@@ -1087,7 +1122,8 @@ public:
 	friend PDefH(void, swap, ContextNode& x, ContextNode& y) ynothrow
 		ImplExpr(swap(x.p_record, y.p_record), swap(x.EvaluateLeaf,
 			y.EvaluateLeaf), swap(x.EvaluateList, y.EvaluateList),
-			swap(x.EvaluateLiteral, y.EvaluateLiteral), swap(x.Guard, y.Guard))
+			swap(x.EvaluateLiteral, y.EvaluateLiteral), swap(x.Guard, y.Guard),
+			swap(x.TailContext, y.TailContext), swap(x.TailTerm, y.TailTerm))
 	//@}
 };
 
@@ -11,13 +11,13 @@
 /*!	\file NPLA1.h
 \ingroup NPL
 \brief NPLA1 公共接口。
-\version r3323
+\version r3330
 \author FrankHB <frankhb1989@gmail.com>
 \since build 472
 \par 创建时间:
 	2014-02-02 17:58:24 +0800
 \par 修改时间:
-	2017-07-10 13:57 +0800
+	2017-08-05 14:20 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -258,6 +258,17 @@ InvokeLiteral(TermNode&, ContextNode&, string_view);
 例外情况包括输入节点不是表达式语义结构（而是 AST ）的 API ，如 TransformNode 。
 当前实现返回的规约状态总是 ReductionStatus::Clean ，否则会循环迭代。
 若需要保证无异常时仅在规约成功后终止，使用 ReduceChecked 代替。
+对枝节点调用 InvokeList 前设置上下文的 TailTerm 为被规约的项，调用后清除，
+	并在退出时恢复调用前的 TailTerm 。
+迭代中调用处理器后，若上下文的 TailContext 非空，则转移其值，
+	之后的迭代使用其指定的上下文代替当前上下文（直至再次被替换），
+	而不嵌套调用 Reduce ，因此尾调用的深度不受本机栈的限制；
+	非尾调用（如参数的求值）仍嵌套调用 Reduce 。
+替换尾上下文时，复制项中的值，并只保留仍可从当前尾上下文的环境、
+	项和其中的 VauHandler 的静态环境访问的被替换的尾上下文的环境。
+	不检查其它上下文中对这些环境的引用。
+迭代结束时若发生过替换，则复制结果中的值以避免引用这些环境中的对象。
+进行尾调用后的迭代中的异常被转换，和 FormContextHandler 中的处理相同。
 */
 YF_API ReductionStatus
 Reduce(TermNode&, ContextNode&);
@@ -359,7 +370,11 @@ ReduceFirst(TermNode&, ContextNode&);
 
 /*!
 \brief 规约有序序列：顺序规约子项，结果为最后一个子项的规约结果。
-\return 当存在子项时为最后一个子项的规约状态，否则为 ReductionStatus::Clean 。
+\return 接受尾调用时为 ReductionStatus::Retrying ，
+	否则为最后一个子项的规约状态或 ReductionStatus::Clean 。
+\note 当存在多于一个子项且项是上下文的 TailTerm 时接受尾调用：
+	最后一个子项不被规约而被提升为当前项，由调用者作为尾调用继续规约。
+\sa ContextNode::TailTerm
 \sa ReduceChildrenOrdered
 \since build 764
 
@@ -831,6 +846,15 @@ public:
 	TermPasses Preprocess{};
 	//! \brief 表项处理例程：每次翻译中规约回调处理调用的公共例程。
 	EvaluationPasses ListTermPreprocess{};
+	/*!
+	\brief 语句分隔符：加载时划分顶层语句的记号字符。
+	\note 空字符表示不划分，整个来源作为一个项处理。
+	\warning 仅当分隔符被处理为顺序求值时，划分语句不改变语义。
+	\sa LoadFrom
+	\sa RegisterSequenceContextTransformer
+	\since build 810
+	*/
+	char StatementSeparator = {};
 
 	/*!
 	\brief 构造：使用默认的解释。
@@ -843,7 +867,11 @@ public:
 
 	/*!
 	\brief 加载：从指定参数指定的来源读取并处理源代码。
+	\note 若 StatementSeparator 非空字符，每读取不在字面量和括号中的分隔符时，
+		分析并处理之前的语句，然后丢弃已读取的内容。
+	\note 划分语句时，之后语句的语法错误不影响之前已处理的语句。
 	\sa Process
+	\sa StatementSeparator
 	\since build 758
 	*/
 	//@{
@@ -1526,6 +1554,8 @@ EqualValue(TermNode&);
 
 以表达式 <expression> 和环境 <environment> 为指定的参数进行求值。
 环境以 ContextNode 的引用表示。
+表达式被提升为当前项。若项是上下文的 TailTerm ，
+	设置 TailContext 后由调用者作为尾调用继续规约；否则直接规约。
 参考调用文法：
 eval <expression> <environment>
 */
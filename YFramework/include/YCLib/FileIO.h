@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file FileIO.h
 \ingroup YCLib
 \brief 平台相关的文件访问和输入/输出接口。
-\version r2581
+\version r2586
 \author FrankHB <frankhb1989@gmail.com>
 \since build 616
 \par 创建时间:
 	2015-07-14 18:50:35 +0800
 \par 修改时间:
-	2016-09-17 12:42 +0800
+	2017-08-06 17:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -408,7 +408,9 @@ public:
 	WriteContent(FileDescriptor, FileDescriptor, byte*, size_t);
 	/*!
 	\note 最后一个参数指定缓冲区大小的上限，若分配失败自动重新分配。
+	\note Linux 平台：源为常规文件时优先使用内核复制，不适用时使用缓冲区。
 	\throw std::bad_alloc 缓冲区分配失败。
+	\sa \c FICLONE 、 \c copy_file_range 、 \c ::sendfile
 	*/
 	static void
 	WriteContent(FileDescriptor, FileDescriptor,
@@ -1356,11 +1358,15 @@ EnsureUniqueFile(const char*, mode_t = DefaultPMode(), size_t = 1, bool = {});
 /*!
 \brief 比较文件内容相等。
 \throw std::system_error 文件按流打开失败。
+\note 映射失败不抛出异常，而改为按流比较。
 \warning 读取失败时即截断返回，因此需要另行比较文件大小。
 \sa IsNodeShared
 \since build 658
 
-首先比较文件节点，若为相同文件直接相等，否则清除 errno ，打开文件读取内容并比较。
+首先比较文件节点，若为相同文件直接相等。
+非 Win32 宿主平台：若文件都是常规文件，比较剩余大小，不相等时直接不相等；
+	否则映射文件并分块比较，除非文件过大或映射失败。
+否则，清除 errno ，打开文件读取内容并比较。
 */
 //@{
 //! \note 间接断言：参数非空。
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file FileSystem.h
 \ingroup YCLib
 \brief 平台相关的文件系统接口。
-\version r3565
+\version r3566
 \author FrankHB <frankhb1989@gmail.com>
 \since build 312
 \par 创建时间:
 	2012-05-30 22:38:37 +0800
 \par 修改时间:
-	2016-09-16 04:51 +0800
+	2017-07-24 15:02 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -637,6 +637,8 @@ public:
 	\brief 取节点状态信息确定的文件系统节点类别。
 	\return 未迭代文件时为 NodeCategory::Empty ，否则为对应的其它节点类别。
 	\note 不同系统支持的可能不同。
+	\note 非 DS 的 POSIX 平台：优先使用目录项中的类型，否则以相对打开的目录的
+		\c ::fstatat 取状态，不构造节点路径。
 	\since build 474
 	*/
 	NodeCategory
@@ -13,13 +13,13 @@
 \ingroup YCLibLimitedPlatforms
 \ingroup Host
 \brief YCLib 宿主平台公共扩展。
-\version r548
+\version r553
 \author FrankHB <frankhb1989@gmail.com>
 \since build 492
 \par 创建时间:
 	2014-04-09 19:03:55 +0800
 \par 修改时间:
-	2017-06-05 02:09 +0800
+	2017-08-06 17:05 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -33,7 +33,7 @@
 #include "YCLib/YModules.h"
 #include "YSLib/Core/YModules.h"
 #include YFM_YCLib_Container // for unordered_map, pair, string_view, string,
-//	ystdex::invoke;
+//	ystdex::invoke, vector;
 #include YFM_YSLib_Core_YException // for YSLib::LoggedEvent;
 #include YFM_YCLib_Reference // for unique_ptr_from, unique_ptr, observer_ptr,
 //	tidy_ptr, make_observer;
@@ -295,6 +295,51 @@ inline PDefH(string, FetchCachedCommandString, const string& cmd,
 //@}
 //@}
 
+/*!
+\brief 取持久化缓冲的命令在标准输出上的执行结果。
+\return 读取的二进制存储和关闭管道的返回值（可来自于被调用命令）。
+\exception std::system_error 缓冲未命中时执行命令失败。
+\throw std::invalid_argument 最后参数的值等于 \c 0 。
+\sa FetchCommandOutput
+\since build 813
+
+第一参数指定命令；第二参数指定保存缓冲项的目录，为空时不使用缓冲；
+第三参数指定影响命令结果的环境变量名称；第四参数指定依赖的文件路径，
+	一般为命令调用的可执行文件；最后参数指定每次读取的缓冲区大小。
+缓冲项以命令、当前工作目录、环境变量 PATH 和第三参数指定的环境变量的值
+	及第四参数指定的文件的修改时间作为键，以键的散列值作为文件名保存在目录中。
+键不匹配的缓冲项视为未命中。执行命令后，若返回值为 \c 0 ，
+	结果先写入临时文件再替换缓冲项，因此允许多个进程并发访问同一目录；
+	写入缓冲项的错误被忽略。返回值非 \c 0 的结果不被保存。
+*/
+YF_API pair<string, int>
+FetchPersistentCommandOutput(const string&, const string&,
+	const vector<string>& = {}, const vector<string>& = {},
+	size_t = DefaultCommandBufferSize);
+
+/*!
+\brief 不经过命令解释器创建子进程执行程序并取标准输出和标准错误上的输出。
+\pre 断言：第一参数非空。
+\return 读取的二进制存储和子进程的退出状态。
+\exception std::system_error 创建管道、创建子进程、读取或等待子进程失败。
+\throw std::invalid_argument 第二参数的值等于 \c 0 。
+\sa FetchCommandOutput
+\since build 814
+
+第一参数的第一个元素指定程序，不含路径分隔符时按环境变量 PATH 查找；
+	其余元素依次作为程序的参数，不经过引用和展开。
+第二参数指定每次读取的缓冲区大小，先于执行程序进行检查。
+子进程的标准输出和标准错误重定向至同一管道，全部输出在子进程结束后一并返回，
+	因此并发调用时各子进程的输出不会交错。
+子进程正常退出时退出状态为退出码，因信号终止时为 128 和信号值之和。
+非 Win32 平台：使用 \c ::posix_spawnp 创建子进程，管道端点不被其它子进程继承。
+Win32 平台：以引用的参数组成命令行，使用 \c ::CreateProcessW 创建子进程，
+	退出状态为进程退出码；管道写端可能被并发创建的其它子进程继承。
+*/
+YF_API pair<string, int>
+FetchProcessOutput(const vector<string>&, size_t = DefaultCommandBufferSize);
+
+
 /*!
 \brief 创建管道。
 \return 用于管道两端读写的文件句柄对。
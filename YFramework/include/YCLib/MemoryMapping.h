@@ -1,5 +1,5 @@
 ﻿/*
-	© 2012-2016 FrankHB.
+	© 2012-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file MemoryMapping.h
 \ingroup YCLib
 \brief 内存映射文件。
-\version r333
+\version r335
 \author FrankHB <frankhb1989@gmail.com>
 \since build 324
 \par 创建时间:
 	2012-07-11 21:48:15 +0800
 \par 修改时间:
-	2016-08-27 00:47 +0800
+	2017-07-23 20:41 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -67,6 +67,22 @@ using FileMappingKey = bool;
 //@}
 
 
+/*!
+\brief 文件映射访问提示。
+\note 仅作为性能提示，不影响映射的语义。
+\sa MappedFile::Advise
+\since build 803
+*/
+enum class FileMappingAdvice
+{
+	Normal,
+	Sequential,
+	Random,
+	WillNeed,
+	DontNeed
+};
+
+
 //! \since build 669
 class YF_API UnmapDelete
 #if YCL_DS
@@ -210,6 +226,19 @@ public:
 	//! \since build 723
 	DefGetter(const ynothrow, const UniqueFile&, UniqueFile, file)
 
+	/*!
+	\brief 提示映射视图中指定区域的访问方式。
+	\pre 断言： \c GetPtr() 。
+	\note 参数依次为区域偏移、区域长度和提示。
+	\note 区域起始偏移向下按页对齐，超出视图的部分被忽略。
+	\note 忽略错误。
+	\note DS 、Win32 和 Android 平台：空操作。
+	\since build 803
+	*/
+	void
+	Advise(size_t, size_t, FileMappingAdvice = FileMappingAdvice::WillNeed) const
+		ynothrow;
+
 	//! \since build 712
 	//@{
 	/*!
@@ -11,13 +11,13 @@
 /*!	\file ValueNode.h
 \ingroup Core
 \brief 值类型节点。
-\version r3164
+\version r3167
 \author FrankHB <frankhb1989@gmail.com>
 \since build 338
 \par 创建时间:
 	2012-08-03 23:03:44 +0800
 \par 修改时间:
-	2017-06-03 11:50 +0800
+	2017-07-27 22:05 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -31,6 +31,7 @@
 #include "YModules.h"
 #include YFM_YSLib_Core_YObject // for ystdex::invoke;
 #include <ystdex/path.hpp>
+#include <ystdex/memory.hpp> // for ystdex::pooled_allocator;
 #include <ystdex/set.hpp> // for ystdex::mapped_set;
 #include <numeric> // for std::accumulate;
 
@@ -47,6 +48,33 @@ yconstexpr const struct NoContainerTag{} NoContainer{};
 //@}
 
 
+//! \since build 809
+class ValueNode;
+
+/*!
+\def YF_Use_ValueNodePool
+\brief 值类型节点的子节点容器是否使用线程局部的节点池分配。
+\note 默认在支持 thread_local 或不支持多线程时启用。
+\note 定义为 0 时使用 std::allocator 。
+\sa ValueNodeAllocator
+\since build 809
+*/
+#ifndef YF_Use_ValueNodePool
+#	define YF_Use_ValueNodePool (YB_HAS_THREAD_LOCAL || !YF_Multithread)
+#endif
+
+/*!
+\brief 值类型节点的子节点容器的分配器。
+\note 所有子节点容器使用相同的无状态分配器，转移子树时保留原有节点。
+\since build 809
+*/
+#if YF_Use_ValueNodePool
+using ValueNodeAllocator = ystdex::pooled_allocator<ValueNode>;
+#else
+using ValueNodeAllocator = std::allocator<ValueNode>;
+#endif
+
+
 /*!
 \brief 值类型节点。
 \warning 非虚析构。
@@ -59,7 +87,8 @@ class YF_API ValueNode : private ystdex::totally_ordered<ValueNode>,
 	private ystdex::totally_ordered<ValueNode, string>
 {
 public:
-	using Container = ystdex::mapped_set<ValueNode, ystdex::less<>>;
+	using Container
+		= ystdex::mapped_set<ValueNode, ystdex::less<>, ValueNodeAllocator>;
 	//! \since build 678
 	using key_type = typename Container::key_type;
 	//! \since build 460
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YApplication.h
 \ingroup Core
 \brief 系统资源和应用程序实例抽象。
-\version r1773
+\version r1782
 \author FrankHB <frankhb1989@gmail.com>
 \since build 577
 \par 创建时间:
 	2009-12-27 17:12:27 +0800
 \par 修改时间:
-	2016-09-03 10:18 +0800
+	2017-08-06 10:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -33,6 +33,11 @@
 //	std::is_nothrow_copy_constructible, locked_ptr, ystdex::decay_t;
 #include <ystdex/any.h> // for ystdex::any, ystdex::unchecked_any_cast;
 #include <ystdex/scope_guard.hpp> // for ystdex::unique_guard;
+#include YFM_YSLib_Core_YClock // for Timers::TimePoint;
+#include <chrono> // for std::chrono::nanoseconds;
+#if YF_Multithread == 1
+#	include <condition_variable> // for std::condition_variable_any;
+#endif
 
 namespace YSLib
 {
@@ -61,6 +66,27 @@ private:
 	\since build 551
 	*/
 	recursive_mutex queue_mutex{};
+#if YF_Multithread == 1
+	/*
+	\brief 主消息队列条件变量。
+	\sa WaitForMessage
+	\since build 799
+	*/
+	std::condition_variable_any queue_cond{};
+	/*
+	\brief 等待标记：指示是否有线程阻塞等待主消息队列。
+	\sa Post
+	\since build 800
+	*/
+	atomic<bool> waiting{};
+#endif
+	/*
+	\brief 唤醒请求标记。
+	\note 被主消息队列互斥锁保护。
+	\sa Wake
+	\since build 799
+	*/
+	bool wake_requested = {};
 
 protected:
 	/*
@@ -146,6 +172,21 @@ public:
 	}
 	//@}
 
+	/*!
+	\brief 若消息有效，以指定优先级无锁地发送消息至主消息队列。
+	\note 线程安全：不需要互斥访问主消息队列。
+	\note 仅当存在线程等待主消息队列时锁定以通知等待的线程。
+	\sa MessageQueue::PushConcurrent
+	\sa WaitForMessage
+	\since build 800
+	*/
+	//@{
+	void
+	Post(const Message&, Messaging::Priority);
+	void
+	Post(Message&&, Messaging::Priority);
+	//@}
+
 	/*!
 	\brief 处理消息：分发消息。
 	\pre 断言：当前 Shell 句柄有效。
@@ -180,6 +221,42 @@ public:
 	*/
 	PDefH(bool, Switch, shared_ptr<Shell>&& h) ynothrow
 		ImplRet(Switch(h))
+
+	/*!
+	\brief 等待主消息队列非空或被唤醒，至多阻塞指定的时间。
+	\return 主消息队列是否非空。
+	\note 线程安全：全局消息队列互斥访问。
+	\note 不支持多线程时不阻塞。
+	\warning 调用线程不应已持有主消息队列的锁，否则可能死锁。
+	\sa Wake
+	\since build 799
+
+	若唤醒请求标记被设置则立即返回，否则阻塞直至主消息队列非空、被唤醒或超时。
+	返回前清除唤醒请求标记。
+	*/
+	bool
+	WaitForMessage(std::chrono::nanoseconds);
+
+	/*!
+	\brief 请求在不晚于指定时刻唤醒空闲的消息循环。
+	\note 默认实现为空：消息循环不阻塞等待。
+	\sa GUIApplication::RequestWakeUp
+	\since build 823
+
+	用于不通过消息队列部署且需要按时检查的计时器等状态。
+	*/
+	virtual void
+	RequestWakeUp(Timers::TimePoint);
+
+	/*!
+	\brief 设置唤醒请求标记并唤醒等待主消息队列的线程。
+	\note 线程安全：全局消息队列互斥访问。
+	\note 用于通知消息队列以外的事件源（如宿主窗口消息）的状态改变。
+	\sa WaitForMessage
+	\since build 799
+	*/
+	void
+	Wake();
 };
 
 
@@ -221,11 +298,16 @@ yconstexpr const Messaging::Priority DefaultQuitPriority(0xF0);
 \brief 全局默认队列消息发送函数。
 \exception LoggedEvent 找不到全局应用程序实例或消息发送失败。
 \note 线程安全。
+\note 发送后唤醒等待主消息队列的线程。
+\sa Application::Post
 \since build 550
 */
 //@{
 YF_API void
 PostMessage(const Message&, Messaging::Priority);
+//! \since build 800
+YF_API void
+PostMessage(Message&&, Messaging::Priority);
 inline PDefH(void, PostMessage, Messaging::ID id, Messaging::Priority prior,
 	const ValueObject& vo = {})
 	ImplRet(PostMessage(Message(id, vo), prior))
@@ -241,6 +323,16 @@ PostMessage(Messaging::Priority prior,
 }
 //@}
 
+/*!
+\brief 请求全局应用程序实例的消息循环在不晚于指定时刻唤醒。
+\note 线程安全。
+\note 忽略找不到全局应用程序实例或请求失败的异常。
+\sa Application::RequestWakeUp
+\since build 823
+*/
+YF_API void
+RequestWakeUp(Timers::TimePoint) ynothrow;
+
 /*!
 \brief 以指定错误码和优先级发起 Shell 终止请求。
 \since build 696
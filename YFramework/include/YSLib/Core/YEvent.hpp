@@ -11,13 +11,13 @@
 /*!	\file YEvent.hpp
 \ingroup Core
 \brief 事件回调。
-\version r5301
+\version r5330
 \author FrankHB <frankhb1989@gmail.com>
 \since build 560
 \par 创建时间:
 	2010-04-23 23:08:23 +0800
 \par 修改时间:
-	2017-06-04 23:55 +0800
+	2017-08-05 17:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -32,11 +32,13 @@
 #include YFM_YSLib_Core_YObject // for ystdex::examiners::equal_examiner;
 #include YFM_YSLib_Core_YFunc
 #include <ystdex/iterator.hpp> // for ystdex::get_value;
-#include <ystdex/container.hpp> // for ystdex::erase_all_if;
+#include <ystdex/algorithm.hpp> // for std::count_if, std::upper_bound,
+//	std::rotate, std::remove_if;
+#include <ystdex/scope_guard.hpp> // for ystdex::make_guard;
 #include <ystdex/base.h> // for ystdex::cloneable;
 #include <ystdex/operators.hpp> // for ystdex::equality_comparable;
 #include <ystdex/functional.hpp> // for ystdex::make_expanded,
-//	ystdex::default_last_value;
+//	ystdex::default_last_value, ystdex::invoke;
 #include <ystdex/optional.h> // for ystdex::optional_last_value;
 
 namespace YSLib
@@ -67,16 +69,22 @@ GIHEvent<_tParams...>::DefDeDtor(GIHEvent)
 template<typename>
 class GHEvent;
 
-//! \warning 非虚析构。
+/*!
+\note 使用内部存储保存可调用对象，较小的对象不分配存储。
+\warning 非虚析构。
+*/
 template<typename _tRet, typename... _tParams>
 class GHEvent<_tRet(_tParams...)>
-	: protected std::function<_tRet(_tParams...)>,
-	private ystdex::equality_comparable<GHEvent<_tRet(_tParams...)>>,
+	: private ystdex::equality_comparable<GHEvent<_tRet(_tParams...)>>,
 	private ystdex::equality_comparable<GHEvent<_tRet(_tParams...)>, nullptr_t>
 {
 public:
 	using TupleType = tuple<_tParams...>;
 	using FuncType = _tRet(_tParams...);
+	/*!
+	\brief 兼容的基础函数包装类型。
+	\note 仅用于检查构造参数的兼容性，不作为实现中的存储类型。
+	*/
 	using BaseType = std::function<FuncType>;
 
 private:
@@ -108,7 +116,175 @@ private:
 				Deref(y.template target<Decayed>()));
 		}
 	};
+	//! \since build 801
+	//@{
+	/*!
+	\brief 内部存储类型。
+	\note 大小足够保存 4 个指针，可直接保存通常的函数指针、成员函数指针、
+		绑定对象和引用捕获的 lambda 表达式。
+	*/
+	using Storage = ystdex::aligned_storage_t<yimpl(4 * sizeof(void*))>;
+	//! \brief 管理操作。
+	enum class Operation
+	{
+		Copy,
+		Move,
+		Destroy,
+		Access,
+		Type
+	};
+	//! \brief 调用函数类型。
+	using Invoker = _tRet(*)(Storage&, _tParams&&...);
+	/*!
+	\brief 管理函数类型。
+	\note 对 Copy 和 Move 操作，第二参数为目标，第三参数为源；
+		对其它操作仅使用第二参数。
+	*/
+	using Manager = void*(*)(Operation, Storage&, Storage&);
 
+	/*!
+	\brief 可调用对象的存储策略。
+	\note 不抛出异常转移且大小和对齐要求适合的对象内联保存，否则动态分配。
+	*/
+	template<typename _func>
+	struct GHolder
+	{
+		static yconstexpr const bool IsLocal = sizeof(_func) <= sizeof(Storage)
+			&& yalignof(Storage) % yalignof(_func) == 0
+			&& std::is_nothrow_move_constructible<_func>::value;
+
+		static _func&
+		Access(Storage& s) ynothrow
+		{
+			return Access(s, ystdex::bool_<IsLocal>());
+		}
+		static _func&
+		Access(Storage& s, ystdex::true_) ynothrow
+		{
+			return *static_cast<_func*>(static_cast<void*>(&s));
+		}
+		static _func&
+		Access(Storage& s, ystdex::false_) ynothrow
+		{
+			return Deref(*static_cast<_func**>(static_cast<void*>(&s)));
+		}
+
+		template<typename... _tInitParams>
+		static void
+		Init(Storage& s, _tInitParams&&... args)
+		{
+			Init(ystdex::bool_<IsLocal>(), s, yforward(args)...);
+		}
+		template<typename... _tInitParams>
+		static void
+		Init(ystdex::true_, Storage& s, _tInitParams&&... args)
+		{
+			::new(static_cast<void*>(&s)) _func(yforward(args)...);
+		}
+		template<typename... _tInitParams>
+		static void
+		Init(ystdex::false_, Storage& s, _tInitParams&&... args)
+		{
+			::new(static_cast<void*>(&s)) _func*(new _func(yforward(args)...));
+		}
+
+		static _tRet
+		Invoke(Storage& s, _tParams&&... args)
+		{
+			return static_cast<_tRet>(
+				ystdex::invoke(Access(s), yforward(args)...));
+		}
+
+		static void*
+		Manage(Operation op, Storage& x, Storage& y)
+		{
+			switch(op)
+			{
+			case Operation::Copy:
+				Init(y, ystdex::as_const(Access(x)));
+				break;
+			case Operation::Move:
+				Move(x, y, ystdex::bool_<IsLocal>());
+				break;
+			case Operation::Destroy:
+				Destroy(x, ystdex::bool_<IsLocal>());
+				break;
+			case Operation::Access:
+				return std::addressof(Access(x));
+			case Operation::Type:
+				return const_cast<std::type_info*>(&typeid(_func));
+			}
+			return {};
+		}
+
+		static void
+		Destroy(Storage& s, ystdex::true_) ynothrow
+		{
+			Access(s).~_func();
+		}
+		static void
+		Destroy(Storage& s, ystdex::false_) ynothrow
+		{
+			delete std::addressof(Access(s));
+		}
+
+		static void
+		Move(Storage& x, Storage& y, ystdex::true_) ynothrow
+		{
+			Init(y, std::move(Access(x)));
+			Destroy(x, ystdex::true_());
+		}
+		static void
+		Move(Storage& x, Storage& y, ystdex::false_) ynothrow
+		{
+			::new(static_cast<void*>(&y)) _func*(std::addressof(Access(x)));
+		}
+	};
+
+	/*!
+	\brief 判断可调用对象是否为空值。
+	\note 空的函数指针、成员指针和 std::function 对象构造空的事件处理器。
+	*/
+	//@{
+	template<typename _type>
+	static yconstfn bool
+	IsNull(const _type&) ynothrow
+	{
+		return {};
+	}
+	template<typename _type>
+	static yconstfn bool
+	IsNull(_type* p) ynothrow
+	{
+		return !p;
+	}
+	template<typename _type, class _tClass>
+	static yconstfn bool
+	IsNull(_type _tClass::* p) ynothrow
+	{
+		return !p;
+	}
+	template<typename _tSig>
+	static bool
+	IsNull(const std::function<_tSig>& f) ynothrow
+	{
+		return !f;
+	}
+	//@}
+
+	/*!
+	\brief 存储的可调用对象。
+	\note 调用时作为非 const 左值，和 std::function 一致。
+	*/
+	mutable Storage storage;
+	/*!
+	\brief 调用函数。
+	\note 空值表示事件处理器为空。
+	*/
+	Invoker invoker = {};
+	//! \invariant <tt>bool(invoker) == bool(manager)</tt> 。
+	Manager manager = {};
+	//@}
 	/*!
 	\brief 比较函数：相等关系。
 	\invariant comp_eq
@@ -120,35 +296,36 @@ public:
 	\brief 构造：使用函数指针。
 	\since build 516
 	*/
-	yconstfn
 	GHEvent(FuncType* f = {})
-		: BaseType(f), comp_eq(GEquality<FuncType>::AreEqual)
-	{}
+		: comp_eq(GEquality<FuncType>::AreEqual)
+	{
+		Init(f);
+	}
 	/*!
 	\brief 使用函数对象。
 	\since build 494
 	*/
 	template<class _fCallable>
-	yconstfn
 	GHEvent(_fCallable f, ystdex::enable_if_t<
 		std::is_constructible<BaseType, _fCallable>::value, int> = 0)
-		: BaseType(f),
-		comp_eq(GEquality<ystdex::decay_t<_fCallable>>::AreEqual)
-	{}
+		: comp_eq(GEquality<ystdex::decay_t<_fCallable>>::AreEqual)
+	{
+		Init(std::move(f));
+	}
 	/*!
 	\brief 使用扩展函数对象。
 	\since build 447
 	\todo 推断比较相等操作。
 	*/
 	template<class _fCallable>
-	yconstfn
 	GHEvent(_fCallable&& f, ystdex::enable_if_t<
 		!std::is_constructible<BaseType, _fCallable>::value, int> = 0)
-		: BaseType(ystdex::make_expanded<_tRet(_tParams...)>(yforward(f))),
-		comp_eq([](const GHEvent&, const GHEvent&) ynothrow{
+		: comp_eq([](const GHEvent&, const GHEvent&) ynothrow{
 			return true;
 		})
-	{}
+	{
+		Init(ystdex::make_expanded<_tRet(_tParams...)>(yforward(f)));
+	}
 	/*!
 	\brief 构造：使用对象引用和成员函数指针。
 	\warning 使用空成员指针构造的函数对象调用引起未定义行为。
@@ -163,7 +340,38 @@ public:
 			return (obj.*pm)(yforward(args)...);
 		})
 	{}
-	DefDeCopyMoveCtorAssignment(GHEvent)
+	//! \since build 801
+	//@{
+	GHEvent(const GHEvent& h)
+		: invoker(h.invoker), manager(h.manager), comp_eq(h.comp_eq)
+	{
+		if(manager)
+			manager(Operation::Copy, h.storage, storage);
+	}
+	GHEvent(GHEvent&& h) ynothrow
+		: comp_eq(h.comp_eq)
+	{
+		Take(h);
+	}
+	~GHEvent()
+	{
+		Reset();
+	}
+
+	PDefHOp(GHEvent&, =, const GHEvent& h)
+		ImplRet(*this = GHEvent(h))
+	GHEvent&
+	operator=(GHEvent&& h) ynothrow
+	{
+		if(&h != this)
+		{
+			Reset();
+			comp_eq = h.comp_eq;
+			Take(h);
+		}
+		return *this;
+	}
+	//@}
 
 	//! \since build 520
 	friend yconstfn bool
@@ -178,17 +386,101 @@ public:
 			&& (!bool(x) || x.comp_eq(x, y));
 	}
 
-	//! \brief 调用。
-	using BaseType::operator();
+	/*!
+	\brief 调用。
+	\exception std::bad_function_call 事件处理器为空。
+	*/
+	_tRet
+	operator()(_tParams... args) const
+	{
+		if(invoker)
+			return invoker(storage, yforward(args)...);
+		throw std::bad_function_call();
+	}
 
 	//! \since build 516
-	using BaseType::operator bool;
+	explicit DefCvt(const ynothrow, bool, invoker)
 
+private:
+	//! \since build 801
+	//@{
+	template<typename _fCallable>
+	void
+	Init(_fCallable&& f)
+	{
+		using func_t = ystdex::decay_t<_fCallable>;
+		using holder_t = GHolder<func_t>;
+
+		if(!IsNull(f))
+		{
+			holder_t::Init(storage, yforward(f));
+			yunseq(invoker = holder_t::Invoke, manager = holder_t::Manage);
+		}
+	}
+
+	//! \pre 间接断言：参数不是 \c *this 。
+	void
+	Take(GHEvent& h) ynothrow
+	{
+		YAssert(&h != this, "Invalid self move found.");
+		if(h.manager)
+		{
+			h.manager(Operation::Move, h.storage, storage);
+			yunseq(invoker = h.invoker, manager = h.manager);
+			yunseq(h.invoker = {}, h.manager = {});
+		}
+	}
+
+	void
+	Reset() ynothrow
+	{
+		if(manager)
+		{
+			manager(Operation::Destroy, storage, storage);
+			yunseq(invoker = {}, manager = {});
+		}
+	}
+	//@}
+
+public:
 	//! \since build 773
-	using BaseType::target;
+	//@{
+	template<typename _type>
+	_type*
+	target() ynothrow
+	{
+		return target_type() == typeid(_type) ? static_cast<_type*>(
+			manager(Operation::Access, storage, storage)) : nullptr;
+	}
+	template<typename _type>
+	const _type*
+	target() const ynothrow
+	{
+		return target_type() == typeid(_type) ? static_cast<const _type*>(
+			manager(Operation::Access, storage, storage)) : nullptr;
+	}
+	//@}
 
 	//! \since build 748
-	using BaseType::target_type;
+	const std::type_info&
+	target_type() const ynothrow
+	{
+		return manager ? *static_cast<const std::type_info*>(
+			manager(Operation::Type, storage, storage)) : typeid(void);
+	}
+
+	/*!
+	\brief 交换。
+	\since build 801
+	*/
+	friend void
+	swap(GHEvent& x, GHEvent& y) ynothrow
+	{
+		auto t(std::move(x));
+
+		x = std::move(y);
+		y = std::move(t);
+	}
 };
 //@}
 
@@ -297,6 +589,547 @@ using GOptionalLastValueInvoker = GCombinerInvoker<ystdex::cond_t<std::is_void<
 
 
 
+/*!
+\brief 事件处理器列表。
+\note 按优先级降序排列的连续存储的序列容器；相同优先级的元素保持插入顺序。
+\note 内联保存首个元素，空列表和只有一个元素的列表不分配存储。
+\note 锁定遍历期间可插入和移除元素，不移动已有元素。
+\warning 未锁定时插入和移除元素可能使迭代器失效。
+\warning 非虚析构。
+\since build 801
+
+锁定遍历期间移除的元素被标记，迭代器跳过被标记的元素，解锁后销毁；
+	插入的元素被暂存，不被迭代器访问，也不计入大小，解锁后合并。
+*/
+template<class _tHandler>
+class GHandlerList
+{
+public:
+	using value_type = pair<EventPriority, _tHandler>;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using pointer = value_type*;
+	using const_pointer = const value_type*;
+	using size_type = size_t;
+	using difference_type = ptrdiff_t;
+
+	static_assert(std::is_nothrow_move_constructible<value_type>::value
+		&& std::is_nothrow_move_assignable<value_type>::value,
+		"Invalid handler type found.");
+
+private:
+	//! \since build 823
+	//@{
+	//! \brief 元素项：元素和锁定遍历期间被移除的标记。
+	struct Entry
+	{
+		value_type Value;
+		bool Removed = {};
+
+		template<typename... _tParams>
+		Entry(EventPriority prior, _tParams&&... args)
+			: Value(prior, yforward(args)...)
+		{}
+	};
+
+	//! \brief 迭代器：跳过被标记移除的元素。
+	template<typename _tEntry, typename _tValue>
+	class GIterator : public ystdex::bidirectional_iteratable<
+		GIterator<_tEntry, _tValue>, _tValue&>
+	{
+		friend class GHandlerList;
+		template<typename, typename>
+		friend class GIterator;
+
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = typename GHandlerList::value_type;
+		using difference_type = ptrdiff_t;
+		using pointer = _tValue*;
+		using reference = _tValue&;
+
+	private:
+		_tEntry* p_entry = {};
+		//! \brief 向后遍历跳过元素的边界。
+		_tEntry* p_end = {};
+
+	public:
+		DefDeCtor(GIterator)
+		GIterator(_tEntry* p, _tEntry* e) ynothrow
+			: p_entry(p), p_end(e)
+		{
+			Skip();
+		}
+		//! \brief 构造：从非 const 迭代器转换。
+		template<typename _tOther, typename _tOtherValue, yimpl(typename
+			= ystdex::enable_if_t<!std::is_same<_tEntry, _tOther>()>)>
+		GIterator(const GIterator<_tOther, _tOtherValue>& i) ynothrow
+			: p_entry(i.p_entry), p_end(i.p_end)
+		{}
+
+		PDefHOp(reference, *, ) const ynothrowv
+			ImplRet(YAssertNonnull(p_entry), p_entry->Value)
+
+		PDefHOp(GIterator&, ++, ) ynothrowv
+			ImplRet(YAssertNonnull(p_entry), ++p_entry, Skip(), *this)
+
+		GIterator&
+		operator--() ynothrowv
+		{
+			YAssertNonnull(p_entry);
+			do
+				--p_entry;
+			while(p_entry->Removed);
+			return *this;
+		}
+
+		friend PDefHOp(bool, ==, const GIterator& x, const GIterator& y)
+			ynothrow
+			ImplRet(x.p_entry == y.p_entry)
+
+	private:
+		void
+		Skip() ynothrow
+		{
+			while(p_entry != p_end && p_entry->Removed)
+				++p_entry;
+		}
+	};
+	//@}
+
+public:
+	using iterator = GIterator<Entry, value_type>;
+	using const_iterator = GIterator<const Entry, const value_type>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+	//! \brief 内联存储。
+	ystdex::aligned_storage_t<sizeof(Entry), yalignof(Entry)> local;
+	//! \brief 动态分配的存储：空指针表示使用内联存储。
+	Entry* p_heap = {};
+	//! \brief 动态分配的存储容量。
+	size_type heap_capacity = 0;
+	//! \brief 项数：包括被标记移除的元素。
+	size_type n = 0;
+	//! \since build 823
+	//@{
+	//! \brief 被标记移除的元素数。
+	size_type n_removed = 0;
+	//! \brief 遍历锁定计数。
+	mutable size_type n_locked = 0;
+	//! \brief 锁定遍历期间插入的暂存元素：按插入顺序排列。
+	unique_ptr<vector<Entry>> p_pending{};
+	//@}
+
+public:
+	/*!
+	\brief 无参数构造：得到空列表。
+	\note 不初始化内联存储。
+	*/
+	GHandlerList() ynothrow
+	{}
+	//! \note 复制未被标记移除的元素，暂存元素被合并。
+	GHandlerList(const GHandlerList& l)
+		: GHandlerList()
+	{
+		reserve(l.size());
+		for(const auto& pr : l)
+		{
+			::new(static_cast<void*>(data() + n)) Entry(pr.first, pr.second);
+			++n;
+		}
+		if(l.p_pending)
+			for(const auto& e : *l.p_pending)
+				Emplace(e.Value.first, e.Value.second);
+	}
+	//! \pre 断言：参数未被锁定遍历。
+	GHandlerList(GHandlerList&& l) ynothrowv
+	{
+		Take(l);
+	}
+	~GHandlerList()
+	{
+		Release();
+	}
+
+	PDefHOp(GHandlerList&, =, const GHandlerList& l)
+		ImplRet(*this = GHandlerList(l))
+	//! \pre 断言：对象和参数未被锁定遍历。
+	GHandlerList&
+	operator=(GHandlerList&& l) ynothrowv
+	{
+		if(&l != this)
+		{
+			YAssert(n_locked == 0, "Invalid locked list found.");
+			Release();
+			Take(l);
+		}
+		return *this;
+	}
+
+	PDefH(iterator, begin, ) ynothrow
+		ImplRet(iterator(data(), data() + n))
+	PDefH(const_iterator, begin, ) const ynothrow
+		ImplRet(const_iterator(data(), data() + n))
+
+	PDefH(const_iterator, cbegin, ) const ynothrow
+		ImplRet(begin())
+
+	PDefH(const_iterator, cend, ) const ynothrow
+		ImplRet(end())
+
+	PDefH(size_type, capacity, ) const ynothrow
+		ImplRet(p_heap ? heap_capacity : 1)
+
+	//! \note 锁定遍历期间标记所有元素为被移除。
+	void
+	clear() ynothrow
+	{
+		p_pending.reset();
+		if(n_locked == 0)
+		{
+			Destroy(0);
+			yunseq(n = 0, n_removed = 0);
+		}
+		else
+		{
+			std::for_each(data(), data() + n, [](Entry& e) ynothrow{
+				e.Removed = true;
+			});
+			n_removed = n;
+		}
+	}
+
+	//! \brief 取指定优先级的元素个数。
+	size_type
+	count(EventPriority prior) const ynothrow
+	{
+		return size_type(std::count_if(begin(), end(),
+			[=](const value_type& pr) ynothrow{
+			return pr.first == prior;
+		}));
+	}
+
+	PDefH(const_reverse_iterator, crbegin, ) const ynothrow
+		ImplRet(rbegin())
+
+	PDefH(const_reverse_iterator, crend, ) const ynothrow
+		ImplRet(rend())
+
+	/*!
+	\brief 插入元素：位于所有优先级不小于参数的元素之后。
+	\return 指向被插入元素的迭代器。
+	\note 锁定遍历期间插入的元素被暂存，返回的迭代器在解锁后失效。
+	\note 强异常安全保证。
+	*/
+	template<typename... _tParams>
+	iterator
+	emplace(EventPriority prior, _tParams&&... args)
+	{
+		if(n_locked != 0)
+		{
+			if(!p_pending)
+				p_pending.reset(new vector<Entry>());
+
+			auto& con(*p_pending);
+
+			con.emplace_back(prior, yforward(args)...);
+			return iterator(&con.back(), con.data() + con.size());
+		}
+		Merge();
+		return Emplace(prior, yforward(args)...);
+	}
+
+	PDefH(bool, empty, ) const ynothrow
+		ImplRet(size() == 0)
+
+	PDefH(iterator, end, ) ynothrow
+		ImplRet(iterator(data() + n, data() + n))
+	PDefH(const_iterator, end, ) const ynothrow
+		ImplRet(const_iterator(data() + n, data() + n))
+
+	//! \since build 823
+	//@{
+	/*!
+	\brief 锁定遍历。
+	\return 是否锁定：没有元素时遍历不访问元素，不需要锁定。
+	\note 未被锁定时先合并暂存元素。
+	*/
+	bool
+	Lock() const
+	{
+		// XXX: Only lists modified during traversal have pending elements,
+		//	so the list is not a const object.
+		if(n_locked == 0 && p_pending)
+			const_cast<GHandlerList&>(*this).Merge();
+		if(n != 0)
+		{
+			++n_locked;
+			return true;
+		}
+		return {};
+	}
+
+	/*!
+	\brief 解锁遍历。
+	\pre 断言：已锁定遍历。
+	\note 解除所有锁定时销毁被标记移除的元素并合并暂存元素。
+	*/
+	void
+	Unlock() const ynothrowv
+	{
+		YAssert(n_locked != 0, "Invalid unlocked list found.");
+		if(--n_locked == 0 && (n_removed != 0 || p_pending))
+		{
+			// XXX: Same to %Lock.
+			auto& l(const_cast<GHandlerList&>(*this));
+
+			l.Purge();
+			// NOTE: Elements failed to be merged are kept pending and merged
+			//	next time.
+			TryExpr(l.Merge())
+			CatchIgnore(...)
+		}
+	}
+	//@}
+
+	PDefH(reverse_iterator, rbegin, ) ynothrow
+		ImplRet(reverse_iterator(end()))
+	PDefH(const_reverse_iterator, rbegin, ) const ynothrow
+		ImplRet(const_reverse_iterator(end()))
+
+	/*!
+	\brief 移除满足谓词的元素，保持剩余元素的顺序。
+	\note 锁定遍历期间标记元素为被移除。
+	*/
+	template<typename _fPred>
+	void
+	remove_if(_fPred pred)
+	{
+		if(p_pending)
+		{
+			auto& con(*p_pending);
+
+			con.erase(std::remove_if(con.begin(), con.end(),
+				[&](const Entry& e){
+				return pred(e.Value);
+			}), con.end());
+		}
+		if(n_locked == 0)
+		{
+			const auto i(std::remove_if(data(), data() + n,
+				[&](const Entry& e){
+				return pred(e.Value);
+			}) - data());
+
+			Destroy(size_type(i));
+			n = size_type(i);
+		}
+		else
+			for(auto i(begin()); i != end(); ++i)
+				if(pred(*i))
+				{
+					i.p_entry->Removed = true;
+					++n_removed;
+				}
+	}
+
+	PDefH(reverse_iterator, rend, ) ynothrow
+		ImplRet(reverse_iterator(begin()))
+	PDefH(const_reverse_iterator, rend, ) const ynothrow
+		ImplRet(const_reverse_iterator(begin()))
+
+	//! \note 强异常安全保证。
+	void
+	reserve(size_type c)
+	{
+		if(c > capacity())
+		{
+			const auto p(std::allocator<Entry>().allocate(c));
+
+			MoveTo(p);
+			Deallocate();
+			yunseq(p_heap = p, heap_capacity = c);
+		}
+	}
+
+	//! \note 不计入被标记移除的元素和暂存元素。
+	PDefH(size_type, size, ) const ynothrow
+		ImplRet(n - n_removed)
+
+	//! \pre 断言：参数未被锁定遍历。
+	friend void
+	swap(GHandlerList& x, GHandlerList& y) ynothrowv
+	{
+		auto t(std::move(x));
+
+		x = std::move(y);
+		y = std::move(t);
+	}
+
+private:
+	PDefH(Entry*, data, ) ynothrow
+		ImplRet(p_heap ? p_heap
+			: static_cast<Entry*>(static_cast<void*>(&local)))
+	PDefH(const Entry*, data, ) const ynothrow
+		ImplRet(p_heap ? p_heap
+			: static_cast<const Entry*>(static_cast<const void*>(&local)))
+
+	//! \brief 销毁从参数指定的位置开始的元素。
+	void
+	Destroy(size_type i) ynothrow
+	{
+		for(auto p(data() + i); p != data() + n; ++p)
+			p->~Entry();
+	}
+
+	//! \brief 释放动态分配的存储。
+	void
+	Deallocate() ynothrow
+	{
+		if(p_heap)
+		{
+			std::allocator<Entry>().deallocate(p_heap, heap_capacity);
+			yunseq(p_heap = {}, heap_capacity = 0);
+		}
+	}
+
+	/*!
+	\brief 插入元素：不检查锁定。
+	\note 强异常安全保证。
+	\since build 823
+	*/
+	template<typename... _tParams>
+	iterator
+	Emplace(EventPriority prior, _tParams&&... args)
+	{
+		const auto p(data());
+		const auto i(std::upper_bound(p, p + n, prior,
+			[](EventPriority x, const Entry& e) ynothrow{
+			return x > e.Value.first;
+		}) - p);
+
+		if(n == capacity())
+		{
+			const auto c(n * 2);
+			const auto p_new(std::allocator<Entry>().allocate(c));
+
+			try
+			{
+				::new(static_cast<void*>(p_new + n))
+					Entry(prior, yforward(args)...);
+			}
+			catch(...)
+			{
+				std::allocator<Entry>().deallocate(p_new, c);
+				throw;
+			}
+			MoveTo(p_new);
+			Deallocate();
+			yunseq(p_heap = p_new, heap_capacity = c);
+		}
+		else
+			::new(static_cast<void*>(p + n)) Entry(prior, yforward(args)...);
+		++n;
+		std::rotate(data() + i, data() + n - 1, data() + n);
+		return iterator(data() + i, data() + n);
+	}
+
+	/*!
+	\brief 合并暂存元素。
+	\note 失败时未合并的元素保持暂存。
+	\since build 823
+	*/
+	void
+	Merge()
+	{
+		if(p_pending)
+		{
+			auto& con(*p_pending);
+			auto i(con.begin());
+
+			try
+			{
+				for(; i != con.end(); ++i)
+					Emplace(i->Value.first, std::move(i->Value.second));
+			}
+			catch(...)
+			{
+				con.erase(con.begin(), i);
+				throw;
+			}
+			p_pending.reset();
+		}
+	}
+
+	//! \brief 转移元素至参数指定的未初始化存储并销毁原有元素，不修改大小。
+	void
+	MoveTo(Entry* p) ynothrow
+	{
+		for(auto q(data()); q != data() + n; ++q)
+		{
+			::new(static_cast<void*>(p++)) Entry(std::move(*q));
+			q->~Entry();
+		}
+	}
+
+	/*!
+	\brief 销毁被标记移除的元素。
+	\since build 823
+	*/
+	void
+	Purge() ynothrow
+	{
+		if(n_removed != 0)
+		{
+			const auto i(std::remove_if(data(), data() + n,
+				[](const Entry& e) ynothrow{
+				return e.Removed;
+			}) - data());
+
+			Destroy(size_type(i));
+			yunseq(n = size_type(i), n_removed = 0);
+		}
+	}
+
+	//! \brief 销毁所有元素并释放动态分配的存储。
+	void
+	Release() ynothrow
+	{
+		p_pending.reset();
+		Destroy(0);
+		yunseq(n = 0, n_removed = 0);
+		Deallocate();
+	}
+
+	/*!
+	\pre 对象不持有元素和动态分配的存储。
+	\pre 断言：参数未被锁定遍历。
+	*/
+	void
+	Take(GHandlerList& l) ynothrowv
+	{
+		YAssert(l.n_locked == 0, "Invalid locked list found.");
+		l.Purge();
+		p_pending = std::move(l.p_pending);
+		if(l.p_heap)
+		{
+			yunseq(p_heap = l.p_heap, heap_capacity = l.heap_capacity,
+				n = l.n);
+			yunseq(l.p_heap = {}, l.heap_capacity = 0, l.n = 0);
+		}
+		else if(l.n != 0)
+		{
+			::new(static_cast<void*>(data())) Entry(std::move(*l.data()));
+			l.Destroy(0);
+			l.n = 0;
+			n = 1;
+		}
+	}
+};
+
+
 /*!
 \brief 事件模板。
 \note 支持顺序多播。
@@ -321,10 +1154,9 @@ public:
 	//@}
 	/*!
 	\brief 容器类型。
-	\since build 294
+	\since build 801
 	*/
-	using ContainerType
-		= multimap<EventPriority, HandlerType, std::greater<EventPriority>>;
+	using ContainerType = GHandlerList<HandlerType>;
 	//! \since build 675
 	using InvokerType = _tInvoker;
 	//! \since build 573
@@ -426,8 +1258,7 @@ public:
 	GEvent&
 	operator-=(const HandlerType& h)
 	{
-		ystdex::erase_all_if<ContainerType>(handlers, handlers.cbegin(),
-			handlers.cend(), [&](decltype(*handlers.cbegin()) pr){
+		handlers.remove_if([&](const value_type& pr){
 			return pr.second == h;
 		});
 		return *this;
@@ -488,6 +1319,8 @@ public:
 	/*!
 	\brief 插入事件响应。
 	\note 不检查是否已经在列表中。
+	\warning 返回的迭代器在下一次添加或移除事件响应前有效；
+		调用期间插入时在调用结束后失效。
 	\since build 572
 	*/
 	//@{
@@ -553,11 +1386,29 @@ public:
 
 	/*!
 	\brief 调用：传递参数到调用器。
+	\note 调用期间锁定遍历，事件处理器可添加和移除事件响应。
+	\sa GHandlerList
 	\since build 675
+
+	调用期间移除的事件响应不再被调用；添加的事件响应在调用结束后可见。
 	*/
-	PDefHOp(result_type, (), _tParams... args) const
-		ImplRet(Invoker(handlers.cbegin() | ystdex::get_value,
-			handlers.cend() | ystdex::get_value, yforward(args)...))
+	result_type
+	operator()(_tParams... args) const
+	{
+		using ystdex::get_value;
+
+		if(handlers.Lock())
+		{
+			const auto gd(ystdex::make_guard([this]() ynothrow{
+				handlers.Unlock();
+			}));
+
+			return Invoker(handlers.cbegin() | get_value,
+				handlers.cend() | get_value, yforward(args)...);
+		}
+		return Invoker(handlers.cend() | get_value, handlers.cend()
+			| get_value, yforward(args)...);
+	}
 
 	//! \since build 573
 	PDefH(const_iterator, cbegin, ) const ynothrow
@@ -617,7 +1468,7 @@ public:
 	\since build 710
 	*/
 	friend PDefH(void, swap, GEvent& x, GEvent& y) ynothrow
-		ImplRet(x.handlers.swap(y.handlers))
+		ImplRet(swap(x.handlers, y.handlers))
 };
 //@}
 //@}
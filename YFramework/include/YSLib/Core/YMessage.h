@@ -11,13 +11,13 @@
 /*!	\file YMessage.h
 \ingroup Core
 \brief 消息处理。
-\version r2042
+\version r2058
 \author FrankHB <frankhb1989@gmail.com>
 \since build 586
 \par 创建时间:
 	2009-12-06 02:44:31 +0800
 \par 修改时间:
-	2017-02-20 17:43 +0800
+	2017-07-20 09:17 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -31,6 +31,7 @@
 #include "YModules.h"
 #include YFM_YSLib_Core_YObject
 #include <ctime>
+#include <climits> // for CHAR_BIT;
 
 namespace YSLib
 {
@@ -147,41 +148,133 @@ public:
 
 /*!
 \brief 消息队列。
-\note 使用 multiset 模拟。
+\note 每个优先级使用一个先进先出的桶，以位图查找最高优先级的非空桶。
+\note 除 PushConcurrent 外，修改操作需要调用者保证互斥访问。
+\note 队列节点被回收至节点池中复用。
 \warning 非虚析构。
 \since build 211
+
+优先级较大的消息先被取出；相同优先级的消息按插入顺序取出。
+通过 PushConcurrent 插入的消息先被保存至无锁的多生产者单消费者栈中，
+	在消费者的下一次访问时按插入顺序转移至对应的桶中。
 */
-class YF_API MessageQueue : private noncopyable,
-	private multimap<Priority, Message, std::greater<Priority>>
+class YF_API MessageQueue : private noncopyable, private nonmovable
 {
 public:
-	//! \since build 449
-	using BaseType = multimap<Priority, Message, std::greater<Priority>>;
 	/*!
-	\brief 迭代器。
-	\since build 460
+	\brief 队列节点。
+	\since build 800
+	*/
+	struct Node;
+
+private:
+	/*!
+	\brief 位图中的字类型。
+	\since build 800
+	*/
+	using BitmapWord = std::uint64_t;
+
+public:
+	/*!
+	\brief 优先级的数量。
+	\since build 800
 	*/
+	static yconstexpr const size_t PriorityCount = size_t(1) << CHAR_BIT;
+	/*!
+	\brief 消费者保留的空闲节点的最大数量。
+	\since build 800
+	*/
+	static yconstexpr const size_t MaxPooledNodes = 256;
+
+private:
+	/*!
+	\brief 位图中的字数。
+	\since build 800
+	*/
+	static yconstexpr const size_t BitmapSize
+		= PriorityCount / (sizeof(BitmapWord) * CHAR_BIT);
+
+	//! \since build 800
 	//@{
-	using BaseType::iterator;
-	using BaseType::const_iterator;
+	//! \brief 桶：先进先出的单链表。
+	struct Bucket
+	{
+		Node* Head = {};
+		Node* Tail = {};
+	};
+
+	/*!
+	\brief 桶和非空桶的位图。
+	\note 允许被逻辑上不修改队列的 const 成员函数在转移消息时修改。
+	*/
+	//@{
+	mutable array<Bucket, PriorityCount> buckets{};
+	mutable array<BitmapWord, BitmapSize> bitmap{};
+	//! \brief 桶中的消息数。
+	mutable size_t bucket_size = 0;
+	//@}
+	//! \brief 并发插入的节点栈，以插入顺序的逆序链接。
+	mutable atomic<Node*> incoming{};
+	//! \brief 消费者回收的空闲节点。
+	mutable Node* free_nodes = {};
+	//! \brief 消费者回收的空闲节点数。
+	mutable size_t free_count = 0;
+	//! \brief 提供给并发插入的生产者的空闲节点栈。
+	mutable atomic<Node*> spare_nodes{};
 	//@}
 
+public:
 	/*!
 	\brief 无参数构造：默认实现。
 	*/
 	DefDeCtor(MessageQueue)
-	DefDeDtor(MessageQueue)
+	//! \brief 析构：释放所有节点。
+	~MessageQueue();
+
+	/*!
+	\brief 判断消息队列是否为空。
+	\note 线程安全：可和 PushConcurrent 并发调用。
+	\since build 800
+	*/
+	bool
+	empty() const ynothrow;
 
 	/*!
 	\brief 取消息队列中消息的最大优先级。
 	\return 若消息队列为空则 0 ，否则为最大优先级。
 	\since build 288
 	*/
-	DefGetter(const ynothrow, Priority, MaxPriority,
-		empty() ? 0 : cbegin()->first)
+	Priority
+	GetMaxPriority() const ynothrow;
+
+	/*!
+	\brief 清除所有消息。
+	\since build 800
+	*/
+	void
+	clear() ynothrow;
 
+private:
+	/*!
+	\brief 转移并发插入的消息至桶中。
+	\since build 800
+	*/
+	void
+	Collect() const ynothrow;
+
+	/*!
+	\brief 插入节点至桶中。
+	\pre 参数非空。
+	\since build 800
+	*/
+	void
+	Link(Node*) const ynothrow;
+
+public:
 	/*!
 	\brief 合并消息队列：移动指定消息队列中的所有消息至此消息队列中。
+	\note 相同优先级的消息保持原有顺序并位于此消息队列中的已有消息之后。
+	\note 忽略无效的消息。
 	*/
 	void
 	Merge(MessageQueue&);
@@ -200,6 +293,14 @@ public:
 	*/
 	void
 	Pop();
+	/*!
+	\brief 从消息队列中移出优先级最高的消息至参数中。
+	\return 被移出的消息的优先级。
+	\pre 断言：消息队列非空。
+	\since build 800
+	*/
+	Priority
+	Pop(Message&) ynothrowv;
 
 	/*!
 	\brief 若消息有效，以指定优先级插入至消息队列中。
@@ -215,42 +316,50 @@ public:
 	Push(Message&&, Priority);
 
 	/*!
-	\brief 移除不大于指定优先级的消息。
-	\since build 320
+	\brief 若消息有效，以指定优先级无锁地插入至消息队列中。
+	\note 线程安全：可和其它 PushConcurrent 及消费者的任意操作并发调用。
+	\note 优先使用当前线程缓存的空闲节点。
+	\since build 800
 	*/
-	void
-	Remove(Priority);
-
-	//! \since build 449
 	//@{
-	using BaseType::begin;
-
-	using BaseType::cbegin;
-
-	using BaseType::cend;
-
-	using BaseType::clear;
-
-	using BaseType::crbegin;
-
-	using BaseType::crend;
-
-	using BaseType::empty;
-
-	using BaseType::end;
-
-	using BaseType::erase;
-
-	using BaseType::insert;
+	void
+	PushConcurrent(const Message&, Priority);
+	void
+	PushConcurrent(Message&&, Priority);
+	//@}
 
-	using BaseType::max_size;
+private:
+	/*!
+	\brief 回收节点。
+	\pre 参数非空且不在任何链表中。
+	\since build 800
+	*/
+	void
+	Recycle(Node*) const ynothrow;
 
-	using BaseType::rbegin;
+public:
+	/*!
+	\brief 移除小于指定优先级的消息。
+	\since build 320
+	*/
+	void
+	Remove(Priority);
 
-	using BaseType::rend;
+	/*!
+	\brief 取消息数。
+	\since build 800
+	*/
+	size_t
+	size() const ynothrow;
 
-	using BaseType::size;
-	//@}
+private:
+	/*!
+	\brief 从桶中断开优先级最高的节点。
+	\pre 桶非空。
+	\since build 800
+	*/
+	Node*
+	Unlink() ynothrow;
 };
 
 
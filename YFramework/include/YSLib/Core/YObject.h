@@ -11,13 +11,13 @@
 /*!	\file YObject.h
 \ingroup Core
 \brief 平台无关的基础对象。
-\version r4922
+\version r4934
 \author FrankHB <frankhb1989@gmail.com>
 \since build 561
 \par 创建时间:
 	2009-11-16 20:06:58 +0800
 \par 修改时间:
-	2017-06-08 16:55 +0800
+	2017-07-23 16:12 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -31,7 +31,8 @@
 #include "YModules.h"
 #include YFM_YSLib_Core_YCoreUtilities // for ystdex::copy_or_move;
 #include <ystdex/any.h> // for ystdex::any_ops::holder, ystdex::boxed_value,
-//	ystdex::any, ystdex::is_sharing, ystdex::pseudo_output;
+//	ystdex::any_ops::basic_any_storage, ystdex::basic_any, ystdex::is_sharing,
+//	ystdex::pseudo_output;
 #include <ystdex/examiner.hpp> // for ystdex::examiners::equal_examiner;
 #include <ystdex/operators.hpp> // for ystdex::equality_comparable;
 
@@ -77,21 +78,40 @@ struct HasOwnershipOf : std::is_base_of<OwnershipTag<_type>, _tOwner>
 {};
 
 
+//! \since build 802
+//@{
+/*!
+\brief 值类型对象的内部存储。
+\note 大小足以直接保存持有 string 或 shared_ptr 值的持有者，不需要动态分配。
+\sa ValueObject
+*/
+using ValueStorage = ystdex::any_ops::basic_any_storage<yimpl(sizeof(void*)
+	+ (sizeof(string) < sizeof(shared_ptr<void>) ? sizeof(shared_ptr<void>)
+	: sizeof(string)))>;
+
+/*!
+\brief 使用值类型对象的内部存储的动态泛型对象。
+\sa ValueObject
+*/
+using ValueContent = ystdex::basic_any<ValueStorage>;
+//@}
+
+
 /*!
 \brief 第一个参数指定的选项创建擦除类型的持有者或抛出异常。
 \since build 764
 */
 //@{
 template<class _tHolder, typename... _tParams>
-ystdex::any
+ValueContent
 CreateHolderInPlace(ystdex::true_, _tParams&&... args)
 {
-	return ystdex::any(ystdex::any_ops::use_holder,
+	return ValueContent(ystdex::any_ops::use_holder,
 		ystdex::in_place<_tHolder>, yforward(args)...);
 }
 //! \exception ystdex::invalid_construction 参数类型无法用于初始化持有者。
 template<class _tHolder, typename... _tParams>
-YB_NORETURN ystdex::any
+YB_NORETURN ValueContent
 CreateHolderInPlace(ystdex::false_, _tParams&&...)
 {
 	ystdex::throw_invalid_construction();
@@ -169,14 +189,14 @@ DeclDerivedI(YF_API, IValueHolder, ystdex::any_ops::holder)
 	派生实现应保证返回的值满足选项指定的条件，且变换不改变当前逻辑状态，
 	除 mutable 的数据成员可被转移；否则，应抛出异常。
 	*/
-	DeclIEntry(ystdex::any Create(Creation) const)
+	DeclIEntry(ValueContent Create(Creation) const)
 
 	/*!
 	\brief 提供创建持有者的默认实现。
 	\sa Create
 	*/
 	template<typename _type>
-	static ystdex::any
+	static ValueContent
 	CreateHolder(Creation, _type&);
 	//@}
 EndDecl
@@ -269,7 +289,7 @@ public:
 	DefDeCopyMoveCtorAssignment(ValueHolder)
 
 	//! \since build 761
-	PDefH(ystdex::any, Create, Creation c) const ImplI(IValueHolder)
+	PDefH(ValueContent, Create, Creation c) const ImplI(IValueHolder)
 		ImplRet(CreateHolder(c, this->value))
 
 	//! \since build 752
@@ -412,7 +432,7 @@ public:
 	DefGetter(ynothrow, const holder_pointer&, Held, p_held)
 
 	//! \since build 761
-	ystdex::any
+	ValueContent
 	Create(Creation c) const ImplI(IValueHolder)
 	{
 		if(shared() && c == IValueHolder::Copy)
@@ -480,7 +500,7 @@ public:
 	DefDeCopyMoveCtorAssignment(RefHolder)
 
 	//! \since build 761
-	PDefH(ystdex::any, Create, Creation c) const ImplI(IValueHolder)
+	PDefH(ValueContent, Create, Creation c) const ImplI(IValueHolder)
 		ImplRet(CreateHolder(c, Ref()))
 
 	//! \since build 752
@@ -507,7 +527,7 @@ public:
 //@}
 
 template<typename _type>
-ystdex::any
+ValueContent
 IValueHolder::CreateHolder(Creation c, _type& obj)
 {
 	switch(c)
@@ -543,7 +563,7 @@ public:
 	\brief 储存的内容。
 	\since build 748
 	*/
-	using Content = ystdex::any;
+	using Content = ValueContent;
 
 private:
 	//! \since build 748
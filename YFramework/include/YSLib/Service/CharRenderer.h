@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2015 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file CharRenderer.h
 \ingroup Service
 \brief 字符渲染。
-\version r2916
+\version r2918
 \author FrankHB <frankhb1989@gmail.com>
 \since build 275
 \par 创建时间:
 	2009-11-13 00:06:05 +0800
 \par 修改时间:
-	2015-10-02 20:30 +0800
+	2017-08-02 23:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -32,6 +32,7 @@
 #include YFM_YSLib_Service_TextBase
 #include YFM_YSLib_Service_YBlit
 #include <cwctype>
+#include <ystdex/cache.hpp> // for ystdex::recent_used_list;
 
 namespace YSLib
 {
@@ -127,6 +128,103 @@ RenderCharAlpha(PaintContext&& pc, Color, bool, CharBitmap::BufferType,
 	CharBitmap::FormatType, const Size&, AlphaType*);
 
 
+/*!
+\brief 字形缓存：保存按需光栅化并展开为 8 位覆盖值的字形。
+\warning 非线程安全。
+\warning 被缓存的字型被销毁后应清除缓存。
+\since build 821
+
+以字型、大小、样式和字符为键缓存字形的覆盖掩码和度量，
+	使重复渲染相同的字符时不需要再次查找字形和解包位图。
+缓存的字节数超过容量时按最近最少使用的顺序移除项。
+*/
+class YF_API GlyphCache final : private noncopyable
+{
+public:
+	struct Key
+	{
+		const Typeface* TypefacePtr;
+		FontSize Size;
+		FontStyle Style;
+		char32_t Character;
+
+		friend PDefHOp(bool, ==, const Key& x, const Key& y) ynothrow
+			ImplRet(x.TypefacePtr == y.TypefacePtr && x.Size == y.Size
+				&& x.Style == y.Style && x.Character == y.Character)
+	};
+
+	struct KeyHash
+	{
+		PDefHOp(size_t, (), const Key& key) const ynothrow
+			ImplRet(ystdex::hash_combine_seq(size_t(key.Style), key.Size,
+				key.Character, key.TypefacePtr))
+	};
+
+	/*!
+	\brief 覆盖掩码。
+	\note 覆盖值和 CharBitmap::Gray 格式的位图相同，行序和原始位图相同。
+	\note 不可打印或不支持格式的字形的覆盖值为空，仅保留度量。
+	*/
+	struct Mask
+	{
+		vector<AlphaType> Coverage{};
+		SDst Width = 0, Height = 0;
+		SPos Left = 0, Top = 0, XAdvance = 0;
+		//! \brief 指定交换行渲染顺序。
+		bool NegativePitch = {};
+	};
+
+	/*!
+	\brief 默认容量。
+	\note 单位为字节。
+	*/
+	static yconstexpr const size_t DefaultMaxSize = yimpl(256U << 10);
+
+private:
+	using ListType = ystdex::recent_used_list<Key, Mask>;
+
+	ListType used_list{};
+	unordered_map<Key, ListType::iterator, KeyHash> used_cache{};
+	size_t max_size;
+	size_t used_size = 0;
+
+public:
+	explicit
+	GlyphCache(size_t = DefaultMaxSize);
+
+	//! \brief 取容量。
+	DefGetter(const ynothrow, size_t, MaxSize, max_size)
+	//! \brief 取缓存项数。
+	DefGetter(const ynothrow, size_t, Count, used_cache.size())
+	//! \brief 取缓存项估计占用的字节数。
+	DefGetter(const ynothrow, size_t, UsedSize, used_size)
+
+	/*!
+	\brief 设置容量。
+	\note 超出新的容量时立即移除项。
+	*/
+	void
+	SetMaxSize(size_t) ynothrow;
+
+	void
+	Clear() ynothrow;
+
+	/*!
+	\brief 查找指定字体中字符的覆盖掩码。
+	\return 不存在字形时为空指针，否则为指向缓存项的指针。
+	\note 若缓存中不存在，调用 Font::GetGlyph 取字形并展开后插入缓存。
+	\note 返回的指针在下一次调用非 const 成员函数前保持有效。
+	*/
+	observer_ptr<const Mask>
+	Lookup(const Font&, char32_t);
+
+private:
+	//! \brief 按最近最少使用的顺序移除项，直至可以再容纳指定字节数。
+	void
+	Shrink(size_t = 0) ynothrow;
+};
+
+
 /*!
 \brief 取文本渲染器的行末位置（横坐标）。
 \since build 587
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2010-2016 FrankHB.
+	© 2010-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file FileSystem.h
 \ingroup Service
 \brief 平台中立的文件系统抽象。
-\version r3280
+\version r3284
 \author FrankHB <frankhb1989@gmail.com>
 \since build 473
 \par 创建时间:
 	2010-03-28 00:09:28 +0800
 \par 修改时间:
-	2016-09-23 22:13 +0800
+	2017-07-24 15:02 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -32,6 +32,10 @@
 #include YFM_YSLib_Service_File // for Remove;
 #include YFM_YSLib_Core_YString
 #include <ystdex/path.hpp> // for ystdex::path;
+#if YF_Multithread == 1
+#	include <atomic> // for std::atomic;
+#	include <ystdex/concurrency.h> // for ystdex::task_pool;
+#endif
 
 namespace YSLib
 {
@@ -688,6 +692,114 @@ TraverseTree(_func f, const Path& dst, const Path& src, _tParams&&... args)
 	});
 }
 
+#if YF_Multithread == 1
+/*!
+\brief 使用任务池并发递归遍历目录树。
+\note 在调用线程中遍历并创建目录，在任务池中以目标和源路径调用函数处理文件。
+\note 任务池的队列长度限制了未完成的任务数。
+\note 函数在每次提交任务时被复制，应可在不同线程中并发调用。
+\note 处理失败后不提交新的任务，未开始的任务被跳过；
+	等待已提交的任务完成后抛出首先取得的异常。
+\warning 不检查无限递归调用。
+\warning 调用线程不应为任务池的工作线程，否则可能死锁。
+\sa TraverseTree
+\since build 804
+*/
+template<typename _func>
+void
+TraverseTree(ystdex::task_pool& pool, _func f, const Path& dst,
+	const Path& src)
+{
+	std::atomic<bool> failed{};
+	vector<std::future<void>> results;
+	const auto wait_all([&]() ynothrow{
+		for(auto& res : results)
+			res.wait();
+	});
+
+	try
+	{
+		IO::TraverseTree([&](const Path& dname, const Path& sname){
+			// NOTE: The function and paths are captured rather than bound to
+			//	avoid evaluation of nested bind expressions by %std::bind.
+			if(!failed)
+				results.push_back(pool.wait([&failed, f, dname, sname]{
+					if(!failed)
+						try
+						{
+							f(dname, sname);
+						}
+						catch(...)
+						{
+							failed = true;
+							throw;
+						}
+				}));
+		}, dst, src);
+	}
+	catch(...)
+	{
+		failed = true;
+		wait_all();
+		throw;
+	}
+	// NOTE: The tasks refer to %failed, so all of them shall be completed
+	//	before any exception is rethrown.
+	wait_all();
+	for(auto& res : results)
+		res.get();
+}
+
+/*!
+\brief 使用任务池并发递归遍历目录。
+\note 在任务池中遍历每个目录，在调用线程中提交子目录的遍历任务。
+\note 函数以所在目录路径、节点类别和节点名称调用，可能在不同线程中并发调用。
+\note 函数返回值仅对目录有效，表示是否遍历此目录。
+\note 不保证调用的顺序。
+\note 遍历失败后不提交新的任务；等待已提交的任务完成后抛出首先取得的异常。
+\warning 不检查无限递归调用。
+\warning 调用线程不应为任务池的工作线程，否则可能死锁。
+\sa TraverseChildren
+\since build 805
+*/
+template<typename _func>
+void
+TraverseRecursively(ystdex::task_pool& pool, const Path& pth, _func f)
+{
+	vector<std::future<vector<Path>>> results;
+	const auto submit([&](const Path& dir){
+		results.push_back(pool.wait([f, dir]{
+			vector<Path> subdirs;
+
+			IO::TraverseChildren(dir, [&](NodeCategory c, NativePathView npv){
+				if(f(dir, c, npv) && bool(c & NodeCategory::Directory))
+					subdirs.push_back(dir / String(npv));
+			});
+			return subdirs;
+		}));
+	});
+	size_t i(0);
+
+	submit(pth);
+	try
+	{
+		// NOTE: The results are collected in order of submission, so the
+		//	number of pending tasks is bounded by the queue of the pool.
+		while(i < results.size())
+			for(const auto& dir : results[i++].get())
+				submit(dir);
+	}
+	catch(...)
+	{
+		// NOTE: The function might refer to objects owned by the caller, so
+		//	all submitted tasks shall be completed before rethrowing.
+		for(; i < results.size(); ++i)
+			results[i].wait();
+		throw;
+	}
+}
+#endif
+
 
 //! \since build 651
 //@{
@@ -780,6 +892,24 @@ CopyTree(const Path& dst, const Path& src, _tParams&&... args)
 			std::forward<_tParams>(fargs)...);
 	}, dst, src, std::forward<_tParams>(args)...);
 }
+#if YF_Multithread == 1
+/*!
+\brief 使用任务池并发复制目录树。
+\note 其余参数在每次复制文件时被复制。
+\sa CopyTree
+\sa TraverseTree
+\since build 804
+*/
+template<typename... _tParams>
+void
+CopyTree(ystdex::task_pool& pool, const Path& dst, const Path& src,
+	_tParams&&... args)
+{
+	IO::TraverseTree(pool, [args...](const Path& dname, const Path& sname){
+		IO::CopyFile(string(dname).c_str(), string(sname).c_str(), args...);
+	}, dst, src);
+}
+#endif
 
 //! \exception std::system_error 路径指向的不是一个目录或删除失败。
 //@{
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2015 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file TextBase.h
 \ingroup Service
 \brief 基础文本渲染逻辑对象。
-\version r2788
+\version r2791
 \author FrankHB <frankhb1989@gmail.com>
 \since build 275
 \par 创建时间:
 	2009-11-13 00:06:05 +0800
 \par 修改时间:
-	2015-12-19 02:49 +0800
+	2017-08-03 21:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -45,6 +45,11 @@ namespace Drawing
 */
 yconstexpr const Padding DefaultMargin(2, 2, 2, 2);
 
+//! \since build 821
+class GlyphCache;
+//! \since build 822
+class TextRun;
+
 
 /*!
 \brief 笔样式：字体和笔颜色。
@@ -97,6 +102,12 @@ public:
 	*/
 	Point Pen{};
 	std::uint8_t LineGap = 0; //!< 行距。
+	/*!
+	\brief 字形缓存指针。
+	\note 非空时文本渲染器使用缓存的字形覆盖掩码渲染字符。
+	\since build 821
+	*/
+	observer_ptr<GlyphCache> GlyphCachePtr{};
 
 	/*!
 	\brief 构造：使用指定字体和边距。
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2015 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file TextRenderer.h
 \ingroup Service
 \brief 文本渲染。
-\version r3233
+\version r3234
 \author FrankHB <frankhb1989@gmail.com>
 \since build 275
 \par 创建时间:
 	2009-11-13 00:06:05 +0800
 \par 修改时间:
-	2015-12-12 20:33 +0800
+	2017-08-03 21:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -598,6 +598,98 @@ public:
 };
 
 
+/*!
+\brief 文本行程：保存字符串排版结果的不可变对象。
+\note 排版规则和使用 TextRenderer 调用 PutText 相同。
+\sa PutText
+\since build 822
+
+保存排版的参数、每个被打印字符的笔位置和跨距、换行位置和边界。
+重复渲染时直接使用保存的笔位置，不再测量字符或计算换行。
+*/
+class YF_API TextRun final
+{
+public:
+	//! \brief 被打印的字符。
+	struct Glyph
+	{
+		char32_t Character;
+		//! \brief 渲染字符前的笔位置。
+		Point Pen;
+		//! \brief 跨距。
+		SDst Advance;
+	};
+
+private:
+	//! \brief 排版参数。
+	//@{
+	Drawing::Font font;
+	Padding margin;
+	Point start_pen;
+	std::uint8_t line_gap;
+	Size size;
+	String text;
+	bool line_wrap;
+	//@}
+	vector<Glyph> glyphs{};
+	//! \brief 每行第一个被打印字符的索引。
+	vector<size_t> line_starts{};
+	//! \brief 排版结束时的笔位置。
+	Point end_pen{};
+	//! \brief 被打印字符占据的行内区域的并。
+	Rect bounds{};
+	//! \brief 排版处理的字符数。
+	String::size_type length = 0;
+
+public:
+	/*!
+	\brief 构造：排版字符串。
+	\param ts 排版使用的文本状态，其中字体、边距、笔位置和行距为排版参数。
+	\param s 排版区域大小，相当于渲染器的图形接口上下文大小。
+	\param str 被排版的字符串。
+	\param line_wrap 是否输出多行。
+	\pre 间接断言：字符串参数的数据指针非空。
+	*/
+	TextRun(const TextState& ts, const Size& s, const String& str,
+		bool line_wrap);
+
+	DefGetter(const ynothrow, const Rect&, Bounds, bounds)
+	DefGetter(const ynothrow, const Point&, EndPen, end_pen)
+	DefGetter(const ynothrow, const vector<Glyph>&, Glyphs, glyphs)
+	DefGetter(const ynothrow, String::size_type, Length, length)
+	DefGetter(const ynothrow, const vector<size_t>&, LineStarts, line_starts)
+
+	/*!
+	\brief 判断使用参数指定的排版参数排版的结果是否和此对象相同。
+	\note 参数含义同构造函数。
+	\note 比较字体、边距、笔位置、行距、大小、字符串和是否输出多行。
+	*/
+	bool
+	Matches(const TextState&, const Size&, const String&, bool) const;
+
+	/*!
+	\brief 使用渲染器渲染。
+	\param offset 笔位置的偏移量。
+	\pre 渲染器文本状态的字体和排版使用的字体相同。
+	\post 渲染器文本状态的笔位置为排版结束时的笔位置加上偏移量。
+	\note 不测量字符，也不处理换行。
+	*/
+	template<class _tRenderer>
+	void
+	Render(_tRenderer& rd, const Vec& offset = {}) const
+	{
+		auto& ts(rd.GetTextState());
+
+		for(const auto& g : glyphs)
+		{
+			ts.Pen = g.Pen + offset;
+			rd(g.Character);
+		}
+		ts.Pen = end_pen + offset;
+	}
+};
+
+
 /*!
 \param g 输出图形接口上下文。
 \param str 待绘制的字符串。
@@ -651,6 +743,21 @@ DrawText(TextRegion& r, const Graphics& g, const Point& pt, const Size& s,
 //@}
 //@}
 
+/*!
+\brief 绘制剪切区域的文本行程。
+\param g 输出图形接口上下文。
+\param bounds 相对输出图形接口上下文矩形，限定输出边界。
+\param ts 输出时使用的文本状态。
+\param run 待绘制的文本行程。
+\param offset 文本行程中笔位置相对输出图形接口上下文的偏移量。
+\pre 文本状态的字体和排版文本行程使用的字体相同。
+\sa TextRun::Render
+\since build 822
+*/
+YF_API void
+DrawClippedText(const Graphics& g, const Rect& bounds, TextState& ts,
+	const TextRun& run, const Vec& offset = {});
+
 } // namespace Drawing;
 
 } // namespace YSLib;
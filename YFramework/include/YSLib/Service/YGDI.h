@@ -11,13 +11,13 @@
 /*!	\file YGDI.h
 \ingroup Service
 \brief 平台无关的图形设备接口。
-\version r3979
+\version r3980
 \author FrankHB <frankhb1989@gmail.com>
 \since build 566
 \par 创建时间:
 	2009-12-14 18:29:46 +0800
 \par 修改时间:
-	2017-02-20 18:55 +0800
+	2017-08-03 21:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -100,6 +100,14 @@ struct YF_API Padding
 
 //! \relates Padding
 //@{
+/*!
+\brief 比较：边距相等关系。
+\since build 822
+*/
+yconstfn PDefHOp(bool, ==, const Padding& x, const Padding& y) ynothrow
+	ImplRet(x.Left == y.Left && x.Right == y.Right && x.Top == y.Top
+		&& x.Bottom == y.Bottom)
+
 /*!
 \brief 加法逆元：对应分量调用一元 operator- 。
 \since build 572
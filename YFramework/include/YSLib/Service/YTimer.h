@@ -1,5 +1,5 @@
 ﻿/*
-	© 2010-2015 FrankHB.
+	© 2010-2015, 2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YTimer.h
 \ingroup Service
 \brief 计时器服务。
-\version r1123
+\version r1124
 \author FrankHB <frankhb1989@gmail.com>
 \since build 572
 \par 创建时间:
 	2010-06-05 10:28:58 +0800
 \par 修改时间:
-	2015-03-21 14:32 +0800
+	2017-08-06 10:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -148,6 +148,14 @@ public:
 	RefreshRemainder();
 };
 
+/*!
+\brief 取预定时刻：计时器的时间基点后时间间隔指定的时刻。
+\relates Timer
+\since build 823
+*/
+inline PDefH(TimePoint, FetchDeadline, const Timer& tmr) ynothrow
+	ImplRet(tmr.GetBaseTick() + tmr.Interval)
+
 /*!
 \brief 检查超时：当前时刻到达计时器的时间基点后时间间隔指定的预定时刻。
 \relates Timer
@@ -162,7 +170,7 @@ inline PDefH(bool, CheckTimeout, Timer& tmr) ynothrow
 \since build 416
 */
 inline PDefH(bool, Test, const Timer& tmr) ynothrow
-	ImplRet(HighResolutionClock::now() < tmr.GetBaseTick() + tmr.Interval)
+	ImplRet(HighResolutionClock::now() < FetchDeadline(tmr))
 
 } // namespace Timers;
 
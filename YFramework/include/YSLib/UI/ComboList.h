@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file ComboList.h
 \ingroup UI
 \brief 样式相关的图形用户界面组合列表控件。
-\version r2714
+\version r2715
 \author FrankHB <frankhb1989@gmail.com>
 \since build 282
 \par 创建时间:
 	2011-03-07 20:30:40 +0800
 \par 修改时间:
-	2016-08-13 20:22 +0800
+	2017-08-05 18:20 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -94,6 +94,13 @@ public:
 	DefGetter(, GEvent<void(IndexEventArgs)>&, Confirmed,
 		GetTextListRef().Confirmed)
 	DefGetterMem(const, ListType::size_type, HeadIndex, GetTextListRef())
+	/*!
+	\brief 取指定索引的项目。
+	\sa MTextList::GetItem
+	\since build 823
+	*/
+	PDefH(ItemType, GetItem, IndexType i) const
+		ImplRet(GetTextListRef().GetItem(i))
 	DefGetterMem(const, ListType::size_type, SelectedIndex, GetTextListRef())
 	DefGetterMem(const, const ListType&, List, GetTextListRef())
 	DefGetterMem(, ListType&, ListRef, GetTextListRef())
@@ -102,6 +109,12 @@ public:
 		GetTextListRef().Selected)
 	//! \brief 取文本列表引用。
 	DefGetter(const, TextList&, TextListRef, Deref(pTextList))
+	/*!
+	\brief 取项目总数。
+	\sa MTextList::GetTotal
+	\since build 823
+	*/
+	DefGetterMem(const, size_t, Total, GetTextListRef())
 	//! \brief 视图变更事件。
 	DefGetter(, GEvent<void(ViewArgs)>&, ViewChanged,
 		GetTextListRef().ViewChanged)
@@ -283,6 +296,12 @@ public:
 	//! \since build 392
 	DefGetterMem(ynothrow, ListType&, ListRef, lbContent)
 	/*!
+	\brief 取文本列表引用。
+	\note 可用于设置项目提供者。
+	\since build 823
+	*/
+	DefGetterMem(const, TextList&, TextListRef, lbContent)
+	/*!
 	\brief 取视图变更事件。
 	\since build 283
 	*/
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2015 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file Label.h
 \ingroup UI
 \brief 样式无关的用户界面标签。
-\version r1542
+\version r1544
 \author FrankHB <frankhb1989@gmail.com>
 \since build 573
 \par 创建时间:
 	2011-01-22 08:30:47 +0800
 \par 修改时间:
-	2015-02-02 10:18 +0800
+	2017-08-03 21:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -89,10 +89,26 @@ public:
 	\since build 309
 	*/
 	bool AutoWrapLine = {};
+	/*!
+	\brief 字形缓存指针：非空时用于绘制文本。
+	\sa Drawing::TextState::GlyphCachePtr
+	\since build 821
+	*/
+	observer_ptr<Drawing::GlyphCache> GlyphCachePtr{};
 //	bool AutoSize; //!< 启用根据字号自动调整大小。
 //	bool AutoEllipsis; //!< 启用对超出标签宽度的文本调整大小。
 	String Text{}; //!< 标签文本。
 
+private:
+	/*!
+	\brief 缓存的文本行程。
+	\note 使用默认剪切文本更新器时有效；排版参数改变时重新排版。
+	\sa DrawText
+	\since build 822
+	*/
+	mutable shared_ptr<const Drawing::TextRun> p_text_run{};
+
+public:
 	/*!
 	\brief 构造：使用指定字体、文本颜色和文本对齐样式。
 	\since build 485
@@ -121,6 +137,7 @@ public:
 
 	/*!
 	\brief 绘制文本。
+	\note 使用默认剪切文本更新器时绘制缓存的文本行程。
 	\sa AlignPen
 	\sa DrawClipText
 	\since build 525
@@ -136,6 +153,16 @@ public:
 	DefaultUpdateClippedText(const PaintContext&, Drawing::TextState&,
 		const String&, bool);
 	//@}
+
+private:
+	/*!
+	\brief 按参数指定的边界大小、文本宽度和当前状态计算笔的偏移位置。
+	\note 仅在需要时调用第二参数取文本宽度。
+	\since build 822
+	*/
+	template<typename _fWidth>
+	Point
+	AlignPenOffset(const Size&, _fWidth) const;
 };
 
 
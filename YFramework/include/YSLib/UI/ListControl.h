@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2015 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file ListControl.h
 \ingroup UI
 \brief 列表控件。
-\version r1639
+\version r1645
 \author FrankHB <frankhb1989@gmail.com>
 \since build 528
 \par 创建时间:
 	2011-04-19 22:59:02 +0800
 \par 修改时间:
-	2015-07-04 01:02 +0800
+	2017-08-05 18:20 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -133,6 +133,7 @@ public:
 /*!
 \ingroup UIModels
 \brief 文本列表模块。
+\note 设置 CountItems 和 FetchItems 时使用提供者按需取项目而非文本列表。
 \since build 188
 */
 class YF_API MTextList : public AMUnitControlList
@@ -148,6 +149,31 @@ protected:
 public:
 	//! \since build 529
 	MLabel LabelBrush{};
+	//! \since build 808
+	//@{
+	/*!
+	\brief 项目数提供者：取项目总数。
+	\sa IsProvided
+	*/
+	std::function<size_t()> CountItems{};
+	/*!
+	\brief 项目提供者：取以第一参数为起始索引且不超过第二参数个数的项目。
+	\note 结果可少于请求的项目数，表示之后的项目尚未就绪（如正在异步加载）。
+	\note 未就绪的项目显示为空，在之后访问时重新请求。
+	\sa IsProvided
+	*/
+	std::function<ListType(IndexType, size_t)> FetchItems{};
+	//! \brief 使用提供者时在视图前后额外预取的项目数。
+	size_t PrefetchMargin = 16;
+
+private:
+	//! \brief 提供者取得的项目缓存的起始索引。
+	mutable IndexType cache_base = 0;
+	//! \brief 提供者取得的项目缓存。
+	mutable ListType item_cache{};
+	//@}
+
+public:
 
 	/*!
 	\brief 构造：使用文本列表句柄。
@@ -158,6 +184,25 @@ public:
 	MTextList(const shared_ptr<ListType>& = {});
 	DefDeMoveCtor(MTextList)
 
+	/*!
+	\brief 判断是否使用提供者取项目。
+	\since build 808
+	*/
+	DefPred(const ynothrow, Provided, CountItems && FetchItems)
+
+	/*!
+	\brief 取指定索引的项目。
+	\pre 断言：参数小于项目总数。
+	\note 使用提供者时若项目不在缓存中则预取包含项目的视图范围，未就绪时结果为空。
+	\since build 808
+	*/
+	ItemType
+	GetItem(IndexType) const;
+	/*!
+	\brief 取提供者取得的项目缓存。
+	\since build 808
+	*/
+	DefGetter(const ynothrow, const ListType&, ItemCache, item_cache)
 	/*!
 	\brief 取文本列表。
 	\since build 392
@@ -190,6 +235,23 @@ public:
 	*/
 	void
 	SetList(const shared_ptr<ListType>&);
+
+	/*!
+	\brief 使用提供者预取指定索引起的指定数量的项目。
+	\note 同时预取前后 PrefetchMargin 个项目；替换原有缓存。
+	\note 未使用提供者时忽略。
+	\since build 808
+	*/
+	void
+	PrefetchItems(IndexType, size_t) const;
+
+	/*!
+	\brief 清除提供者取得的项目缓存。
+	\note 提供者的项目变化时应调用此函数并更新视图。
+	\since build 808
+	*/
+	PDefH(void, ResetItemCache, ) const ynothrow
+		ImplExpr(cache_base = 0, item_cache.clear())
 };
 
 
@@ -385,9 +447,19 @@ public:
 
 //! \relates TextList
 //@{
+/*!
+\brief 取文本列表中项目文本的最大宽度。
+\note 不含边距。
+\note 使用提供者时宽度仅按视图中的项目和预取的项目计算。
+\since build 823
+*/
+YF_API SDst
+FetchMaxItemWidth(const TextList&);
+
 /*!
 \brief 根据文本内容调整文本列表大小。
 \note 调整大小后自动调整视图长度。
+\note 使用提供者时宽度仅按视图中的项目和预取的项目计算。
 */
 YF_API void
 ResizeForContent(TextList&);
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2014-2016 FrankHB.
+	© 2014-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file TreeView.h
 \ingroup UI
 \brief 树形视图控件。
-\version r288
+\version r289
 \author FrankHB <frankhb1989@gmail.com>
 \since build 532
 \par 创建时间:
 	2014-09-04 19:48:13 +0800
 \par 修改时间:
-	2016-05-24 01:30 +0800
+	2017-07-26 20:48 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -74,6 +74,15 @@ public:
 	*/
 	std::function<String(const ValueNode&)> ExtractText{DefaultExtractText};
 	/*!
+	\brief 判断没有子节点的节点是否为可延迟展开的分支。
+	\note 若非空且结果为 true ，节点显示为可展开的分支。
+	\note 子节点可在 Expand 中按需添加到 TreeRoot 的对应节点；
+		若调用 Expand 后仍没有子节点则不展开。
+	\sa Expand
+	\since build 808
+	*/
+	std::function<bool(const ValueNode&)> IsLazyBranch{};
+	/*!
 	\brief 响应 CursorOver 事件时节点分支图标的颜色。
 	\since build 532
 	*/
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YGUI.h
 \ingroup UI
 \brief 平台无关的图形用户界面。
-\version r2454
+\version r2455
 \author FrankHB <frankhb1989@gmail.com>
 \since 早于 build 132
 \par 创建时间:
 	2009-11-16 20:06:58 +0800
 \par 修改时间:
-	2016-02-12 02:36 +0800
+	2017-07-18 13:42 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -258,6 +258,15 @@ public:
 	DefGetter(const ynothrow, size_t, TapCount, tap_count)
 	//! \since build 541
 	DefGetter(const ynothrow, const Point&, TapLocation, tap_location)
+	/*!
+	\brief 取保持输入状态需要被再次检查的时刻。
+	\return 若存在按键或接触保持状态则为 HeldTimer 的超时时刻，
+		否则为 Timers::TimePoint::max() 。
+	\note 可用于确定消息循环的最长等待时间。
+	\since build 799
+	*/
+	Timers::TimePoint
+	GetHeldDeadline() const ynothrow;
 
 	/*!
 	\brief 检查输入保持状态。
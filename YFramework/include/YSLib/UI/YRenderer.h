@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2015 FrankHB.
+	© 2011-2015, 2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YRenderer.h
 \ingroup UI
 \brief 样式无关的 GUI 部件渲染器。
-\version r653
+\version r655
 \author FrankHB <frankhb1989@gmail.com>
 \since build 566
 \par 创建时间:
 	2011-09-03 23:47:32 +0800
 \par 修改时间:
-	2015-04-04 11:13 +0800
+	2017-08-05 12:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -30,6 +30,9 @@
 
 #include "YModules.h"
 #include YFM_YSLib_UI_YComponent
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+#	include <ystdex/concurrency.h> // for ystdex::thread_pool;
+#endif
 
 namespace YSLib
 {
@@ -206,6 +209,65 @@ public:
 	Validate(IWidget& wgt, IWidget& sender, const PaintContext&);
 };
 
+
+/*!
+\brief 并发绘制器：使用线程池并发绘制子部件。
+\note 只在工作线程中绘制绘制线程安全的部件，其它部件在调用线程中按顺序绘制。
+\note 并发绘制的子部件的绘制区域互不相交，因此结果和按顺序绘制相同。
+\note 每个子部件只在一个任务中被绘制一次。
+\warning 绘制线程安全的部件的绘制只能修改自身状态和绘制区域内的图形缓冲区。
+\sa SetConcurrentPainterOf
+\sa SetPaintThreadSafeOf
+\since build 823
+
+按绘制顺序将绘制区域互不相交的绘制线程安全的子部件分组，
+	划分每组的子部件并发绘制。
+不支持多线程时或在工作线程中嵌套调用时按顺序绘制。
+*/
+class YF_API ConcurrentPainter
+{
+private:
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+	//! \brief 工作线程池。
+	ystdex::thread_pool pool;
+#endif
+	//! \brief 并发数：包括调用线程。
+	size_t concurrency;
+
+public:
+	/*!
+	\brief 构造：使用指定的并发数。
+	\note 并发数包括调用线程；为 0 时使用硬件线程数。
+	\note 不支持多线程时并发数为 1 。
+	*/
+	explicit
+	ConcurrentPainter(size_t = 0);
+	//! \brief 析构：等待所有工作线程结束。
+	~ConcurrentPainter();
+
+	DefGetter(const ynothrow, size_t, Concurrency, concurrency)
+
+	/*!
+	\brief 绘制可见子部件并提交参数的重绘区域。
+	\param children 按绘制顺序排列的子部件。
+	\param e 绘制参数，发送者为子部件的容器。
+	\note 等待所有任务结束后，按绘制顺序重新抛出第一个异常。
+	\sa PaintVisibleChildAndCommit
+	*/
+	void
+	PaintVisibleChildren(const vector<lref<IWidget>>& children,
+		PaintEventArgs& e);
+
+private:
+	/*!
+	\brief 并发调用：以 [0, n) 中的每个值作为参数调用。
+	\pre 断言：n 不大于并发数。
+	\note 调用线程调用参数为 0 的调用。
+	*/
+	void
+	RunConcurrently(size_t n, std::function<void(size_t)>);
+};
+
 } // namespace UI;
 
 } // namespace YSLib;
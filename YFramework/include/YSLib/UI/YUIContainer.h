@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YUIContainer.h
 \ingroup UI
 \brief 样式无关的 GUI 容器。
-\version r2131
+\version r2132
 \author FrankHB <frankhb1989@gmail.com>
 \since build 563
 \par 创建时间:
 	2011-01-22 07:59:47 +0800
 \par 修改时间:
-	2016-04-12 01:24 +0800
+	2017-07-25 21:14 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -170,6 +170,108 @@ YF_API void
 MoveToTop(IWidget&);
 
 
+/*!
+\brief 子部件网格索引。
+\note 子部件按边界划分至均匀网格的单元，每个单元保持子部件的迭代顺序。
+\note 对 MUIContainer 的子部件，迭代顺序为 Z 顺序从高到低。
+\note 不保存可见性等其它状态，由查询时的谓词判断。
+\warning 不通过部件视图改变子部件集合、次序或边界时需调用 Invalidate 。
+\since build 807
+
+用于加速包含大量子部件的容器的命中测试。索引失效后在下一次查询时重建。
+*/
+class YF_API WidgetGridIndex
+{
+public:
+	//! \brief 每个坐标轴上的最大单元数。
+	static yconstexpr const size_t MaxCellCount = 64;
+
+private:
+	//! \brief 所有子部件边界的并。
+	Rect extent{};
+	size_t columns = 0;
+	size_t rows = 0;
+	SDst cell_width = 1;
+	SDst cell_height = 1;
+	//! \brief 各单元在 items 中的起始偏移，最后一项为 items 的大小。
+	vector<size_t> offsets{};
+	vector<observer_ptr<IWidget>> items{};
+	bool valid = {};
+
+public:
+	DefDeCtor(WidgetGridIndex)
+
+	DefPred(const ynothrow, Valid, valid)
+
+	/*!
+	\brief 查找包含指定点且满足谓词的第一个子部件。
+	\return 若找到则为部件指针，否则为空指针。
+	\note 若索引失效则先以第一参数为容器重建。
+	*/
+	template<typename _fPred>
+	observer_ptr<IWidget>
+	Find(IWidget& con, const Point& pt, _fPred pred)
+	{
+		if(!valid)
+			Rebuild(con);
+		if(extent.Contains(pt))
+		{
+			const auto idx(LocateCell(pt));
+
+			for(auto i(offsets[idx]); i != offsets[idx + 1]; ++i)
+			{
+				auto& wgt(*items[i]);
+
+				if(Contains(wgt, pt) && pred(wgt))
+					return items[i];
+			}
+		}
+		return {};
+	}
+
+	//! \brief 使索引失效。
+	PDefH(void, Invalidate, ) ynothrow
+		ImplExpr(valid = {})
+
+private:
+	//! \pre 断言：点在 extent 内。
+	size_t
+	LocateCell(const Point&) const ynothrowv;
+
+public:
+	//! \brief 按指定容器当前的子部件重建索引。
+	void
+	Rebuild(IWidget&);
+};
+
+/*!
+\brief 使部件的子部件索引失效。
+\note 若部件未启用子部件索引则忽略。
+\relates WidgetGridIndex
+\since build 807
+*/
+YF_API void
+InvalidateChildIndexOf(IWidget&);
+
+/*!
+\brief 取部件的子部件索引指针。
+\relates WidgetGridIndex
+\since build 807
+*/
+inline PDefH(observer_ptr<WidgetGridIndex>, FetchChildIndexPtr,
+	const IWidget& wgt)
+	ImplRet(make_observer(wgt.GetView().ChildIndexPtr.get()))
+
+/*!
+\brief 设置部件是否启用子部件索引。
+\note 子部件索引可加速子部件较多的容器中的命中测试。
+\relates WidgetGridIndex
+\since build 807
+*/
+YF_API void
+SetChildIndexingOf(IWidget&, bool);
+
+
 //! \since build 555
 //@{
 //! \brief Z 顺序类型：覆盖顺序，值越大表示越接近顶层。
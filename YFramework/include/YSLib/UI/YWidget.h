@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YWidget.h
 \ingroup UI
 \brief 样式无关的 GUI 部件。
-\version r5809
+\version r5813
 \author FrankHB <frankhb1989@gmail.com>
 \since build 569
 \par 创建时间:
 	2009-11-16 20:06:58 +0800
 \par 修改时间:
-	2016-02-12 01:26 +0800
+	2017-08-05 12:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -178,11 +178,12 @@ SetBoundsOf(IWidget&, const Rect&);
 
 /*!
 \brief 设置部件的容器指针。
+\note 使原有容器和新容器的子部件索引失效。
+\sa InvalidateChildIndexOf
 \since build 672
 */
-inline PDefH(void, SetContainerPtrOf, IWidget& wgt,
-	observer_ptr<IWidget> p_con = {})
-	ImplExpr(wgt.GetView().ContainerPtr = p_con)
+YF_API void
+SetContainerPtrOf(IWidget&, observer_ptr<IWidget> = {});
 
 /*!
 \brief 设置部件的无效区域。
@@ -342,6 +343,49 @@ inline void
 PaintVisibleChildAndCommit(IWidget& wgt, PaintEventArgs& e)
 	ImplExpr(IsVisible(wgt) ? PaintChildAndCommit(wgt, e) : void())
 
+/*!
+\brief 绘制范围内可见的子部件并提交参数的重绘区域。
+\note 范围为绘制顺序。
+\note 若参数的发送者设置了并发绘制器则使用并发绘制器绘制，否则按顺序调用
+	PaintVisibleChildAndCommit 。
+\sa ConcurrentPainter
+\since build 823
+*/
+YF_API void
+PaintVisibleChildrenAndCommit(WidgetRange, PaintEventArgs&);
+
+//! \since build 823
+//@{
+//! \brief 判断部件是否绘制线程安全。
+inline PDefH(bool, IsPaintThreadSafe, const IWidget& wgt)
+	ImplRet(wgt.GetView().PaintThreadSafe)
+
+//! \brief 取部件的并发绘制器指针。
+inline PDefH(observer_ptr<ConcurrentPainter>, FetchConcurrentPainterPtr,
+	const IWidget& wgt)
+	ImplRet(make_observer(wgt.GetView().ConcurrentPainterPtr.get()))
+
+/*!
+\brief 设置部件的并发绘制器。
+\note 指针为空时按顺序绘制子部件。
+\note 同一个并发绘制器可被多个部件共享。
+*/
+inline PDefH(void, SetConcurrentPainterOf, IWidget& wgt,
+	shared_ptr<ConcurrentPainter> p = {})
+	ImplExpr(wgt.GetView().ConcurrentPainterPtr = std::move(p))
+
+/*!
+\brief 设置部件是否绘制线程安全。
+\note 绘制线程安全的部件可被容器的并发绘制器在工作线程中绘制。
+\warning 绘制线程安全的部件的绘制可和其它部件的绘制在不同线程中同时进行，
+	只能修改自身状态和绘制区域内的图形缓冲区。
+\warning 使用 BufferedRenderer 的部件不是绘制线程安全的。
+\warning 使用共享的字体缓存绘制文本的部件（如 Label ）不是绘制线程安全的。
+*/
+inline PDefH(void, SetPaintThreadSafeOf, IWidget& wgt, bool b)
+	ImplExpr(wgt.GetView().PaintThreadSafe = b)
+//@}
+
 /*!
 \brief 请求提升至容器前端。
 \note 必要时无效化。
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YWidgetView.h
 \ingroup UI
 \brief 样式无关的 GUI 部件。
-\version r836
+\version r845
 \author FrankHB <frankhb1989@gmail.com>
 \since build 568
 \par 创建时间:
 	2009-11-16 20:06:58 +0800
 \par 修改时间:
-	2016-12-04 15:41 +0800
+	2017-08-04 20:15 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -37,6 +37,12 @@ namespace YSLib
 namespace UI
 {
 
+//! \since build 807
+class WidgetGridIndex;
+//! \since build 823
+class ConcurrentPainter;
+
+
 /*!
 \brief 方向模块。
 \since build 170
@@ -124,6 +130,26 @@ public:
 	//! \brief 焦点指针。
 	mutable observer_ptr<IWidget> FocusingPtr{};
 	//@}
+	/*!
+	\brief 子部件索引指针。
+	\note 非空时用于加速对视图所在部件的子部件的命中测试。
+	\sa SetChildIndexingOf
+	\since build 807
+	*/
+	mutable shared_ptr<WidgetGridIndex> ChildIndexPtr{};
+	/*!
+	\brief 并发绘制器指针。
+	\note 非空时用于并发绘制视图所在部件的子部件。
+	\sa SetConcurrentPainterOf
+	\since build 823
+	*/
+	mutable shared_ptr<ConcurrentPainter> ConcurrentPainterPtr{};
+	/*!
+	\brief 绘制线程安全：视图所在部件可在工作线程中和其它部件并发绘制。
+	\sa SetPaintThreadSafeOf
+	\since build 823
+	*/
+	bool PaintThreadSafe = {};
 
 	DefDeCtor(AView)
 	AView(const AView&)
@@ -131,7 +157,9 @@ public:
 	{}
 	AView(AView&& v)
 		: ContainerPtr(v.ContainerPtr), DependencyPtr(v.DependencyPtr),
-		FocusingPtr(v.FocusingPtr)
+		FocusingPtr(v.FocusingPtr), ChildIndexPtr(std::move(v.ChildIndexPtr)),
+		ConcurrentPainterPtr(std::move(v.ConcurrentPainterPtr)),
+		PaintThreadSafe(v.PaintThreadSafe)
 	{
 		yunseq(v.ContainerPtr = {}, v.DependencyPtr = {}, v.FocusingPtr = {});
 	}
@@ -189,6 +217,14 @@ public:
 
 //! \relates AView
 //@{
+/*!
+\brief 使指定视图所在容器的子部件索引失效。
+\sa InvalidateChildIndexOf
+\since build 807
+*/
+YF_API void
+InvalidateContainerIndexOf(const AView&);
+
 //! \brief 交换指定视图的位置。
 YF_API void
 SwapLocationOf(AView&, Point&);
@@ -202,6 +238,8 @@ SwapSizeOf(AView&, Size&);
 
 /*!
 \brief 部件视图。
+\note 设置边界时使所在容器的子部件索引失效。
+\warning 通过 GetLocationRef 或 GetSizeRef 的结果修改边界时不保证索引有效性。
 \since build 259
 */
 class YF_API View : public AView
@@ -235,16 +273,23 @@ public:
 	//! \since build 307
 	DefGetterMem(ynothrow, Size&, SizeRef, visual.Bounds)
 
-	DefSetter(override, SDst, Height, GetSizeRef().Height)
+	void
+	SetHeight(SDst) override;
 	void
 	SetVisible(bool) ImplI(AView);
-	DefSetter(override, SDst, Width, GetSizeRef().Width)
-	DefSetterMem(override, SPos, X, GetLocationRef())
-	DefSetterMem(override, SPos, Y, GetLocationRef())
+	void
+	SetWidth(SDst) override;
+	void
+	SetX(SPos) override;
+	void
+	SetY(SPos) override;
 	//! \since build 569
-	DefSetter(override, const Rect&, Bounds, visual.Bounds)
-	DefSetter(ImplI(AView), const Point&, Location, visual.Bounds.GetPointRef())
-	DefSetter(ImplI(AView), const Size&, Size, visual.Bounds.GetSizeRef())
+	void
+	SetBounds(const Rect&) override;
+	void
+	SetLocation(const Point&) ImplI(AView);
+	void
+	SetSize(const Size&) ImplI(AView);
 
 	//! \since build 409
 	DefClone(const ImplI(AView), View)
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2012-2016 FrankHB.
+	© 2012-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file GUIApplication.cpp
 \ingroup Helper
 \brief GUI 应用程序。
-\version r578
+\version r587
 \author FrankHB <frankhb1989@gmail.com>
 \since build 396
 \par 创建时间:
 	2013-04-06 22:42:54 +0800
 \par 修改时间:
-	2016-08-27 15:38 +0800
+	2017-07-20 09:17 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -29,6 +29,7 @@
 #include YFM_Helper_GUIApplication
 #include YFM_Helper_Environment
 #include YFM_YCLib_Input // for platform_ex::FetchCursor;
+#include YFM_YSLib_UI_YGUI // for UI::FetchGUIState;
 #if YCL_Win32
 #	include YFM_Win32_Helper_Win32Control // for Windows::UI::ControlView;
 #elif YCL_Android
@@ -253,33 +254,76 @@ GUIApplication::GetGUIHostRef() const ynothrow
 {
 	return init.get().host;
 }
+Timers::Duration
+GUIApplication::GetIdleWaitDuration() const
+{
+#if YF_Hosted && !YCL_Android
+	using Timers::HighResolutionClock;
+	const auto now(HighResolutionClock::now());
+	auto deadline(now + MaxIdleWait);
+
+	{
+		lock_guard<mutex> lck(wake_mutex);
+
+		deadline = std::min(deadline, wake_deadline);
+	}
+	deadline = std::min(deadline, UI::FetchGUIState().GetHeldDeadline());
+	return deadline > now ? deadline - now : Timers::Duration::zero();
+#else
+	// NOTE: Input states are polled without any notification, so the loop
+	//	shall not block.
+	return Timers::Duration::zero();
+#endif
+}
 
 bool
 GUIApplication::DealMessage()
 {
 	if(AccessQueue([](MessageQueue& mq) ynothrow{
 		return mq.empty();
-	}))
+	}) && !WaitForMessage(GetIdleWaitDuration()))
+	{
+		{
+			lock_guard<mutex> lck(wake_mutex);
+
+			if(wake_deadline <= Timers::HighResolutionClock::now())
+				wake_deadline = Timers::TimePoint::max();
+		}
 	//	Idle(UIResponseLimit);
 		OnGotMessage(FetchIdleMessage());
+	}
 	else
 	{
-		const auto i(AccessQueue([](MessageQueue& mq) ynothrow{
-			return mq.cbegin();
+		Message msg;
+		const auto prior(AccessQueue([&](MessageQueue& mq) ynothrowv{
+			return mq.Pop(msg);
 		}));
 
-		if(YB_UNLIKELY(i->second.GetMessageID() == SM_Quit))
+		if(YB_UNLIKELY(msg.GetMessageID() == SM_Quit))
 			return {};
-		if(i->first < UIResponseLimit)
+		if(prior < UIResponseLimit)
 			Idle(UIResponseLimit);
-		OnGotMessage(i->second);
-		AccessQueue([i](MessageQueue& mq) ynothrowv{
-			mq.erase(i);
-		});
+		OnGotMessage(msg);
 	}
 	return true;
 }
 
+void
+GUIApplication::RequestWakeUp(Timers::TimePoint t)
+{
+	bool earlier;
+
+	{
+		lock_guard<mutex> lck(wake_mutex);
+
+		earlier = t < wake_deadline;
+		if(earlier)
+			wake_deadline = t;
+	}
+	if(earlier)
+		Wake();
+}
+
 
 GUIApplication&
 FetchGlobalInstance()
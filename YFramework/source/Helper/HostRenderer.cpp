@@ -1,5 +1,5 @@
 ﻿/*
-	© 2013-2016 FrankHB.
+	© 2013-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file HostRenderer.cpp
 \ingroup Helper
 \brief 宿主渲染器。
-\version r709
+\version r712
 \author FrankHB <frankhb1989@gmail.com>
 \since build 426
 \par 创建时间:
 	2013-07-09 05:37:27 +0800
 \par 修改时间:
-	2016-07-30 19:43 +0800
+	2017-07-18 13:42 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -46,6 +46,25 @@ using namespace Drawing;
 namespace Host
 {
 
+namespace
+{
+
+/*!
+\brief 通知应用程序实例宿主事件已被处理。
+\sa Application::Wake
+\since build 799
+*/
+void
+NotifyHostEvent()
+{
+	// NOTE: The application instance may be not ready or have been destroyed.
+	if(const auto p_app = LockInstance())
+		p_app->Wake();
+}
+
+} // unnamed namespace;
+
+
 RenderWindow::RenderWindow(HostRenderer& rd, NativeWindowHandle h)
 	: Window(h), renderer(rd)
 {
@@ -165,6 +184,7 @@ WindowThread::WindowLoop(Window& wnd)
 
 		if(i != m.cend())
 			i->second(p_evt.get());
+		NotifyHostEvent();
 	}
 #	else
 	yunused(wnd);
@@ -181,6 +201,7 @@ WindowThread::WindowLoop(Window& wnd)
 		{
 			::TranslateMessage(&msg);
 			::DispatchMessageW(&msg);
+			NotifyHostEvent();
 		}
 		else
 			YCL_Trace_Win32E(Warning, GetMessageW, yfsig);
@@ -11,13 +11,13 @@
 /*!	\file Dependency.cpp
 \ingroup NPL
 \brief 依赖管理。
-\version r839
+\version r846
 \author FrankHB <frankhb1989@gmail.com>
 \since build 623
 \par 创建时间:
 	2015-08-09 22:14:45 +0800
 \par 修改时间:
-	2017-07-14 11:30 +0800
+	2017-07-30 19:27 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -36,6 +36,11 @@
 #include <cstdio> // for std::puts;
 #include <regex> // for std::regex, std::regex_match;
 #include <ystdex/string.hpp> // for ystdex::begins_with, ystdex::erase_left;
+#if YF_Multithread == 1
+#	include <thread> // for std::thread::hardware_concurrency;
+#	include <ystdex/concurrency.h> // for ystdex::thread_pool;
+#	include <future> // for std::shared_future;
+#endif
 
 using namespace YSLib;
 
@@ -138,10 +143,19 @@ void
 InstallDirectory(const string& dst, const string& src)
 {
 	using namespace YSLib::IO;
-
-	TraverseTree([](const Path& dname, const Path& sname){
+	const auto f([](const Path& dname, const Path& sname){
 		InstallFile(string(dname).c_str(), string(sname).c_str());
-	}, Path(dst), Path(src));
+	});
+
+#if YF_Multithread == 1
+	// NOTE: Files are installed concurrently with the number of workers
+	//	equal to the number of hardware threads.
+	ystdex::task_pool pool(std::thread::hardware_concurrency());
+
+	TraverseTree(pool, f, Path(dst), Path(src));
+#else
+	TraverseTree(f, Path(dst), Path(src));
+#endif
 }
 
 void
@@ -244,6 +258,180 @@ CopyEnvironment(TermNode& term, ContextNode& ctx)
 }
 //@}
 
+//! \since build 812
+//@{
+//! \brief 复制项：子项以及引用的值的目标被复制。
+TermNode
+CopyTerm(const TermNode& term)
+{
+	TermNode res(NoContainer, term.GetName());
+
+	res.SetContent(term.CreateWith(&ValueObject::MakeCopy),
+		term.Value.MakeCopy());
+	return res;
+}
+
+/*!
+\brief 创建隔离的上下文：使用指定上下文的环境的副本。
+\note 复制使用和 copy-environment 相同的规则。
+*/
+shared_ptr<ContextNode>
+MakeIsolatedContext(const ContextNode& ctx)
+{
+	auto p_env(make_shared<NPL::Environment>());
+
+	CopyEnvironmentDFS(*p_env, ctx.GetRecordRef());
+	return make_shared<ContextNode>(ctx, std::move(p_env));
+}
+
+//! \brief 在指定的上下文中规约项，转移规约的结果。
+TermNode
+ReduceToResult(TermNode& term, ContextNode& ctx)
+{
+	ReduceChecked(term, ctx);
+	// NOTE: The context would be released with the result alive. See
+	//	%ReduceCheckedClosure.
+	term.SetContent(term.CreateWith(&ValueObject::MakeMoveCopy),
+		term.Value.MakeMoveCopy());
+	return std::move(term);
+}
+
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+//! \brief 异步规约的结果。
+using TermFuture = std::shared_future<TermNode>;
+
+//! \brief 当前线程是否为求值线程池的工作线程。
+thread_local bool is_evaluation_worker;
+
+/*!
+\brief 异步规约：在求值线程池中规约项。
+\pre 当前线程不是求值线程池的工作线程。
+\note 线程池的工作线程数等于硬件线程数。
+*/
+TermFuture
+ReduceAsync(TermNode&& term, shared_ptr<ContextNode> p_ctx)
+{
+	static ystdex::thread_pool pool(std::max<size_t>(
+		std::thread::hardware_concurrency(), 1), []() ynothrow{
+		is_evaluation_worker = true;
+	});
+	YAssert(!is_evaluation_worker, "Invalid thread found.");
+	auto p_term(share_move(term));
+
+	return pool.enqueue([=]{
+		return ReduceToResult(*p_term, *p_ctx);
+	}).share();
+}
+#endif
+
+/*!
+\brief 创建期值：在隔离的上下文中并发规约第二个子项的副本。
+\note 在求值线程池的工作线程中调用或不支持并发时直接规约。
+*/
+ReductionStatus
+Future(TermNode& term, ContextNode& ctx)
+{
+	RetainN(term);
+
+	auto expr(CopyTerm(Deref(std::next(term.begin()))));
+	auto p_ctx(MakeIsolatedContext(ctx));
+
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+	// NOTE: Tasks are not enqueued in worker threads to prevent deadlock when
+	//	all the workers are waiting for nested futures.
+	if(!is_evaluation_worker)
+	{
+		term.Value = ReduceAsync(std::move(expr), std::move(p_ctx));
+		return ReductionStatus::Clean;
+	}
+#endif
+	term.SetContent(ReduceToResult(expr, *p_ctx));
+	return CheckNorm(term);
+}
+
+/*!
+\brief 强制求值：等待期值的规约结果。
+\exception 异常中立：重新抛出规约期值时抛出的异常。
+\note 对不是期值的对象，结果为参数的值。
+*/
+ReductionStatus
+Force(TermNode& term)
+{
+	RetainN(term);
+
+	auto& tm(Deref(std::next(term.begin())));
+
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+	if(const auto p = AccessPtr<TermFuture>(tm))
+	{
+		auto res(p->get());
+
+		term.SetContent(std::move(res));
+		return CheckNorm(term);
+	}
+#endif
+	LiftTerm(term, tm);
+	return CheckNorm(term);
+}
+
+/*!
+\brief 并行映射：以列表的每个元素为参数调用应用子，结果为对应的列表。
+\note 每次调用使用不同的隔离的上下文。
+*/
+ReductionStatus
+ParallelMap(TermNode& term, ContextNode& ctx)
+{
+	RetainN(term, 2);
+
+	auto i(std::next(term.begin()));
+	const auto h(Unwrap(Access<ContextHandler>(Deref(i))));
+	const auto& l(Deref(++i));
+	const auto make_call([&](const TermNode& x){
+		TermNode call(NoContainer, x.GetName());
+
+		call.emplace(NoContainer, MakeIndex(call), h);
+		call.emplace(CopyTerm(x).GetContainer(), MakeIndex(call),
+			x.Value.MakeCopy());
+		return call;
+	});
+	TermNode::Container con;
+
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+	if(!is_evaluation_worker)
+	{
+		vector<TermFuture> futures;
+
+		futures.reserve(l.size());
+		for(const auto& x : l)
+			futures.push_back(ReduceAsync(make_call(x),
+				MakeIsolatedContext(ctx)));
+		// NOTE: All the futures are waited before exceptions being thrown.
+		for(auto& f : futures)
+			f.wait();
+		for(auto& f : futures)
+		{
+			auto res(f.get());
+
+			con.emplace(std::move(res.GetContainerRef()), MakeIndex(con),
+				std::move(res.Value));
+		}
+		term.SetContent(std::move(con), ValueObject());
+		return ReductionStatus::Retained;
+	}
+#endif
+	for(const auto& x : l)
+	{
+		auto call(make_call(x));
+		auto res(ReduceToResult(call, *MakeIsolatedContext(ctx)));
+
+		con.emplace(std::move(res.GetContainerRef()), MakeIndex(con),
+			std::move(res.Value));
+	}
+	term.SetContent(std::move(con), ValueObject());
+	return ReductionStatus::Retained;
+}
+//@}
+
 } // unnamed namespace;
 
 void
@@ -253,6 +441,7 @@ LoadNPLContextForSHBuild(REPLContext& context)
 	auto& root(context.Root);
 
 	LoadSequenceSeparators(root, context.ListTermPreprocess),
+	context.StatementSeparator = ';',
 	AccessLiteralPassesRef(root)
 		= [](TermNode& term, ContextNode&, string_view id) -> ReductionStatus{
 		YAssertNonnull(id.data());
@@ -537,6 +726,10 @@ LoadNPLContextForSHBuild(REPLContext& context)
 		$defl! env-empty? (n) string-empty? (env-get n);
 	)NPL");
 	RegisterStrict(root, "system", CallSystem);
+	// NOTE: Concurrency library.
+	RegisterForm(root, "future", Future);
+	RegisterStrict(root, "force", Force);
+	RegisterStrict(root, "parallel-map", ParallelMap);
 	// NOTE: SHBuild builtins.
 	root.GetRecordRef().Define("SHBuild_BaseTerminalHook_",
 		ValueObject(std::function<void(const string&, const string&)>(
@@ -11,13 +11,13 @@
 /*!	\file Lexical.cpp
 \ingroup NPL
 \brief NPL 词法处理。
-\version r1604
+\version r1612
 \author FrankHB <frankhb1989@gmail.com>
 \since build 335
 \par 创建时间:
 	2012-08-03 23:04:26 +0800
 \par 修改时间:
-	2017-06-13 15:53 +0800
+	2017-08-02 20:10 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -340,31 +340,52 @@ EscapeLiteral(string_view sv)
 string
 EscapeXML(string_view sv)
 {
-	YAssertNonnull(sv.data());
-
 	string res;
 
 	res.reserve(sv.length());
-	for(char c : sv)
-		switch(c)
+	EscapeXML(sv, [&](string_view s){
+		res.append(s.data(), s.length());
+	});
+	return res;
+}
+void
+EscapeXML(string_view sv, std::function<void(string_view)> f)
+{
+	YAssertNonnull(sv.data());
+
+	const auto e(sv.data() + sv.length());
+	auto b(sv.data());
+
+	for(auto p(b); p != e; ++p)
+	{
+		string_view esc;
+
+		switch(*p)
 		{
 		case '\0':
 			YTraceDe(YSLib::Warning, "Invalid character '#x%X' found, ignored.",
-				unsigned(c));
+				unsigned(*p));
 			break;
 		case '&':
-			res += "&amp;";
+			esc = "&amp;";
 			break;
 		case '<':
-			res += "&lt;";
+			esc = "&lt;";
 			break;
 		case '>':
-			res += "&gt;";
+			esc = "&gt;";
 			break;
 		default:
-			res += c;
+			continue;
 		}
-	return res;
+		if(b != p)
+			f(string_view(b, size_t(p - b)));
+		if(!esc.empty())
+			f(esc);
+		b = p + 1;
+	}
+	if(b != e)
+		f(string_view(b, size_t(e - b)));
 }
 
 string
@@ -11,13 +11,13 @@
 /*!	\file NPLA.cpp
 \ingroup NPL
 \brief NPLA 公共接口。
-\version r1228
+\version r1236
 \author FrankHB <frankhb1989@gmail.com>
 \since build 663
 \par 创建时间:
 	2016-01-07 10:32:45 +0800
 \par 修改时间:
-	2017-07-12 21:20 +0800
+	2017-08-02 20:10 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -28,6 +28,7 @@
 #include "NPL/YModules.h"
 #include YFM_NPL_NPLA
 #include YFM_NPL_SContext
+#include <sstream> // for std::ostringstream;
 
 using namespace YSLib;
 
@@ -150,6 +151,278 @@ PrintNodeString(std::ostream& os, const ValueNode& node,
 namespace SXML
 {
 
+//! \since build 820
+namespace
+{
+
+/*!
+\brief SXML 文档节点的 XML 输出器。
+\note 直接输出到流，时间和空间开销和输出大小线性相关。
+
+为和拼接字符串的转换结果一致，输出内容的最后一个空格被延迟输出，
+	以便在元素内容结尾处被移除。
+*/
+class XMLWriter final
+{
+private:
+	std::ostream& stream;
+	IndentGenerator generate_indent;
+	//! \brief 需要跳过的输出的字符数。
+	size_t skip;
+	//! \brief 是否存在延迟输出的空格。
+	bool pending_space = {};
+
+public:
+	XMLWriter(std::ostream& os, IndentGenerator igen, size_t n = 0)
+		: stream(os), generate_indent(igen), skip(n)
+	{}
+
+	//! \brief 输出延迟的空格。
+	void
+	Flush()
+	{
+		if(pending_space)
+		{
+			pending_space = {};
+			Put(" ");
+		}
+	}
+
+private:
+	void
+	Put(string_view sv)
+	{
+		if(YB_UNLIKELY(skip != 0))
+		{
+			const auto n(std::min(skip, sv.length()));
+
+			sv.remove_prefix(n);
+			skip -= n;
+		}
+		if(!sv.empty())
+			stream.write(sv.data(), std::streamsize(sv.length()));
+	}
+
+public:
+	void
+	Write(string_view sv)
+	{
+		if(!sv.empty())
+		{
+			Flush();
+			if(sv.back() == ' ')
+			{
+				sv.remove_suffix(1);
+				pending_space = true;
+			}
+			Put(sv);
+		}
+	}
+
+private:
+	void
+	WriteAttributes(const TermNode&);
+
+	void
+	WriteBranch(const TermNode&, size_t, ParseOption);
+
+	void
+	WriteEscaped(string_view sv)
+	{
+		EscapeXML(sv, [this](string_view s){
+			Write(s);
+		});
+	}
+
+	PDefH(void, WriteIndent, size_t depth)
+		ImplExpr(Write("\n"), Write(generate_indent(depth)))
+
+public:
+	/*!
+	\brief 输出节点。
+	\note 最后参数指定是否对字符串节点去除字面量边界分隔符。
+	\sa ConvertDocumentNode
+	*/
+	void
+	WriteNode(const TermNode&, size_t, ParseOption, bool = {});
+
+private:
+	/*!
+	\brief 输出转义的字符串。
+	\return 转义结果是否非空。
+	\sa Deliteralize
+	\sa EscapeXML
+
+	输出的结果和 Deliteralize 转义结果等价。
+	*/
+	bool
+	WriteString(string_view, bool);
+};
+
+void
+XMLWriter::WriteAttributes(const TermNode& term)
+{
+	// NOTE: Attributes are small enough to be converted as a whole, so partial
+	//	result can be kept when exception is caught.
+	string res;
+
+	try
+	{
+		for(auto i(std::next(term.begin())); i != term.end(); ++i)
+			res += ' ' + ConvertAttributeNodeString(Deref(i));
+	}
+	CatchExpr(ystdex::bad_any_cast& e, YTraceDe(Warning,
+		"Conversion failed: <%s> to <%s>.", e.from(), e.to()))
+	Write(res);
+}
+
+void
+XMLWriter::WriteBranch(const TermNode& term, size_t depth, ParseOption opt)
+{
+	const auto& con(term.GetContainer());
+	auto i(con.cbegin());
+	const auto& str(Access<string>(Deref(i)));
+
+	++i;
+	if(str == "@")
+	{
+		WriteAttributes(term);
+		return;
+	}
+	if(opt == ParseOption::Attribute)
+		throw LoggedEvent("Invalid non-attribute term found.");
+	if(str == "*PI*")
+	{
+		if(i != con.cend())
+		{
+			Write("<?");
+			for(bool first(true); i != con.cend(); yunseq(++i, first = {}))
+			{
+				if(!first)
+					Write(" ");
+				WriteNode(Deref(i), depth, ParseOption::String, true);
+			}
+			Write("?>");
+		}
+		else
+			Write("<?>");
+		return;
+	}
+	if(str == "*ENTITY*" || str == "*NAMESPACES*")
+	{
+		if(opt == ParseOption::Strict)
+			throw ystdex::unimplemented();
+	}
+	else if(str == "*COMMENT*")
+		;
+	else if(!str.empty())
+	{
+		const bool is_content(str != "*TOP*");
+		string head('<' + str);
+
+		if(YB_UNLIKELY(!is_content && depth > 0))
+			YTraceDe(Warning, "Invalid *TOP* found.");
+		if(i != con.end())
+		{
+			if(!Deref(i).empty() && (i->begin())->Value == string("@"))
+			{
+				std::ostringstream oss;
+				XMLWriter writer(oss, generate_indent);
+
+				writer.WriteNode(*i, depth, ParseOption::Attribute, true);
+				writer.Flush();
+				head += oss.str();
+				if(++i == con.cend())
+				{
+					Write(head + " />");
+					return;
+				}
+			}
+			head += '>';
+		}
+		else
+		{
+			Write(head + " />");
+			return;
+		}
+		if(is_content)
+			Write(head);
+		else
+			Flush();
+
+		const auto child_depth(depth + size_t(is_content));
+		bool nl{};
+
+		for(bool first(true); i != con.cend(); yunseq(++i, first = {}))
+		{
+			nl = Deref(i).Value.GetType() != ystdex::type_id<string>();
+			if(nl)
+				WriteIndent(child_depth);
+			else if(!first)
+				Write(" ");
+			WriteNode(*i, child_depth, ParseOption::Normal, true);
+		}
+		// NOTE: The last space of the content is removed.
+		pending_space = {};
+		if(is_content)
+		{
+			if(nl)
+				WriteIndent(depth);
+			Write(ystdex::quote(str, "</", '>'));
+		}
+	}
+	else
+		throw LoggedEvent("Empty item found.", Warning);
+}
+
+void
+XMLWriter::WriteNode(const TermNode& term, size_t depth, ParseOption opt,
+	bool deliteralize)
+{
+	if(!term)
+		throw LoggedEvent("Empty term found.", Warning);
+	if(const auto p = AccessPtr<string>(term))
+		if(WriteString(*p, deliteralize))
+			return;
+	if(opt == ParseOption::String)
+		throw LoggedEvent("Invalid non-string term found.");
+	if(!term.empty())
+		TryExpr(WriteBranch(term, depth, opt))
+		CatchExpr(ystdex::bad_any_cast& e, YTraceDe(Warning,
+			"Conversion failed: <%s> to <%s>.", e.from(), e.to()))
+}
+
+bool
+XMLWriter::WriteString(string_view sv, bool deliteralize)
+{
+	// NOTE: Null characters are ignored by %EscapeXML, so they are also
+	//	skipped when checking the literal delimiters.
+	const auto b(sv.find_first_not_of(char()));
+
+	if(b != string_view::npos)
+	{
+		if(deliteralize)
+		{
+			const auto e(sv.find_last_not_of(char()) + 1);
+
+			if(CheckLiteral(sv.substr(b, e - b)) != char())
+			{
+				WriteEscaped(sv.substr(0, b));
+				WriteEscaped(sv.substr(b + 1, e - b - 2));
+				WriteEscaped(sv.substr(e));
+				return true;
+			}
+		}
+		WriteEscaped(sv);
+		return true;
+	}
+	WriteEscaped(sv);
+	return {};
+}
+
+} // unnamed namespace;
+
+
 string
 ConvertAttributeNodeString(const TermNode& term)
 {
@@ -178,122 +451,45 @@ string
 ConvertDocumentNode(const TermNode& term, IndentGenerator igen, size_t depth,
 	ParseOption opt)
 {
-	if(term)
-	{
-		string res(ConvertStringNode(term));
-
-		if(res.empty())
-		{
-			if(opt == ParseOption::String)
-				throw LoggedEvent("Invalid non-string term found.");
-
-			const auto& con(term.GetContainer());
+	std::ostringstream oss;
 
-			if(!con.empty())
-				try
-				{
-					auto i(con.cbegin());
-					const auto& str(Access<string>(Deref(i)));
-
-					++i;
-					if(str == "@")
-					{
-						for(; i != con.cend(); ++i)
-							res += ' ' + ConvertAttributeNodeString(Deref(i));
-						return res;
-					}
-					if(opt == ParseOption::Attribute)
-						throw LoggedEvent("Invalid non-attribute term found.");
-					if(str == "*PI*")
-					{
-						res = "<?";
-						for(; i != con.cend(); ++i)
-							res += string(Deliteralize(ConvertDocumentNode(
-								Deref(i), igen, depth, ParseOption::String)))
-								+ ' ';
-						if(!res.empty())
-							res.pop_back();
-						return res + "?>";
-					}
-					if(str == "*ENTITY*" || str == "*NAMESPACES*")
-					{
-						if(opt == ParseOption::Strict)
-							throw ystdex::unimplemented();
-					}
-					else if(str == "*COMMENT*")
-						;
-					else if(!str.empty())
-					{
-						const bool is_content(str != "*TOP*");
-						string head('<' + str);
-						bool nl{};
-
-						if(YB_UNLIKELY(!is_content && depth > 0))
-							YTraceDe(Warning, "Invalid *TOP* found.");
-						if(i != con.end())
-						{
-							if(!Deref(i).empty()
-								&& (i->begin())->Value == string("@"))
-							{
-								head += string(
-									Deliteralize(ConvertDocumentNode(*i, igen,
-									depth, ParseOption::Attribute)));
-								if(++i == con.cend())
-									return head + " />";
-							}
-							head += '>';
-						}
-						else
-							return head + " />";
-						for(; i != con.cend(); ++i)
-						{
-							nl = Deref(i).Value.GetType()
-								!= ystdex::type_id<string>();
-							if(nl)
-								res += '\n' + igen(depth + size_t(is_content));
-							else
-								res += ' ';
-							res += string(Deliteralize(ConvertDocumentNode(*i,
-								igen, depth + size_t(is_content))));
-						}
-						if(res.size() > 1 && res.front() == ' ')
-							res.erase(0, 1);
-						if(!res.empty() && res.back() == ' ')
-							res.pop_back();
-						if(is_content)
-						{
-							if(nl)
-								res += '\n' + igen(depth);
-							return head + res + ystdex::quote(str, "</", '>');
-						}
-					}
-					else
-						throw LoggedEvent("Empty item found.", Warning);
-				}
-				CatchExpr(ystdex::bad_any_cast& e, YTraceDe(Warning,
-					"Conversion failed: <%s> to <%s>.", e.from(), e.to()))
-		}
-		return res;
-	}
-	throw LoggedEvent("Empty term found.", Warning);
+	WriteDocumentNode(oss, term, igen, depth, opt);
+	return oss.str();
 }
 
 string
 ConvertStringNode(const TermNode& term)
 {
-	return ystdex::call_value_or(EscapeXML, AccessPtr<string>(term));
+	return ystdex::call_value_or(static_cast<string(&)(string_view)>(EscapeXML),
+		AccessPtr<string>(term));
 }
 
 void
 PrintSyntaxNode(std::ostream& os, const TermNode& term, IndentGenerator igen,
 	size_t depth)
 {
+	// NOTE: The first character is the newline before the first node
+	//	in '*TOP*', which is skipped.
 	if(IsBranch(term))
-		ystdex::write(os,
-			ConvertDocumentNode(Deref(term.begin()), igen, depth), 1);
+	{
+		XMLWriter writer(os, igen, 1);
+
+		writer.WriteNode(Deref(term.begin()), depth, ParseOption::Normal);
+		writer.Flush();
+	}
 	os << std::flush;
 }
 
+void
+WriteDocumentNode(std::ostream& os, const TermNode& term, IndentGenerator igen,
+	size_t depth, ParseOption opt)
+{
+	XMLWriter writer(os, igen);
+
+	writer.WriteNode(term, depth, opt);
+	writer.Flush();
+}
+
 
 ValueNode
 MakeXMLDecl(const string& name, const string& ver, const string& enc,
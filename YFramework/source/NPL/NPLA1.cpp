@@ -11,13 +11,13 @@
 /*!	\file NPLA1.cpp
 \ingroup NPL
 \brief NPLA1 公共接口。
-\version r4367
+\version r4384
 \author FrankHB <frankhb1989@gmail.com>
 \since build 473
 \par 创建时间:
 	2014-02-02 18:02:47 +0800
 \par 修改时间:
-	2017-07-12 21:16 +0800
+	2017-08-05 14:20 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -29,7 +29,8 @@
 #include YFM_NPL_NPLA1 // for ystdex::bind1, unordered_map, ystdex::pvoid,
 //	ystdex::call_value_or, ystdex::as_const, ystdex::ref;
 #include <ystdex/cast.hpp> // for ystdex::polymorphic_downcast;
-#include <ystdex/scope_guard.hpp> // for ystdex::unique_guard;
+#include <ystdex/scope_guard.hpp> // for ystdex::unique_guard,
+//	ystdex::make_guard;
 #include YFM_NPL_SContext // for Session;
 
 using namespace YSLib;
@@ -150,6 +151,49 @@ TransformNodeSequence(const TermNode& term, NodeMapper mapper, NodeMapper
 namespace
 {
 
+//! \since build 823
+//@{
+/*!
+\brief 接受尾调用：判断项是否可作为尾调用被继续规约。
+\sa ContextNode::TailTerm
+
+若项是上下文的尾项，则清除尾项，表示之后由调用者继续规约此项。
+*/
+bool
+AcceptTailCall(const TermNode& term, ContextNode& ctx) ynothrow
+{
+	if(ctx.TailTerm.get() == &term)
+	{
+		ctx.TailTerm = {};
+		return true;
+	}
+	return {};
+}
+
+/*!
+\brief 调用形式的处理例程并转换异常。
+\sa FormContextHandler::operator()
+*/
+template<typename _func>
+ReductionStatus
+InvokeFormHandler(_func f)
+{
+	try
+	{
+		return f();
+	}
+	CatchExpr(NPLException&, throw)
+	// TODO: Use semantic exceptions.
+	CatchThrow(ystdex::bad_any_cast& e, LoggedEvent(
+		ystdex::sfmt("Mismatched types ('%s', '%s') found.",
+		e.from(), e.to()), Warning))
+	// TODO: Use nested exceptions?
+	CatchThrow(std::exception& e, LoggedEvent(e.what(), Err))
+	// XXX: Use distinct status for failure?
+	return ReductionStatus::Clean;
+}
+//@}
+
 //! \since build 736
 template<typename _func>
 TermNode
@@ -391,6 +435,10 @@ public:
 		p_closure(share_move(term))
 	{}
 
+	//! \since build 823
+	DefGetter(const ynothrow, const weak_ptr<Environment>&, ParentPtr,
+		p_parent)
+
 	//! \since build 772
 	ReductionStatus
 	operator()(TermNode& term, ContextNode& ctx) const
@@ -405,7 +453,9 @@ public:
 			//	to be cared) form the context would cause undefined behavior
 			//	(e.g. returning a reference to automatic object in the host
 			//	language). See %BindParameter.
-			ContextNode local(local_prototype, make_shared<Environment>());
+			auto p_local(make_shared<ContextNode>(local_prototype,
+				make_shared<Environment>()));
+			auto& local(*p_local);
 			auto& local_m(local.GetBindingsRef());
 
 			// NOTE: Bound dynamic context.
@@ -421,9 +471,22 @@ public:
 				p_static.use_count() != 0 ? "owning" : "nonowning",
 				formals.size());
 			// NOTE: Static environment is bound as base of local context by
-			//	setting parent environment pointer.
-			local.GetRecordRef().Parent = p_parent;
-			// NOTE: Beta reduction.
+			//	setting parent environment pointer. The owning pointer is used
+			//	if any, since the handler can be released before the body is
+			//	reduced.
+			if(p_static)
+				local.GetRecordRef().Parent = p_static;
+			else
+				local.GetRecordRef().Parent = p_parent;
+			// NOTE: Beta reduction. It is a proper tail call when accepted,
+			//	where the body is reduced in place by the caller (%Reduce) in
+			//	the local context.
+			if(AcceptTailCall(term, ctx))
+			{
+				term.SetContent(Deref(p_closure));
+				ctx.TailContext = std::move(p_local);
+				return ReductionStatus::Retrying;
+			}
 			// TODO: Implement accurate lifetime analysis rather than
 			//	'p_closure.unique()'.
 			ReduceCheckedClosure(term, local, {}, *p_closure);
@@ -435,6 +498,136 @@ public:
 };
 
 
+//! \since build 823
+//@{
+//! \brief 取上下文处理器包装的 VauHandler 。
+observer_ptr<const VauHandler>
+AccessVauHandlerPtr(const ContextHandler& h)
+{
+	auto p_h(make_observer(&h));
+
+	while(true)
+	{
+		if(const auto p = p_h->target<VauHandler>())
+			return make_observer(p);
+		if(const auto p = p_h->target<FormContextHandler>())
+			p_h = make_observer(&p->Handler);
+		else if(const auto p_strict = p_h->target<StrictContextHandler>())
+			p_h = make_observer(&p_strict->Handler.Handler);
+		else
+			return {};
+	}
+}
+
+
+/*!
+\brief 环境标记：标记规约中仍可能被引用的环境。
+\note 只检查环境的绑定、父环境和 VauHandler 的静态环境中的环境引用。
+
+从指定上下文的环境和项出发标记候选环境，
+	以释放被替换的尾上下文中不再被引用的环境。
+除候选环境和起始环境外，其它环境只检查父环境而不检查绑定。
+*/
+class EnvironmentMarker final
+{
+private:
+	//! \brief 候选环境：未被标记的环境。
+	vector<shared_ptr<Environment>>& candidates;
+	//! \brief 已标记的候选环境。
+	vector<shared_ptr<Environment>> marked{};
+	//! \brief 已访问的环境。
+	vector<observer_ptr<const Environment>> visited{};
+	//! \brief 待检查的环境：已访问的环境和是否检查绑定。
+	vector<pair<observer_ptr<const Environment>, bool>> pending{};
+
+public:
+	EnvironmentMarker(vector<shared_ptr<Environment>>& envs)
+		: candidates(envs)
+	{}
+
+	/*!
+	\brief 保留可达的候选环境：释放从参数不可达的候选环境。
+	\note 不检查其它上下文中的引用。
+	*/
+	void
+	Retain(const ContextNode& ctx, const TermNode& term)
+	{
+		if(!candidates.empty())
+		{
+			Visit(make_observer(&ctx.GetRecordRef()), true);
+			MarkNode(term);
+			// NOTE: Only environments are traversed iteratively, since
+			//	parent chains can be long in tail calls.
+			while(!pending.empty() && !candidates.empty())
+			{
+				const auto pr(pending.back());
+				const auto& env(Deref(pr.first));
+
+				pending.pop_back();
+				if(pr.second)
+					MarkNode(env.Bindings);
+				MarkValue(env.Parent);
+			}
+			candidates = std::move(marked);
+		}
+	}
+
+private:
+	void
+	MarkNode(const ValueNode& node)
+	{
+		MarkValue(node.Value);
+		for(const auto& nd : node)
+			MarkNode(nd);
+	}
+
+	void
+	MarkValue(const ValueObject& vo)
+	{
+		const auto& tp(vo.GetType());
+
+		if(tp == ystdex::type_id<EnvironmentList>())
+			for(const auto& v : vo.GetObject<EnvironmentList>())
+				MarkValue(v);
+		else if(tp == ystdex::type_id<observer_ptr<const Environment>>())
+			Visit(vo.GetObject<observer_ptr<const Environment>>());
+		else if(tp == ystdex::type_id<weak_ptr<Environment>>())
+			Visit(make_observer(
+				vo.GetObject<weak_ptr<Environment>>().lock().get()));
+		else if(tp == ystdex::type_id<shared_ptr<Environment>>())
+			Visit(make_observer(
+				vo.GetObject<shared_ptr<Environment>>().get()));
+		else if(tp == ystdex::type_id<ContextHandler>())
+			if(const auto p
+				= AccessVauHandlerPtr(vo.GetObject<ContextHandler>()))
+				Visit(make_observer(p->GetParentPtr().lock().get()));
+	}
+
+	void
+	Visit(observer_ptr<const Environment> p, bool start = {})
+	{
+		if(p && std::find(visited.cbegin(), visited.cend(), p)
+			== visited.cend())
+		{
+			const auto i(std::find_if(candidates.begin(), candidates.end(),
+				[&](const shared_ptr<Environment>& p_env) ynothrow{
+				return p_env.get() == p.get();
+			}));
+			const bool found(i != candidates.end());
+
+			visited.push_back(p);
+			if(found)
+			{
+				marked.push_back(std::move(*i));
+				candidates.erase(i);
+			}
+			pending.emplace_back(p, start || found);
+		}
+	}
+};
+//@}
+
+
 //! \since build 781
 template<typename _func>
 void
@@ -522,22 +715,63 @@ ReductionStatus
 Reduce(TermNode& term, ContextNode& ctx)
 {
 	const auto gd(InvokeGuard(term, ctx));
-
-	// NOTE: Rewriting loop until the normal form is got.
-	return ystdex::retry_on_cond(CheckReducible, [&]() -> ReductionStatus{
+	// NOTE: The tail term of the caller is restored on exit, since nested
+	//	calls (e.g. for arguments) share the context.
+	const auto p_term(ctx.TailTerm);
+	const auto gd_tail(ystdex::make_guard([&, p_term]() ynothrow{
+		ctx.TailTerm = p_term;
+	}));
+
+	ctx.TailTerm = {};
+	// NOTE: The context is switched in place for tail calls, without nested
+	//	calls of %Reduce.
+	shared_ptr<ContextNode> p_tail;
+	auto p_ctx(make_observer(&ctx));
+	// NOTE: Environments of replaced tail contexts can be still referenced by
+	//	weak pointers (e.g. static environments of closures or dynamic
+	//	environments of operatives). They are retained only when reachable
+	//	from the current tail context. See %EnvironmentMarker.
+	vector<shared_ptr<Environment>> envs;
+	bool tail_called{};
+	const auto reduce_once([&]() -> ReductionStatus{
 		if(IsBranch(term))
 		{
 			YAssert(term.size() != 0, "Invalid node found.");
 			if(term.size() != 1)
-				// NOTE: List evaluation.
-				return InvokeList(term, ctx);
-			else
 			{
-				// NOTE: List with single element shall be reduced as the
-				//	element.
-				LiftFirst(term);
-				return Reduce(term, ctx);
+				// NOTE: List evaluation. Only handlers called directly on the
+				//	term accept the tail call.
+				p_ctx->TailTerm = make_observer(&term);
+
+				const auto r(InvokeList(term, *p_ctx));
+
+				if(p_ctx->TailTerm)
+					p_ctx->TailTerm = {};
+				else
+					tail_called = true;
+				if(p_ctx->TailContext)
+				{
+					auto p_next(std::move(p_ctx->TailContext));
+
+					if(p_tail)
+					{
+						envs.push_back(p_tail->ShareRecord());
+						// NOTE: See %ReduceCheckedClosure. This makes the term
+						//	not refer to objects in the replaced environment.
+						term.SetContent(term.CreateWith(
+							&ValueObject::MakeMoveCopy),
+							term.Value.MakeMoveCopy());
+					}
+					p_tail = std::move(p_next);
+					p_ctx = make_observer(p_tail.get());
+					EnvironmentMarker(envs).Retain(*p_tail, term);
+				}
+				return r;
 			}
+			// NOTE: List with single element shall be reduced as the
+			//	element.
+			LiftFirst(term);
+			return ReductionStatus::Retrying;
 		}
 
 		const auto& tp(term.Value.GetType());
@@ -545,8 +779,21 @@ Reduce(TermNode& term, ContextNode& ctx)
 		// NOTE: Empty list or special value token has no-op to do with.
 		// TODO: Handle special value token?
 		return tp != ystdex::type_id<void>() && tp != ystdex::type_id<
-			ValueToken>() ? InvokeLeaf(term, ctx) : ReductionStatus::Clean;
+			ValueToken>() ? InvokeLeaf(term, *p_ctx) : ReductionStatus::Clean;
 	});
+	// NOTE: Rewriting loop until the normal form is got. The reduction after
+	//	a tail call was in the form handler of the caller, so exceptions are
+	//	converted in the same way.
+	const auto res(ystdex::retry_on_cond(CheckReducible,
+		[&]() -> ReductionStatus{
+		return tail_called ? InvokeFormHandler(reduce_once) : reduce_once();
+	}));
+
+	if(p_tail)
+		// NOTE: See %ReduceCheckedClosure.
+		term.SetContent(term.CreateWith(&ValueObject::MakeMoveCopy),
+			term.Value.MakeMoveCopy());
+	return res;
 }
 
 void
@@ -631,6 +878,14 @@ ReduceFirst(TermNode& term, ContextNode& ctx)
 ReductionStatus
 ReduceOrdered(TermNode& term, ContextNode& ctx)
 {
+	if(IsBranch(term) && term.size() > 1 && AcceptTailCall(term, ctx))
+	{
+		ReduceChildrenOrdered(term.begin(), std::prev(term.end()), ctx);
+		// NOTE: The last term is to be reduced by the caller as a tail call.
+		LiftTerm(term, *term.rbegin());
+		return ReductionStatus::Retrying;
+	}
+
 	const auto res(ReduceChildrenOrdered(term, ctx));
 
 	if(IsBranch(term))
@@ -717,22 +972,12 @@ ReductionStatus
 FormContextHandler::operator()(TermNode& term, ContextNode& ctx) const
 {
 	// TODO: Is it worth matching specific builtin special forms here?
-	try
-	{
+	return InvokeFormHandler([&]() -> ReductionStatus{
 		if(!Check || Check(term))
 			return Handler(term, ctx);
 		// TODO: Use more specific exception type?
 		throw std::invalid_argument("Term check failed.");
-	}
-	CatchExpr(NPLException&, throw)
-	// TODO: Use semantic exceptions.
-	CatchThrow(ystdex::bad_any_cast& e, LoggedEvent(
-		ystdex::sfmt("Mismatched types ('%s', '%s') found.",
-		e.from(), e.to()), Warning))
-	// TODO: Use nested exceptions?
-	CatchThrow(std::exception& e, LoggedEvent(e.what(), Err))
-	// XXX: Use distinct status for failure?
-	return ReductionStatus::Clean;
+	});
 }
 
 
@@ -939,7 +1184,40 @@ REPLContext::LoadFrom(std::streambuf& buf)
 {
 	using s_it_t = std::istreambuf_iterator<char>;
 
-	Process(Session(s_it_t(&buf), s_it_t()));
+	if(StatementSeparator != char())
+	{
+		Session sess;
+		size_t depth(0);
+		char prev{};
+		const auto process_statement([&]{
+			auto term(SContext::Analyze(sess));
+
+			sess.Lexer = LexicalAnalyzer();
+			if(IsBranch(term))
+				Process(term);
+		});
+
+		// NOTE: Parentheses and separators are only counted out of literals.
+		std::for_each(s_it_t(&buf), s_it_t(), [&](char c){
+			if(sess.Lexer.GetQuotes().size() % 2 == 0 && prev != '\\')
+			{
+				if(c == StatementSeparator && depth == 0)
+				{
+					prev = c;
+					return process_statement();
+				}
+				if(c == '(')
+					++depth;
+				else if(c == ')' && depth != 0)
+					--depth;
+			}
+			Session::DefaultParseByte(sess.Lexer, c);
+			prev = c;
+		});
+		process_statement();
+	}
+	else
+		Process(Session(s_it_t(&buf), s_it_t()));
 }
 
 TermNode
@@ -1313,10 +1591,17 @@ Eval(TermNode& term, ContextNode& ctx)
 
 	const auto i(std::next(term.begin()));
 	// TODO: Support more environment types?
-	ContextNode c(ctx, ResolveEnvironment(Deref(std::next(i)).Value).first);
+	auto p_ctx(make_shared<ContextNode>(ctx,
+		ResolveEnvironment(Deref(std::next(i)).Value).first));
 
 	LiftTerm(term, Deref(i));
-	return Reduce(term, c);
+	if(AcceptTailCall(term, ctx))
+	{
+		// NOTE: The expression is to be reduced by the caller as a tail call.
+		ctx.TailContext = std::move(p_ctx);
+		return ReductionStatus::Retrying;
+	}
+	return Reduce(term, *p_ctx);
 }
 
 void
@@ -11,13 +11,13 @@
 /*!	\file FileIO.cpp
 \ingroup YCLib
 \brief 平台相关的文件访问和输入/输出接口。
-\version r3106
+\version r3115
 \author FrankHB <frankhb1989@gmail.com>
 \since build 615
 \par 创建时间:
 	2015-07-14 18:53:12 +0800
 \par 修改时间:
-	2017-02-02 18:29 +0800
+	2017-08-05 17:10 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -36,8 +36,10 @@
 //	::ftruncate, ::fsync, ::_wgetcwd, ::getcwd, ::chdir, ::rmdir, ::unlink,
 //	!defined(__STRICT_ANSI__) API, ::GetCurrentDirectoryW; 
 #include YFM_YCLib_FileSystem // for NodeCategory::*, CategorizeNode;
+#include YFM_YCLib_MemoryMapping // for MappedFile, FileMappingAdvice;
 #include <ystdex/functional.hpp> // for ystdex::compose, ystdex::addrof;
 #include <ystdex/streambuf.hpp> // for ystdex::streambuf_equal;
+#include <cstring> // for std::memcmp;
 #if YCL_DS
 #	include "CHRLib/YModules.h"
 #	include YFM_CHRLib_CharacterProcessing // for CHRLib::MakeMBCS,
@@ -78,6 +80,12 @@ using platform_ex::MakePathStringW;
 #	include YFM_CHRLib_CharacterProcessing // for CHRLib::MakeMBCS,
 //	CHRLib::MakeUCS2LE;
 #	include <sys/file.h> // for ::flock, LOCK_*;
+#	if YCL_Linux
+#		include <sys/ioctl.h> // for ::ioctl;
+#		include <sys/sendfile.h> // for ::sendfile;
+#		include <sys/syscall.h> // for SYS_copy_file_range;
+#		include <linux/fs.h> // for FICLONE;
+#	endif
 
 //! \since build 475
 using namespace CHRLib;
@@ -320,6 +328,108 @@ UnlockFileDescriptor(int fd, const char* sig) ynothrowv
 }
 #endif
 
+#if YCL_Linux
+//! \since build 804
+//@{
+//! \brief 单次内核复制调用的最大字节数。
+yconstexpr const size_t KernelCopyChunk(size_t(1) << 30);
+
+//! \brief 判断错误是否表示内核复制方式对指定的文件不适用。
+inline PDefH(bool, IsKernelCopyUnsupported, int err) ynothrow
+	ImplRet(err == ENOSYS || err == EXDEV || err == EINVAL
+		|| err == EOPNOTSUPP || err == ENOTSUP || err == EBADF
+		|| err == ETXTBSY || err == EPERM)
+
+/*!
+\brief 使用内核复制调用从文件当前位置复制至文件末尾。
+\return 是否复制了至少指定的剩余字节数并到达文件末尾；
+	否则剩余字节数被更新，可回退为其它方式。
+\throw std::system_error 复制失败。
+
+调用按文件描述的当前位置复制并更新位置，因此失败时可从当前位置继续复制。
+剩余字节数仅作为单次调用的上界，文件末尾以调用返回 0 确认。
+剩余字节数未复制完时调用返回 0 视为不适用，以避免特殊文件系统报告错误的大小时
+	丢失数据。
+*/
+template<typename _func>
+YB_NONNULL(3) bool
+CopyByKernel(_func f, ::off_t& rest, const char* sig)
+{
+	while(true)
+	{
+		const auto n(f(size_t(rest > 0 ? std::min< ::off_t>(rest,
+			KernelCopyChunk) : ::off_t(KernelCopyChunk))));
+
+		if(n > 0)
+			rest -= ::off_t(n);
+		else if(n == 0)
+			return rest <= 0;
+		else if(errno != EINTR)
+		{
+			if(IsKernelCopyUnsupported(errno))
+				return {};
+			YCL_Raise_SysE(, "Failed copying file by kernel", sig);
+		}
+	}
+}
+
+/*!
+\brief 尝试使用内核支持复制文件内容。
+\return 是否已复制源文件当前位置起的所有内容。
+\throw std::system_error 复制失败。
+\note 依次尝试 FICLONE 、 \c copy_file_range 和 \c ::sendfile 。
+\note 源文件不是常规文件或大小不大于当前位置时不复制。
+
+仅当源和目标的当前位置为 0 且目标为空的常规文件时使用 FICLONE 共享存储，
+	并在成功后设置源和目标的当前位置为文件末尾。
+*/
+bool
+CopyContentByKernel(int ofd, int ifd)
+{
+	struct ::stat st;
+
+	if(::fstat(ifd, &st) == 0 && S_ISREG(st.st_mode))
+	{
+		const auto cur(::lseek(ifd, 0, SEEK_CUR));
+
+		// NOTE: Files with size not reliable (e.g. in procfs or sysfs) are
+		//	left to be read by the caller, since the size is not the end.
+		if(cur < 0 || cur >= st.st_size)
+			return {};
+#	ifdef FICLONE
+		struct ::stat ost;
+
+		if(cur == 0 && ::fstat(ofd, &ost) == 0 && S_ISREG(ost.st_mode)
+			&& ost.st_size == 0 && ::lseek(ofd, 0, SEEK_CUR) == 0
+			&& ::ioctl(ofd, FICLONE, ifd) == 0)
+		{
+			YCL_CallF_CAPI(, ::lseek, ifd, 0, SEEK_END);
+			YCL_CallF_CAPI(, ::lseek, ofd, 0, SEEK_END);
+			return true;
+		}
+#	endif
+
+		auto rest(st.st_size - cur);
+
+#	ifdef SYS_copy_file_range
+		// NOTE: The system call is used directly since the wrapper is only
+		//	provided since glibc 2.27.
+		if(CopyByKernel([=](size_t len) ynothrow{
+			return ::ssize_t(::syscall(SYS_copy_file_range, ifd,
+				static_cast<::loff_t*>(nullptr), ofd,
+				static_cast<::loff_t*>(nullptr), len, 0U));
+		}, rest, yfsig))
+			return true;
+#	endif
+		return CopyByKernel([=](size_t len) ynothrow{
+			return ::sendfile(ofd, ifd, {}, len);
+		}, rest, yfsig);
+	}
+	return {};
+}
+//@}
+#endif
+
 //! \since build 660
 bool
 IsNodeShared_Impl(const char* a, const char* b, bool follow_link) ynothrow
@@ -370,6 +480,71 @@ HaveSameContents_Impl(const _tChar* path_a, const _tChar* path_b, mode_t mode)
 	return {};
 }
 
+#if YF_Hosted && !YCL_Win32
+//! \since build 806
+//@{
+//! \brief 映射比较时单次比较的字节数。
+yconstexpr const size_t MappedCompareChunk(size_t(1) << 24);
+
+/*!
+\brief 比较常规文件从当前位置起的内容。
+\return 若不适用或映射失败则为 -1 ，否则为表示是否相等的 0 或 1 。
+\note 首先比较剩余大小，相等时映射文件并分块比较。
+\note 映射使用复制的文件描述符，不转移文件的所有权。
+*/
+int
+CompareRegularFileContents(UniqueFile& p_a, UniqueFile& p_b)
+{
+	struct ::stat st_a, st_b;
+
+	if(::fstat(*p_a.get(), &st_a) == 0 && ::fstat(*p_b.get(), &st_b) == 0
+		&& S_ISREG(st_a.st_mode) && S_ISREG(st_b.st_mode))
+	{
+		const auto pos_a(::lseek(*p_a.get(), 0, SEEK_CUR)),
+			pos_b(::lseek(*p_b.get(), 0, SEEK_CUR));
+
+		if(pos_a >= 0 && pos_b >= 0 && pos_a <= st_a.st_size
+			&& pos_b <= st_b.st_size)
+		{
+			const auto n(std::uint64_t(st_a.st_size - pos_a));
+
+			if(n != std::uint64_t(st_b.st_size - pos_b))
+				return 0;
+			if(n == 0)
+				return 1;
+			// NOTE: Large files are not mapped to avoid exhausting address
+			//	space on 32-bit platforms.
+			if(std::uint64_t(std::max(st_a.st_size, st_b.st_size))
+				<= std::uint64_t(size_t(-1) >> 3))
+				try
+				{
+					const MappedFile m_a(UniqueFile(::dup(*p_a.get()))),
+						m_b(UniqueFile(::dup(*p_b.get())));
+					const auto p(m_a.GetPtr() + pos_a);
+					const auto q(m_b.GetPtr() + pos_b);
+					const auto len(static_cast<size_t>(n));
+
+					m_a.Advise(size_t(pos_a), len,
+						FileMappingAdvice::Sequential);
+					m_b.Advise(size_t(pos_b), len,
+						FileMappingAdvice::Sequential);
+					for(size_t off(0); off < len; off += MappedCompareChunk)
+						if(std::memcmp(p + off, q + off,
+							std::min(len - off, MappedCompareChunk)) != 0)
+							return 0;
+					return 1;
+				}
+				// NOTE: The original files are still owned by the caller, so
+				//	files which cannot be mapped are compared by streams.
+				CatchExpr(std::exception& e, YTraceDe(Descriptions::Informative,
+					"Failed mapping files for comparison: %s.", e.what()))
+		}
+	}
+	return -1;
+}
+//@}
+#endif
+
 } // unnamed namespace;
 
 
@@ -698,6 +873,13 @@ void
 FileDescriptor::WriteContent(FileDescriptor ofd, FileDescriptor ifd,
 	size_t size)
 {
+#if YCL_Linux
+	YAssertNonnull(ifd),
+	YAssertNonnull(ofd);
+	if(CopyContentByKernel(*ofd, *ifd))
+		return;
+#endif
+
 	ystdex::temporary_buffer<byte> buf(size);
 
 	WriteContent(ofd, ifd, buf.get().get(), buf.size());
@@ -1247,6 +1429,13 @@ HaveSameContents(UniqueFile p_a, UniqueFile p_b, const char* name_a,
 	{
 		if(IsNodeShared(p_a.get(), p_b.get()))
 			return true;
+#if YF_Hosted && !YCL_Win32
+
+		const auto res(CompareRegularFileContents(p_a, p_b));
+
+		if(res >= 0)
+			return res != 0;
+#endif
 
 		filebuf fb_a, fb_b;
 
@@ -11,13 +11,13 @@
 /*!	\file FileSystem.cpp
 \ingroup YCLib
 \brief 平台相关的文件系统接口。
-\version r4302
+\version r4311
 \author FrankHB <frankhb1989@gmail.com>
 \since build 312
 \par 创建时间:
 	2012-05-30 22:41:35 +0800
 \par 修改时间:
-	2017-01-27 17:01 +0800
+	2017-07-24 15:02 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -37,7 +37,8 @@
 //	ystdex::restrict_length, std::min, ystdex::ntctsicmp,
 //	std::errc::invalid_argument, std::strchr; , std::errc::invalid_argument
 #include YFM_YCLib_NativeAPI // for Mode, struct ::stat, ::stat,
-//	::GetFileAttributesW, ::linkat, ::symlink, ::lstat, ::readlink;
+//	::GetFileAttributesW, ::linkat, ::symlink, ::lstat, ::readlink, ::dirfd,
+//	::fstatat, AT_SYMLINK_NOFOLLOW, DT_UNKNOWN, DTTOIF;
 #include "CHRLib/YModules.h"
 #include YFM_CHRLib_CharacterProcessing // for CHRLib::MakeUCS2LE;
 #include <ystdex/ctime.h> // for ystdex::is_date_range_valid,
@@ -326,6 +327,16 @@ namespace
 PDefH(::DIR*, ToDirPtr, DirectorySession::NativeHandle p)
 	ImplRet(static_cast<::DIR*>(p))
 
+#	if !YCL_DS && defined(DT_UNKNOWN)
+//! \since build 805
+yconstfn PDefH(mode_t, ToModeFromDirentType, unsigned char t) ynothrow
+#		ifdef DTTOIF
+	ImplRet(mode_t(DTTOIF(t)))
+#		else
+	ImplRet(mode_t(t) << 12)
+#		endif
+#	endif
+
 } // unnamed namespace;
 #endif
 void
@@ -440,24 +451,37 @@ HDirectory::GetNodeCategory() const ynothrow
 
 		try
 		{
-			auto name(sDirPath + Deref(p_dirent).d_name);
 			struct ::stat st;
 
 #	if YCL_DS
-#		define YCL_Impl_lstatn ::stat
+			auto name(sDirPath + Deref(p_dirent).d_name);
+
+			// XXX: Value of %errno might be overwritten.
+			if(YCL_TraceCallF_CAPI(::stat, name.c_str(), &st) == 0)
+				res |= CategorizeNode(st.st_mode);
 #	else
-#		define YCL_Impl_lstatn ::lstat
-#	endif
-			// TODO: Simplify.
+			const auto& ent(Deref(p_dirent));
+			const auto name(&ent.d_name[0]);
+			// NOTE: Paths are resolved relative to the opened directory to
+			//	avoid concatenation of the directory path and the name.
+			const int fd(::dirfd(ToDirPtr(GetNativeHandle())));
+
+			// NOTE: The type reported by the file system is used without
+			//	calls of %::fstatat unless it is unknown or a symbolic link
+			//	needs to be resolved.
+#		ifdef DT_UNKNOWN
+			if(ent.d_type != DT_UNKNOWN)
+				res |= CategorizeNode(ToModeFromDirentType(ent.d_type));
+			else
+#		endif
 			// XXX: Value of %errno might be overwritten.
-			if(YCL_TraceCallF_CAPI(YCL_Impl_lstatn, name.c_str(), &st) == 0)
+			if(YCL_TraceCallF_CAPI(::fstatat, fd, name, &st,
+				AT_SYMLINK_NOFOLLOW) == 0)
 				res |= CategorizeNode(st.st_mode);
-#	if !YCL_DS
 			if(bool(res & NodeCategory::Link)
-				&& YCL_TraceCallF_CAPI(::stat, name.c_str(), &st) == 0)
+				&& YCL_TraceCallF_CAPI(::fstatat, fd, name, &st, 0) == 0)
 				res |= CategorizeNode(st.st_mode);
 #	endif
-#	undef YCL_Impl_lstatn
 		}
 		CatchExpr(std::exception& e, YTraceDe(Warning, "Failed getting node "
 			"category (errno = %d) @ %s: %s.", errno, yfsig, e.what()))
@@ -13,13 +13,13 @@
 \ingroup YCLibLimitedPlatforms
 \ingroup Host
 \brief YCLib 宿主平台公共扩展。
-\version r667
+\version r673
 \author FrankHB <frankhb1989@gmail.com>
 \since build 492
 \par 创建时间:
 	2014-04-09 19:03:55 +0800
 \par 修改时间:
-	2017-05-31 23:47 +0800
+	2017-08-06 17:05 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -35,9 +35,20 @@
 //	MakePathString, YCL_CallF_CAPI;
 #include YFM_YSLib_Core_YException // for YSLib::FilterExceptions;
 #include <stdlib.h> // for ::putenv, ::setenv;
+#include <atomic> // for std::atomic;
+#include <cstdlib> // for std::getenv, std::strtol;
+#if !YCL_Win32
+#	include <spawn.h> // for ::posix_spawn_file_actions_t, ::posix_spawnp;
+#	include <sys/wait.h> // for ::waitpid, WIFEXITED, WEXITSTATUS;
+#	include <ystdex/scope_guard.hpp> // for ystdex::make_guard;
+
+//! \since build 814
+extern "C" char** environ;
+#endif
 #if YCL_Win32
 #	include <limits> // for std::numeric_limits;
-#	include YFM_Win32_YCLib_NLS // for CloseHandle, MBCSToMBCS;
+#	include YFM_Win32_YCLib_NLS // for CloseHandle, MBCSToMBCS, UTF8ToWCS,
+//	::CreateProcessW, ::ReadFile, Win32Exception;
 #	include YFM_Win32_YCLib_Consoles // for WConsole;
 #endif
 #if YF_Hosted
@@ -310,6 +321,340 @@ FetchCachedCommandResult(const string& cmd, size_t buf_size)
 	return cache[string()];
 }
 
+//! \since build 813
+namespace
+{
+
+//! \brief 计算稳定的 64 位 FNV-1a 散列值，用于跨进程一致的缓冲项文件名。
+std::uint64_t
+HashCommandKey(const string& key) ynothrow
+{
+	std::uint64_t res(0xCBF29CE484222325ULL);
+
+	for(const auto c : key)
+	{
+		res ^= std::uint64_t(static_cast<unsigned char>(c));
+		res *= 0x100000001B3ULL;
+	}
+	return res;
+}
+
+void
+AppendCommandKeyEnv(string& key, const char* name)
+{
+	key += name;
+	key += '=';
+	if(const auto val = std::getenv(name))
+		key += val;
+	key += '\0';
+}
+
+string
+MakeCommandKey(const string& cmd, const vector<string>& envs,
+	const vector<string>& deps)
+{
+	string key(cmd);
+
+	key += '\0';
+	TryExpr(key += platform::FetchCurrentWorkingDirectory<char>(
+		yimpl(256)))
+	CatchIgnore(std::system_error&)
+	key += '\0';
+	AppendCommandKeyEnv(key, "PATH");
+	for(const auto& name : envs)
+		AppendCommandKeyEnv(key, name.c_str());
+	for(const auto& dep : deps)
+	{
+		key += dep;
+		key += '@';
+		// NOTE: Missing files are recorded distinctly rather than failed.
+		TryExpr(key += to_string(platform::GetFileModificationTimeOf(
+			dep.c_str(), true).count()))
+		CatchExpr(std::exception&, key += '?')
+		key += '\0';
+	}
+	return key;
+}
+
+//! \brief 读取缓冲项，若成功且键匹配则写入结果。
+bool
+ReadCommandCacheEntry(const char* path, const string& key,
+	pair<string, int>& res)
+{
+	if(const auto fp = ystdex::unique_raw(platform::ufopen(path, "rb"),
+		std::fclose))
+	{
+		string content;
+		char buf[4096];
+
+		for(size_t n; (n = std::fread(buf, 1, sizeof(buf), fp.get())) != 0; )
+			content.append(buf, n);
+		if(!std::ferror(fp.get()))
+		{
+			// NOTE: The layout is "<key size>\n<key><exit code>\n<output>".
+			const auto pos(content.find('\n'));
+
+			if(pos != string::npos && content.compare(0, pos,
+				to_string(key.size())) == 0 && content.compare(pos + 1,
+				key.size(), key) == 0)
+			{
+				const auto code_pos(pos + 1 + key.size());
+				const auto code_end(content.find('\n', code_pos));
+
+				if(code_end != string::npos)
+				{
+					char* end;
+					const auto code(std::strtol(&content[code_pos], &end, 10));
+
+					if(end == &content[code_end])
+					{
+						res = {content.substr(code_end + 1), int(code)};
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return {};
+}
+
+//! \brief 写入缓冲项：先写入唯一的临时文件再替换目标，保证读取者不观察到部分写入。
+void
+WriteCommandCacheEntry(const string& path, const string& key,
+	const pair<string, int>& res)
+{
+	static std::atomic<unsigned long> counter;
+#	if YCL_Win32
+	const auto pid(::GetCurrentProcessId());
+#	else
+	const auto pid(::getpid());
+#	endif
+	const auto tmp(path + '.' + to_string(pid) + '.' + to_string(++counter)
+		+ ".tmp");
+	bool written = {};
+
+	if(const auto fp = ystdex::unique_raw(platform::ufopen(tmp.c_str(), "wb"),
+		std::fclose))
+	{
+		const auto header(to_string(key.size()) + '\n' + key
+			+ to_string(res.second) + '\n');
+
+		written = std::fwrite(header.data(), 1, header.size(), fp.get())
+			== header.size() && std::fwrite(res.first.data(), 1,
+			res.first.size(), fp.get()) == res.first.size()
+			&& std::fflush(fp.get()) == 0;
+	}
+	if(written)
+	{
+#	if YCL_Win32
+		written = ::MoveFileExW(platform::MakePathStringW(tmp).c_str(),
+			platform::MakePathStringW(path).c_str(),
+			MOVEFILE_REPLACE_EXISTING);
+#	else
+		written = std::rename(tmp.c_str(), path.c_str()) == 0;
+#	endif
+	}
+	if(!written)
+	{
+		YTraceDe(Warning, "Failed writing command cache entry '%s'.",
+			path.c_str());
+		platform::uremove(tmp.c_str());
+	}
+}
+
+} // unnamed namespace;
+
+pair<string, int>
+FetchPersistentCommandOutput(const string& cmd, const string& dir,
+	const vector<string>& envs, const vector<string>& deps, size_t buf_size)
+{
+	if(YB_UNLIKELY(buf_size == 0))
+		throw std::invalid_argument("Zero buffer size found.");
+	if(dir.empty())
+		return FetchCommandOutput(cmd.c_str(), buf_size);
+
+	const auto key(MakeCommandKey(cmd, envs, deps));
+	char name[2 * sizeof(std::uint64_t) + 1];
+
+	std::snprintf(name, sizeof(name), "%016llX",
+		static_cast<unsigned long long>(HashCommandKey(key)));
+
+	const auto path(dir + '/' + name);
+	pair<string, int> res;
+
+	if(ReadCommandCacheEntry(path.c_str(), key, res))
+		YTraceDe(Debug, "Command cache hit: '%s'.", path.c_str());
+	else
+	{
+		res = FetchCommandOutput(cmd.c_str(), buf_size);
+		// NOTE: Failures might be transient, so they are not kept.
+		if(res.second == 0)
+			WriteCommandCacheEntry(path, key, res);
+	}
+	return res;
+}
+
+
+pair<string, int>
+FetchProcessOutput(const vector<string>& args, size_t buf_size)
+{
+	YAssert(!args.empty(), "Empty arguments found.");
+	if(YB_UNLIKELY(buf_size == 0))
+		throw std::invalid_argument("Zero buffer size found.");
+#	if YCL_Win32
+	string cmd;
+
+	for(const auto& arg : args)
+	{
+		size_t n_bs(0);
+
+		if(!cmd.empty())
+			cmd += ' ';
+		cmd += '"';
+		// NOTE: Backslashes are only escaped when followed by a quote, as
+		//	Microsoft C runtime parses the command line.
+		for(const auto c : arg)
+		{
+			if(c == '\\')
+				++n_bs;
+			else
+			{
+				if(c == '"')
+					cmd.append(n_bs + 1, '\\');
+				n_bs = 0;
+			}
+			cmd += c;
+		}
+		cmd.append(n_bs, '\\');
+		cmd += '"';
+	}
+
+	auto pr(MakePipe());
+	auto wcmd(UTF8ToWCS(cmd));
+	::STARTUPINFOW si{};
+	::PROCESS_INFORMATION pi;
+
+	yunseq(si.cb = sizeof(si), si.dwFlags = STARTF_USESTDHANDLES,
+		si.hStdInput = ::GetStdHandle(STD_INPUT_HANDLE),
+		si.hStdOutput = pr.second.get(), si.hStdError = pr.second.get());
+	// XXX: The inheritable write end may also be inherited by children
+	//	created concurrently, which delays the end of file on the read end.
+	YCL_CallF_Win32(CreateProcessW, {}, &wcmd[0], {}, {}, TRUE, 0, {}, {},
+		&si, &pi);
+
+	UniqueHandle h_proc(pi.hProcess), h_thrd(pi.hThread);
+
+	h_thrd.reset();
+	// NOTE: The write end shall be closed in the parent to receive EOF.
+	pr.second.reset();
+
+	string str;
+	const auto p_buf(make_unique_default_init<char[]>(buf_size));
+	const auto n_req(::DWORD(std::min<size_t>(buf_size,
+		std::numeric_limits<::DWORD>::max())));
+	::DWORD err(0);
+
+	while(true)
+	{
+		::DWORD n;
+
+		if(!::ReadFile(pr.first.get(), &p_buf[0], n_req, &n, {}))
+		{
+			err = ::GetLastError();
+			if(err == ERROR_BROKEN_PIPE)
+				err = 0;
+			break;
+		}
+		if(n == 0)
+			break;
+		str.append(&p_buf[0], n);
+	}
+
+	::DWORD status;
+
+	// NOTE: The child is always waited to get the exit code.
+	if(::WaitForSingleObject(h_proc.get(), INFINITE) == WAIT_FAILED)
+		YCL_Raise_Win32E("WaitForSingleObject", yfsig);
+	if(err != 0)
+		throw Win32Exception(err, "ReadFile", yfsig);
+	YCL_CallF_Win32(GetExitCodeProcess, h_proc.get(), &status);
+	return {std::move(str), int(status)};
+#	else
+	int fds[2];
+
+#		if YCL_Linux
+	YCL_CallF_CAPI(, ::pipe2, fds, O_CLOEXEC);
+#		else
+	YCL_CallF_CAPI(, ::pipe, fds);
+#		endif
+
+	UniqueHandle h_read(fds[0]), h_write(fds[1]);
+
+#		if !YCL_Linux
+	// XXX: Not atomic with creation of the pipe. Some descriptors may be
+	//	leaked to children spawned concurrently.
+	YCL_CallF_CAPI(, ::fcntl, fds[0], F_SETFD, FD_CLOEXEC);
+	YCL_CallF_CAPI(, ::fcntl, fds[1], F_SETFD, FD_CLOEXEC);
+#		endif
+
+	vector<char*> argv;
+
+	argv.reserve(args.size() + 1);
+	for(const auto& arg : args)
+		argv.push_back(const_cast<char*>(arg.c_str()));
+	argv.push_back({});
+
+	::posix_spawn_file_actions_t acts;
+
+	YCL_RaiseZ_SysE(, ::posix_spawn_file_actions_init(&acts),
+		"::posix_spawn_file_actions_init", yfsig);
+
+	const auto gd(ystdex::make_guard([&]() ynothrow{
+		::posix_spawn_file_actions_destroy(&acts);
+	}));
+	::pid_t pid;
+
+	// NOTE: Descriptors duplicated by %::dup2 do not have %FD_CLOEXEC set.
+	YCL_RaiseZ_SysE(, ::posix_spawn_file_actions_adddup2(&acts, fds[1],
+		STDOUT_FILENO), "::posix_spawn_file_actions_adddup2", yfsig);
+	YCL_RaiseZ_SysE(, ::posix_spawn_file_actions_adddup2(&acts, fds[1],
+		STDERR_FILENO), "::posix_spawn_file_actions_adddup2", yfsig);
+	YCL_RaiseZ_SysE(, ::posix_spawnp(&pid, argv[0], &acts, {}, argv.data(),
+		environ), "::posix_spawnp", yfsig);
+	// NOTE: The write end shall be closed in the parent to receive EOF.
+	h_write.reset();
+
+	string str;
+	const auto p_buf(make_unique_default_init<char[]>(buf_size));
+	int err(0);
+
+	while(true)
+	{
+		const auto n(h_read->Read(&p_buf[0], buf_size));
+
+		if(n == size_t(-1))
+		{
+			err = errno;
+			break;
+		}
+		if(n == 0)
+			break;
+		str.append(&p_buf[0], n);
+	}
+
+	int status;
+
+	// NOTE: The child is always waited to prevent zombies.
+	while(::waitpid(pid, &status, 0) == -1)
+		if(errno != EINTR)
+			YCL_Raise_SysE(, "::waitpid", yfsig);
+	if(err != 0)
+		ystdex::throw_error(err, yfsig);
+	return {std::move(str), WIFEXITED(status) ? WEXITSTATUS(status)
+		: (WIFSIGNALED(status) ? 128 + WTERMSIG(status) : status)};
+#	endif
+}
+
 
 pair<UniqueHandle, UniqueHandle>
 MakePipe()
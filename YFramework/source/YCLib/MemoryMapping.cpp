@@ -1,5 +1,5 @@
 ﻿/*
-	© 2012-2016 FrankHB.
+	© 2012-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file MemoryMapping.cpp
 \ingroup YCLib
 \brief 内存映射文件。
-\version r503
+\version r505
 \author FrankHB <frankhb1989@gmail.com>
 \since build 324
 \par 创建时间:
 	2012-07-11 21:59:21 +0800
 \par 修改时间:
-	2016-11-12 13:41 +0800
+	2017-07-23 20:41 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -33,7 +33,8 @@
 #include YFM_YCLib_NativeAPI // for ::UnmapViewOfFile, ::munmap,
 //	platform_ex::ToHandle, CreateFileMapping, PAGE_READONLY, PAGE_READWRITE,
 //	MapViewOfFile, FILE_MAP_READ, FILE_MAP_ALL_ACCESS, FILE_MAP_COPY, ::mmap,
-//	PROT_READ, PROT_WRITE, ::lseek, MAP_PRIVATE, MAP_SHARED, MAP_FAILED;
+//	PROT_READ, PROT_WRITE, ::lseek, MAP_PRIVATE, MAP_SHARED, MAP_FAILED,
+//	::posix_madvise, POSIX_MADV_*;
 #include <ystdex/cast.hpp> // for ystdex::narrow;
 #if YCL_Win32
 #	include YFM_YCLib_Host // for platform_ex::UniqueHandle;
@@ -169,6 +170,51 @@ MappedFile::~MappedFile()
 	}
 }
 
+void
+MappedFile::Advise(size_t off, size_t len, FileMappingAdvice advice) const
+	ynothrow
+{
+	YAssertNonnull(GetPtr());
+
+#if YCL_DS || YCL_Win32 || YCL_Android
+	// NOTE: No hints are supported. Windows 8 %::PrefetchVirtualMemory is not
+	//	used due to the minimal supported version. Android %::posix_madvise is
+	//	not available before API level 23.
+	yunused(off), yunused(len), yunused(advice);
+#else
+	const auto size(GetSize());
+
+	if(off < size && len != 0)
+	{
+		const auto page_size(FetchLimit(SystemOption::PageSize));
+
+		len = std::min(len, size - off);
+		if(page_size != 0)
+		{
+			const auto head(off % page_size);
+
+			yunseq(off -= head, len += head);
+		}
+		// XXX: Error ignored.
+		::posix_madvise(GetPtr() + off, len, [=]() ynothrow -> int{
+			switch(advice)
+			{
+			case FileMappingAdvice::Sequential:
+				return POSIX_MADV_SEQUENTIAL;
+			case FileMappingAdvice::Random:
+				return POSIX_MADV_RANDOM;
+			case FileMappingAdvice::WillNeed:
+				return POSIX_MADV_WILLNEED;
+			case FileMappingAdvice::DontNeed:
+				return POSIX_MADV_DONTNEED;
+			default:
+				return POSIX_MADV_NORMAL;
+			}
+		}());
+	}
+#endif
+}
+
 void
 MappedFile::FlushView()
 {
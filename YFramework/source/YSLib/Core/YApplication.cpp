@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YApplication.cpp
 \ingroup Core
 \brief 系统资源和应用程序实例抽象。
-\version r1740
+\version r1748
 \author FrankHB <frankhb1989@gmail.com>
 \since 早于 build 132
 \par 创建时间:
 	2009-12-27 17:12:36 +0800
 \par 修改时间:
-	2016-11-23 13:09 +0800
+	2017-08-06 10:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -73,13 +73,85 @@ Application::Switch(shared_ptr<Shell>& h) ynothrow
 	return {};
 }
 
+void
+Application::Post(const Message& msg, Messaging::Priority prior)
+{
+	if(msg)
+		Post(Message(msg), prior);
+}
+void
+Application::Post(Message&& msg, Messaging::Priority prior)
+{
+	qMain.PushConcurrent(std::move(msg), prior);
+#if YF_Multithread == 1
+	// NOTE: Both %waiting and the queue are sequentially consistent, so at
+	//	least one of the waiting thread and this thread would see the update of
+	//	the other. The waiting thread holds the lock before it is blocked, so
+	//	the notification would not be lost.
+	if(waiting.load())
+	{
+		lock_guard<recursive_mutex> lck(queue_mutex);
+
+		queue_cond.notify_all();
+	}
+#endif
+}
+
+bool
+Application::WaitForMessage(std::chrono::nanoseconds timeout)
+{
+	unique_lock<recursive_mutex> lck(queue_mutex);
+
+#if YF_Multithread == 1
+	if(!wake_requested && timeout > std::chrono::nanoseconds::zero())
+	{
+		waiting = true;
+		queue_cond.wait_for(lck, timeout, [this]() ynothrow{
+			return wake_requested || !qMain.empty();
+		});
+		waiting = {};
+	}
+#else
+	yunused(timeout);
+#endif
+	wake_requested = {};
+	return !qMain.empty();
+}
+
+void
+Application::RequestWakeUp(Timers::TimePoint)
+{}
+
+void
+Application::Wake()
+{
+	{
+		lock_guard<recursive_mutex> lck(queue_mutex);
+
+		wake_requested = true;
+	}
+#if YF_Multithread == 1
+	queue_cond.notify_all();
+#endif
+}
+
 
 void
 PostMessage(const Message& msg, Messaging::Priority prior)
 {
-	FetchAppInstance().AccessQueue([=, &msg](MessageQueue& mq){
-		mq.Push(msg, prior);
-	});
+	FetchAppInstance().Post(msg, prior);
+}
+void
+PostMessage(Message&& msg, Messaging::Priority prior)
+{
+	FetchAppInstance().Post(std::move(msg), prior);
+}
+
+void
+RequestWakeUp(Timers::TimePoint t) ynothrow
+{
+	TryExpr(FetchAppInstance().RequestWakeUp(t))
+	CatchIgnore(...)
 }
 
 void
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YMessage.cpp
 \ingroup Core
 \brief 消息处理。
-\version r1253
+\version r1261
 \author FrankHB <frankhb1989@gmail.com>
 \since 早于 build 132
 \par 创建时间:
 	2009-12-06 02:44:31 +0800
 \par 修改时间:
-	2016-07-14 22:52 +0800
+	2017-07-20 09:17 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -48,49 +48,371 @@ swap(Message& x, Message& y) ynothrow
 }
 
 
+struct MessageQueue::Node final
+{
+	Node* Next = {};
+	Priority NodePriority = 0;
+	Message Content{};
+};
+
+
+namespace
+{
+
+//! \since build 800
+using Node = MessageQueue::Node;
+
+//! \since build 800
+void
+DeleteList(Node* p) ynothrow
+{
+	while(p)
+	{
+		const auto p_next(p->Next);
+
+		delete p;
+		p = p_next;
+	}
+}
+
+/*!
+\brief 取最高的非零位的位置。
+\pre 参数非零。
+\since build 800
+*/
+inline size_t
+FindHighestBit(std::uint64_t x) ynothrowv
+{
+	YAssert(x != 0, "Invalid argument found.");
+#if __has_builtin(__builtin_clzll) || YB_IMPL_GNUCPP >= 30400
+	return size_t(63 - __builtin_clzll(x));
+#else
+	size_t n(0);
+
+	while(x >>= 1)
+		++n;
+	return n;
+#endif
+}
+
+#if YF_Multithread == 0 || YB_HAS_THREAD_LOCAL
+/*!
+\brief 生产者线程的空闲节点缓存。
+\note 节点不依赖特定的消息队列，因此可在线程退出时直接释放。
+\since build 800
+*/
+struct NodeCache final
+{
+	Node* List = {};
+
+	~NodeCache()
+	{
+		DeleteList(List);
+	}
+};
+
+//! \since build 800
+#	if YF_Multithread == 1
+thread_local
+#	endif
+NodeCache LocalNodeCache;
+#	define YF_Impl_MessageNodeCache true
+#endif
+
+} // unnamed namespace;
+
+MessageQueue::~MessageQueue()
+{
+	clear();
+	DeleteList(free_nodes);
+	DeleteList(spare_nodes.exchange({}));
+}
+
+bool
+MessageQueue::empty() const ynothrow
+{
+	return bucket_size == 0 && !incoming.load();
+}
+
+Priority
+MessageQueue::GetMaxPriority() const ynothrow
+{
+	Collect();
+	for(size_t i(BitmapSize); i != 0; --i)
+		if(const auto w = bitmap[i - 1])
+			return Priority((i - 1) * sizeof(BitmapWord) * CHAR_BIT
+				+ FindHighestBit(w));
+	return 0;
+}
+
+void
+MessageQueue::clear() ynothrow
+{
+	Collect();
+	for(size_t i(BitmapSize); i != 0; --i)
+		while(const auto w = bitmap[i - 1])
+		{
+			auto& bucket(buckets[(i - 1) * sizeof(BitmapWord) * CHAR_BIT
+				+ FindHighestBit(w)]);
+
+			while(const auto p = bucket.Head)
+			{
+				bucket.Head = p->Next;
+				Recycle(p);
+			}
+			bucket.Tail = {};
+			bitmap[i - 1] &= ~(BitmapWord(1) << FindHighestBit(w));
+		}
+	bucket_size = 0;
+}
+
+void
+MessageQueue::Collect() const ynothrow
+{
+	if(auto p = incoming.exchange({}))
+	{
+		Node* p_rev{};
+
+		// NOTE: The nodes are linked in reversed order of insertion.
+		while(p)
+		{
+			const auto p_next(p->Next);
+
+			p->Next = p_rev;
+			p_rev = p;
+			p = p_next;
+		}
+		while(p_rev)
+		{
+			const auto p_next(p_rev->Next);
+
+			Link(p_rev);
+			p_rev = p_next;
+		}
+	}
+}
+
+void
+MessageQueue::Link(Node* p) const ynothrow
+{
+	YAssertNonnull(p);
+
+	const size_t n(p->NodePriority);
+	auto& bucket(buckets[n]);
+
+	p->Next = {};
+	if(bucket.Tail)
+		bucket.Tail->Next = p;
+	else
+	{
+		bucket.Head = p;
+		bitmap[n / (sizeof(BitmapWord) * CHAR_BIT)]
+			|= BitmapWord(1) << n % (sizeof(BitmapWord) * CHAR_BIT);
+	}
+	bucket.Tail = p;
+	++bucket_size;
+}
+
 void
 MessageQueue::Merge(MessageQueue& mq)
 {
-	std::for_each(mq.begin(), mq.end(), [this](decltype(*mq.begin()) pr){
-		if(pr.second)
-			insert(std::move(pr));
-	});
-	mq.clear();
+	if(&mq != this)
+	{
+		Collect();
+		mq.Collect();
+		for(size_t i(BitmapSize); i != 0; --i)
+			while(const auto w = mq.bitmap[i - 1])
+			{
+				const auto b(FindHighestBit(w));
+				auto& bucket(mq.buckets[(i - 1) * sizeof(BitmapWord) * CHAR_BIT
+					+ b]);
+
+				while(const auto p = bucket.Head)
+				{
+					bucket.Head = p->Next;
+					if(p->Content)
+						Link(p);
+					else
+						mq.Recycle(p);
+				}
+				bucket.Tail = {};
+				mq.bitmap[i - 1] &= ~(BitmapWord(1) << b);
+			}
+		mq.bucket_size = 0;
+	}
 }
 
 void
 MessageQueue::Peek(Message& msg) const
 {
-	if(!empty())
-		msg = cbegin()->second;
+	Collect();
+	if(bucket_size != 0)
+		msg = Deref(buckets[GetMaxPriority()].Head).Content;
 }
 
 void
 MessageQueue::Pop()
 {
-	if(!empty())
-		erase(cbegin());
+	Collect();
+	if(bucket_size != 0)
+		Recycle(Unlink());
+}
+Priority
+MessageQueue::Pop(Message& msg) ynothrowv
+{
+	Collect();
+	YAssert(bucket_size != 0, "Empty queue found.");
+
+	const auto p(Unlink());
+	const auto prior(p->NodePriority);
+
+	msg = std::move(p->Content);
+	Recycle(p);
+	return prior;
 }
 
 void
 MessageQueue::Push(const Message& msg, Priority prior)
 {
 	if(msg)
-		emplace(prior, msg);
+		Push(Message(msg), prior);
 }
 void
 MessageQueue::Push(Message&& msg, Priority prior)
 {
 	if(msg)
-		emplace(prior, std::move(msg));
+	{
+		Collect();
+
+		Node* p;
+
+		if(free_nodes)
+		{
+			p = free_nodes;
+			yunseq(free_nodes = p->Next, --free_count);
+		}
+		else
+			p = new Node();
+		yunseq(p->NodePriority = prior, p->Content = std::move(msg));
+		Link(p);
+	}
+}
+
+void
+MessageQueue::PushConcurrent(const Message& msg, Priority prior)
+{
+	if(msg)
+		PushConcurrent(Message(msg), prior);
+}
+void
+MessageQueue::PushConcurrent(Message&& msg, Priority prior)
+{
+	if(msg)
+	{
+		Node* p{};
+
+#ifdef YF_Impl_MessageNodeCache
+		auto& cache(LocalNodeCache.List);
+
+		// NOTE: The whole stack is taken to avoid ABA problem, since only
+		//	the consumer pushes nodes to the stack.
+		if(!cache)
+			cache = spare_nodes.exchange({});
+		if(cache)
+		{
+			p = cache;
+			cache = p->Next;
+		}
+		else
+#endif
+			p = new Node();
+		yunseq(p->NodePriority = prior, p->Content = std::move(msg));
+		p->Next = incoming.load(std::memory_order_relaxed);
+		while(!incoming.compare_exchange_weak(p->Next, p))
+			;
+	}
+}
+
+void
+MessageQueue::Recycle(Node* p) const ynothrow
+{
+	YAssertNonnull(p);
+	p->Content = Message();
+	if(free_count < MaxPooledNodes)
+	{
+		p->Next = free_nodes;
+		yunseq(free_nodes = p, ++free_count);
+#ifdef YF_Impl_MessageNodeCache
+		// NOTE: Nodes are shared to producers only when the previously shared
+		//	ones have been all taken.
+		if(free_count >= MaxPooledNodes / 2 && !spare_nodes.load())
+		{
+			Node* p_expected{};
+
+			if(spare_nodes.compare_exchange_strong(p_expected, free_nodes))
+				yunseq(free_nodes = {}, free_count = 0);
+		}
+#endif
+	}
+	else
+		delete p;
 }
 
 void
 MessageQueue::Remove(Priority p)
 {
-	erase(upper_bound(p), end());
+	Collect();
+	for(size_t n(0); n < size_t(p); ++n)
+	{
+		auto& bucket(buckets[n]);
+
+		while(const auto p_node = bucket.Head)
+		{
+			bucket.Head = p_node->Next;
+			Recycle(p_node);
+			--bucket_size;
+		}
+		bucket.Tail = {};
+	}
+
+	const size_t w(size_t(p) / (sizeof(BitmapWord) * CHAR_BIT));
+
+	for(size_t i(0); i < w; ++i)
+		bitmap[i] = 0;
+	if(const auto r = size_t(p) % (sizeof(BitmapWord) * CHAR_BIT))
+		bitmap[w] &= ~((BitmapWord(1) << r) - 1);
+}
+
+size_t
+MessageQueue::size() const ynothrow
+{
+	Collect();
+	return bucket_size;
+}
+
+MessageQueue::Node*
+MessageQueue::Unlink() ynothrow
+{
+	const size_t n(GetMaxPriority());
+	auto& bucket(buckets[n]);
+	const auto p(bucket.Head);
+
+	YAssertNonnull(p);
+
+	bucket.Head = p->Next;
+	if(!bucket.Head)
+	{
+		bucket.Tail = {};
+		bitmap[n / (sizeof(BitmapWord) * CHAR_BIT)]
+			&= ~(BitmapWord(1) << n % (sizeof(BitmapWord) * CHAR_BIT));
+	}
+	--bucket_size;
+	p->Next = {};
+	return p;
 }
 
+#undef YF_Impl_MessageNodeCache
+
 
 ImplDeDtor(MessageException)
 
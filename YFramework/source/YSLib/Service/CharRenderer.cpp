@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2015 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file CharRenderer.cpp
 \ingroup Service
 \brief 字符渲染。
-\version r3328
+\version r3333
 \author FrankHB <frankhb1989@gmail.com>
 \since build 275
 \par 创建时间:
 	2009-11-13 00:06:05 +0800
 \par 修改时间:
-	2015-10-02 19:27 +0800
+	2017-08-02 23:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -29,6 +29,7 @@
 #include YFM_YSLib_Service_CharRenderer
 #include YFM_YSLib_Service_YBlend // for Drawing::Shaders::BlitAlphaPoint;
 #include <ystdex/bitseg.hpp> // for ystdex::bitseg_iterator;
+#include <ystdex/cwctype.h> // for ystdex::iswgraph;
 
 using namespace ystdex;
 
@@ -68,6 +69,24 @@ struct BlitTextPoint
 	}
 };
 
+/*!
+\brief 混合覆盖值非零的像素。
+\note 覆盖值为零时 Alpha 混合的结果和目标像素相同，因此跳过。
+\warning 不检查迭代器有效性。
+\since build 821
+*/
+struct BlitCoveragePoint
+{
+	template<typename _tOut, typename _tInPixel, typename _tInAlpha>
+	void
+	operator()(_tOut dst_iter, pair_iterator<_tInPixel, _tInAlpha> src_iter)
+		const
+	{
+		if(*get<1>(src_iter.base()) != 0)
+			Shaders::BlitAlphaPoint()(dst_iter, src_iter);
+	}
+};
+
 //! \since build 587
 template<size_t _vN>
 struct tr_seg
@@ -103,6 +122,63 @@ tr_buf(byte* p)
 }
 //@}
 
+
+//! \since build 821
+//@{
+template<typename _tIn>
+void
+ExpandGlyphLine(AlphaType* dst, _tIn src, SDst w)
+{
+	for(SDst x(0); x != w; yunseq(++x, ++src))
+		dst[x] = *src;
+}
+
+/*!
+\brief 展开字形位图为 8 位覆盖值。
+\return 是否支持位图格式。
+\note 结果和 RenderChar 对相同格式的位图使用的覆盖值相同。
+*/
+bool
+ExpandGlyph(AlphaType* dst, const CharBitmap& cbmp)
+{
+	const auto cbuf(cbmp.GetBuffer());
+	const size_t abs_pitch(size_t(std::abs(cbmp.GetPitch())));
+	const SDst w(cbmp.GetWidth()), h(cbmp.GetHeight());
+
+	for(SDst y(0); y != h; yunseq(++y, dst += w))
+	{
+		const auto src(cbuf + y * abs_pitch);
+
+		switch(cbmp.GetFormat())
+		{
+		case CharBitmap::Mono:
+			ExpandGlyphLine(dst, tr_buf<1>(src), w);
+			break;
+		case CharBitmap::Gray2:
+			ExpandGlyphLine(dst, tr_buf<2>(src), w);
+			break;
+		case CharBitmap::Gray4:
+			ExpandGlyphLine(dst, tr_buf<4>(src), w);
+			break;
+		case CharBitmap::Gray:
+			ExpandGlyphLine(dst, src, w);
+			break;
+		default:
+			return {};
+		}
+	}
+	return true;
+}
+
+//! \brief 估计缓存项占用的字节数。
+size_t
+FetchEntrySize(const GlyphCache::Mask& mask) ynothrow
+{
+	return sizeof(GlyphCache::Key) * 2 + sizeof(GlyphCache::Mask)
+		+ mask.Coverage.size() * sizeof(AlphaType);
+}
+//@}
+
 } // unnamed namespace;
 
 void
@@ -129,8 +205,9 @@ RenderChar(PaintContext&& pc, Color c, bool neg_pitch,
 			ss, pc, neg_pitch);
 		break;
 	case CharBitmap::Gray:
-		BlitGlyphPixels(bp, dst, pair_iterator<PixelIt, const AlphaType*>(
-			PixelIt(c), cbuf), ss, pc, neg_pitch);
+		BlitGlyphPixels(BlitCoveragePoint(), dst,
+			pair_iterator<PixelIt, const AlphaType*>(PixelIt(c), cbuf), ss, pc,
+			neg_pitch);
 	default:
 		break;
 	}
@@ -166,6 +243,85 @@ RenderCharAlpha(PaintContext&& pc, Color c, bool neg_pitch,
 }
 
 
+GlyphCache::GlyphCache(size_t s)
+	: max_size(s)
+{}
+
+void
+GlyphCache::SetMaxSize(size_t s) ynothrow
+{
+	max_size = s;
+	Shrink();
+}
+
+void
+GlyphCache::Clear() ynothrow
+{
+	used_list.clear(),
+	used_cache.clear(),
+	used_size = 0;
+}
+
+observer_ptr<const GlyphCache::Mask>
+GlyphCache::Lookup(const Font& fnt, char32_t c)
+{
+	const Key key{&fnt.GetTypeface(), fnt.GetSize(), fnt.GetStyle(), c};
+	const auto i(used_cache.find(key));
+
+	if(i != used_cache.end())
+		return make_observer(&used_list.refresh(i->second)->second);
+
+	const auto cbmp(fnt.GetGlyph(c));
+
+	if(YB_UNLIKELY(!cbmp))
+		return {};
+
+	Mask mask;
+
+	mask.XAdvance = cbmp.GetXAdvance();
+	// NOTE: Same to %RenderChar, non-graph characters are not rendered.
+	if(ystdex::iswgraph(wchar_t(c)) && cbmp.GetBuffer())
+	{
+		mask.Coverage.resize(size_t(cbmp.GetWidth() * cbmp.GetHeight()));
+		if(ExpandGlyph(mask.Coverage.data(), cbmp))
+			yunseq(mask.Width = cbmp.GetWidth(),
+				mask.Height = cbmp.GetHeight(), mask.Left = cbmp.GetLeft(),
+				mask.Top = cbmp.GetTop(),
+				mask.NegativePitch = cbmp.GetPitch() < 0);
+		else
+			mask.Coverage.clear();
+	}
+
+	const auto n(FetchEntrySize(mask));
+
+	Shrink(n);
+
+	const auto i_list(used_list.emplace(key, std::move(mask)));
+
+	try
+	{
+		used_cache.emplace(key, i_list);
+	}
+	catch(...)
+	{
+		used_list.undo_emplace();
+		throw;
+	}
+	used_size += n;
+	return make_observer(&i_list->second);
+}
+
+void
+GlyphCache::Shrink(size_t n) ynothrow
+{
+	while(!used_list.empty() && used_size + n > max_size)
+	{
+		used_size -= FetchEntrySize(std::prev(used_list.end())->second);
+		used_list.shrink(used_cache);
+	}
+}
+
+
 PutCharResult
 PutCharBase(TextState& ts, SDst eol, char32_t c)
 {
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2015 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file TextRenderer.cpp
 \ingroup Service
 \brief 文本渲染。
-\version r2755
+\version r2761
 \author FrankHB <frankhb1989@gmail.com>
 \since build 275
 \par 创建时间:
 	2009-11-13 00:06:05 +0800
 \par 修改时间:
-	2015-10-02 18:49 +0800
+	2017-08-03 21:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -45,14 +45,14 @@ namespace Drawing
 namespace
 {
 
-//! \since build 372
+//! \since build 821
 PaintContext
-ClipChar(const Graphics& g, const Point& pen, const CharBitmap& cbmp, Rect r)
+ClipChar(const Graphics& g, const Point& pen, SPos left, SPos top,
+	const Size& s, Rect r)
 {
 	YAssert(bool(g), "Invalid graphics context found.");
 
-	const auto pt(ClipBounds(r, Rect(pen.X + cbmp.GetLeft(),
-		pen.Y - cbmp.GetTop(), cbmp.GetWidth(), cbmp.GetHeight())));
+	const auto pt(ClipBounds(r, Rect(pen.X + left, pen.Y - top, s)));
 
 	return {g, pt, r};
 }
@@ -84,6 +84,29 @@ void
 RenderCharFrom(char32_t c, const Graphics& g, TextState& ts, const Rect& clip,
 	_tParams&&... args)
 {
+	if(const auto p_cache = ts.GlyphCachePtr)
+	{
+		if(const auto p_mask = p_cache->Lookup(ts.Font, c))
+		{
+			const auto& mask(*p_mask);
+
+			if(!mask.Coverage.empty())
+			{
+				const Size ss(mask.Width, mask.Height);
+				auto&& pc(ClipChar(g, ts.Pen, mask.Left, mask.Top, ss, clip));
+
+				// NOTE: The buffer is only read by the renderer.
+				if(!pc.ClipArea.IsUnstrictlyEmpty())
+					_fCharRenderer(std::move(pc), ts.Color, mask.NegativePitch,
+						const_cast<CharBitmap::BufferType>(
+						mask.Coverage.data()), CharBitmap::Gray, ss,
+						yforward(args)...);
+			}
+			ts.Pen.X += mask.XAdvance;
+		}
+		return;
+	}
+
 	const auto cbmp(ts.Font.GetGlyph(c));
 
 	if(YB_LIKELY(cbmp))
@@ -95,7 +118,8 @@ RenderCharFrom(char32_t c, const Graphics& g, TextState& ts, const Rect& clip,
 		if(ystdex::iswgraph(wchar_t(c)))
 			if(const auto cbuf = cbmp.GetBuffer())
 			{
-				auto&& pc(ClipChar(g, ts.Pen, cbmp, clip));
+				auto&& pc(ClipChar(g, ts.Pen, cbmp.GetLeft(), cbmp.GetTop(),
+					{cbmp.GetWidth(), cbmp.GetHeight()}, clip));
 
 				// TODO: Test support for bitmaps with negative pitch.
 				if(!pc.ClipArea.IsUnstrictlyEmpty())
@@ -107,6 +131,41 @@ RenderCharFrom(char32_t c, const Graphics& g, TextState& ts, const Rect& clip,
 	}
 }
 
+
+/*!
+\brief 文本行程记录器：按 TextRenderer 的规则移动笔并记录被打印的字符。
+\since build 822
+*/
+class TextRunRecorder : public GTextRendererBase<TextRunRecorder>
+{
+public:
+	TextState& State;
+	Graphics Context;
+	vector<TextRun::Glyph>& Glyphs;
+
+	TextRunRecorder(TextState& ts, const Size& s, vector<TextRun::Glyph>& v)
+		: State(ts), Context(nullptr, s), Glyphs(v)
+	{}
+
+	void
+	operator()(char32_t c)
+	{
+		const auto cbmp(State.Font.GetGlyph(c));
+		const auto adv(cbmp ? SDst(cbmp.GetXAdvance()) : SDst(0));
+
+		Glyphs.push_back({c, State.Pen, adv});
+		// XXX: Conversion to 'SPos' might be implementation-defined.
+		State.Pen.X += SPos(adv);
+	}
+
+	ImplS(GTextRendererBase) DefGetter(const ynothrow, const TextState&,
+		TextState, State)
+	ImplS(GTextRendererBase) DefGetter(ynothrow, TextState&, TextState, State)
+	ImplS(GTextRendererBase) DefGetter(const ynothrow, Graphics, Context,
+		Context)
+	DefGetterMem(const ynothrow, SDst, Height, Context)
+};
+
 } // unnamed namespace;
 
 void
@@ -131,6 +190,42 @@ TextRenderer::ClearLine(size_t l, SDst n)
 }
 
 
+TextRun::TextRun(const TextState& ts, const Size& s, const String& str,
+	bool wrap)
+	: font(ts.Font), margin(ts.Margin), start_pen(ts.Pen),
+	line_gap(ts.LineGap), size(s), text(str), line_wrap(wrap)
+{
+	TextState state(ts);
+	TextRunRecorder rec(state, s, glyphs);
+
+	length = line_wrap ? PutString(rec, text) : PutLine(rec, text);
+	end_pen = state.Pen;
+
+	const auto asc(font.GetAscender());
+	const auto h(font.GetHeight());
+
+	for(size_t i(0); i != glyphs.size(); ++i)
+	{
+		const auto& g(glyphs[i]);
+
+		if(i == 0 || g.Pen.Y != glyphs[i - 1].Pen.Y)
+			line_starts.push_back(i);
+		bounds |= Rect(g.Pen.X, g.Pen.Y - asc, g.Advance, h);
+	}
+}
+
+bool
+TextRun::Matches(const TextState& ts, const Size& s, const String& str,
+	bool wrap) const
+{
+	return &ts.Font.GetTypeface() == &font.GetTypeface()
+		&& ts.Font.GetSize() == font.GetSize()
+		&& ts.Font.GetStyle() == font.GetStyle() && ts.Margin == margin
+		&& ts.Pen == start_pen && ts.LineGap == line_gap && s == size
+		&& wrap == line_wrap && str == text;
+}
+
+
 TextRegion::TextRegion()
 	: GTextRendererBase<TextRegion>(), TextState(), CompactPixmapEx()
 {
@@ -230,6 +325,14 @@ DrawClippedText(const Graphics& g, const Rect& bounds, TextState& ts,
 	PutText(line_wrap, tr, str);
 }
 void
+DrawClippedText(const Graphics& g, const Rect& bounds, TextState& ts,
+	const TextRun& run, const Vec& offset)
+{
+	TextRenderer tr(ts, g, bounds);
+
+	run.Render(tr, offset);
+}
+void
 DrawClippedText(const Graphics& g, const Rect& bounds, const Rect& r,
 	const String& str, const Padding& m, Color c, bool line_wrap,
 	const Font& fnt)
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file ComboList.cpp
 \ingroup UI
 \brief 样式相关的图形用户界面组合列表控件。
-\version r3309
+\version r3310
 \author FrankHB <frankhb1989@gmail.com>
 \since build 282
 \par 创建时间:
 	2011-03-07 20:33:05 +0800
 \par 修改时间:
-	2016-08-12 20:26 +0800
+	2017-08-05 18:20 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -29,7 +29,6 @@
 #include YFM_YSLib_UI_ComboList
 #include YFM_YSLib_UI_YStyle
 #include YFM_YSLib_UI_YPanel
-#include YFM_YSLib_Service_TextLayout // for FetchMaxTextWidth;
 #include <ystdex/scope_guard.hpp> // for ystdex::swap_guard;
 
 namespace YSLib
@@ -100,9 +99,7 @@ void
 ListBox::ResizeForPreferred(const Size& sup, Size s)
 {
 	if(s.Width == 0)
-		s.Width = FetchMaxTextWidth(GetTextListRef().LabelBrush.Font,
-			GetTextListRef().GetList().cbegin(),
-			GetTextListRef().GetList().cend())
+		s.Width = FetchMaxItemWidth(GetTextListRef())
 			+ GetHorizontalOf(GetTextListRef().LabelBrush.Margin);
 	if(s.Height == 0)
 		s.Height = GetTextListRef().GetFullViewHeight();
@@ -238,11 +235,15 @@ DropDownList::DropDownList(const Rect& r, const shared_ptr<ListType>& h)
 					SetLocationOf(lbContent, pt);
 					lbContent.AdjustViewLength();
 					{
-						const auto& lst(lbContent.GetList());
-						const auto i(std::find(lst.cbegin(), lst.cend(), Text));
-
-						if(i != lst.cend())
-							lbContent.SetSelected(size_t(i - lst.cbegin()));
+						// NOTE: Items from the provider are fetched by
+						//	%ListBox::GetItem when it is set.
+						const auto n(lbContent.GetTotal());
+						size_t i(0);
+
+						while(i != n && lbContent.GetItem(i) != Text)
+							++i;
+						if(i != n)
+							lbContent.SetSelected(i);
 						else
 							lbContent.ClearSelected();
 					}
@@ -256,9 +257,9 @@ DropDownList::DropDownList(const Rect& r, const shared_ptr<ListType>& h)
 	FetchEvent<LostFocus>(*this) += detacher,
 	FetchEvent<LostFocus>(lbContent) += detacher,
 	lbContent.GetConfirmed() += [this](IndexEventArgs&& e){
-		YAssert(e.Value < lbContent.GetList().size(), "Invalid index found.");
+		YAssert(e.Value < lbContent.GetTotal(), "Invalid index found.");
 
-		Text = lbContent.GetList()[e.Value];
+		Text = lbContent.GetItem(e.Value);
 		// XXX: This seems to be redundant if the detached top widget would be
 		//	always invalidated, however there is no such guarantee.
 		Invalidate(e.GetSender()),
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2013-2015 FrankHB.
+	© 2013-2015, 2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file Hover.cpp
 \ingroup UI
 \brief 样式无关的指针设备悬停相关功能。
-\version r109
+\version r110
 \author FrankHB <frankhb1989@gmail.com>
 \since build 448
 \par 创建时间:
 	2013-09-28 12:52:39 +0800
 \par 修改时间:
-	2015-05-29 19:39 +0800
+	2017-08-06 10:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -29,6 +29,7 @@
 #include YFM_YSLib_UI_Hover
 #include YFM_YSLib_UI_YControl
 #include YFM_YSLib_UI_YUIContainer
+#include YFM_YSLib_Core_YApplication // for RequestWakeUp;
 
 namespace YSLib
 {
@@ -62,10 +63,16 @@ TimedHoverState::Check() ynothrow
 		Activate(tmr),
 		state = Over;
 	}
-	if(state == Over && tmr.Refresh())
+	if(state == Over)
 	{
-		state = Left;
-		return true;
+		if(tmr.Refresh())
+		{
+			state = Left;
+			return true;
+		}
+		// NOTE: The cursor is not moved, so the next check would be done
+		//	only when the message loop is woken up.
+		RequestWakeUp(FetchDeadline(tmr));
 	}
 	return {};
 }
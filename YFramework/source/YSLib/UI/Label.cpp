@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2015 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file Label.cpp
 \ingroup UI
 \brief 样式无关的用户界面标签。
-\version r1435
+\version r1437
 \author FrankHB <frankhb1989@gmail.com>
 \since build 188
 \par 创建时间:
 	2011-01-22 08:32:34 +0800
 \par 修改时间:
-	2015-03-22 18:21 +0800
+	2017-08-03 21:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -28,6 +28,7 @@
 #include "YSLib/UI/YModules.h"
 #include YFM_YSLib_UI_Label
 #include YFM_YSLib_Service_TextLayout
+#include YFM_YSLib_Service_TextRenderer
 #include YFM_YSLib_UI_YWidgetEvent
 
 namespace YSLib
@@ -48,8 +49,9 @@ MLabel::operator()(PaintEventArgs&& e) const
 	DrawText(GetSizeOf(e.GetSender()), e);
 }
 
+template<typename _fWidth>
 Point
-MLabel::GetAlignedPenOffset(const Size& s) const
+MLabel::AlignPenOffset(const Size& s, _fWidth get_width) const
 {
 	Point pt;
 
@@ -62,7 +64,7 @@ MLabel::GetAlignedPenOffset(const Size& s) const
 			{
 				// XXX: Conversion to 'SPos' might be implementation-defined.
 				SPos horizontal_offset(SPos(s.Width - GetHorizontalOf(Margin)
-					- FetchStringWidth(Font, Text)));
+					- get_width()));
 
 				if(horizontal_offset > 0)
 				{
@@ -99,17 +101,53 @@ MLabel::GetAlignedPenOffset(const Size& s) const
 	return pt;
 }
 
+Point
+MLabel::GetAlignedPenOffset(const Size& s) const
+{
+	return AlignPenOffset(s, [this]{
+		return FetchStringWidth(Font, Text);
+	});
+}
+
 void
 MLabel::DrawText(const Size& s, const PaintContext& pc) const
 {
 	const auto r(Rect(pc.Location, s) + Margin);
-	TextState ts(Font, FetchMargin(r, pc.Target.GetSize()));
+	const auto p_upd(UpdateClippedText.target<
+		decltype(&DefaultUpdateClippedText)>());
 
-	ts.Color = ForeColor,
-	ts.ResetPen(pc.Location, Margin);
-	ts.Pen += GetAlignedPenOffset(s);
-	UpdateClippedText({pc.Target, pc.Location, pc.ClipArea & r}, ts, Text,
-		AutoWrapLine);
+	if(p_upd && *p_upd == DefaultUpdateClippedText)
+	{
+		// NOTE: The run is laid out relative to the label without alignment,
+		//	so moving the label, changing the target or changing the alignment
+		//	does not invalidate it.
+		TextState ts(Font, Margin);
+
+		ts.ResetPen({}, Margin);
+		if(!p_text_run || !p_text_run->Matches(ts, s, Text, AutoWrapLine))
+			p_text_run = make_shared<TextRun>(ts, s, Text, AutoWrapLine);
+
+		const auto& run(*p_text_run);
+
+		yunseq(ts.Color = ForeColor, ts.GlyphCachePtr = GlyphCachePtr);
+		DrawClippedText(pc.Target, pc.ClipArea & r, ts, run,
+			pc.Location + AlignPenOffset(s, [&]{
+				// NOTE: Truncated text is never aligned.
+				// XXX: Conversion to 'SDst' might be implementation-defined.
+				return run.GetLength() == Text.length()
+					? SDst(run.GetEndPen().X - ts.Pen.X) : s.Width;
+			}));
+	}
+	else
+	{
+		TextState ts(Font, FetchMargin(r, pc.Target.GetSize()));
+
+		yunseq(ts.Color = ForeColor, ts.GlyphCachePtr = GlyphCachePtr),
+		ts.ResetPen(pc.Location, Margin);
+		ts.Pen += GetAlignedPenOffset(s);
+		UpdateClippedText({pc.Target, pc.Location, pc.ClipArea & r}, ts, Text,
+			AutoWrapLine);
+	}
 }
 
 void
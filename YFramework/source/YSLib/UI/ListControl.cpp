@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file ListControl.cpp
 \ingroup UI
 \brief 列表控件。
-\version r2155
+\version r2168
 \author FrankHB <frankhb1989@gmail.com>
 \since build 214
 \par 创建时间:
 	2011-04-20 09:28:38 +0800
 \par 修改时间:
-	2016-02-12 00:48 +0800
+	2017-08-05 18:20 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -86,11 +86,25 @@ MTextList::MTextList(const shared_ptr<ListType>& h)
 	unit.GetView().SetHeight(GetItemHeight()),
 	Iterated += [this](size_t idx){
 		YAssert(idx < GetTotal(), "Index is out of range.");
-		LabelBrush.Text = GetList()[idx];
+		LabelBrush.Text = GetItem(idx);
 	},
 	FetchEvent<Paint>(unit) = std::ref(LabelBrush);
 }
 
+MTextList::ItemType
+MTextList::GetItem(IndexType idx) const
+{
+	YAssert(idx < GetTotal(), "Index is out of range.");
+	if(IsProvided())
+	{
+		if(!(cache_base <= idx && idx - cache_base < item_cache.size()))
+			PrefetchItems(idx, vwList.Length);
+		return idx - cache_base < item_cache.size()
+			? item_cache[idx - cache_base] : ItemType();
+	}
+	return GetList()[idx];
+}
+
 SDst
 MTextList::GetItemHeightCore() const
 {
@@ -103,7 +117,7 @@ MTextList::GetItemHeightCore() const
 size_t
 MTextList::GetTotal() const
 {
-	return GetList().size();
+	return IsProvided() ? CountItems() : GetList().size();
 }
 
 void
@@ -113,6 +127,26 @@ MTextList::SetList(const shared_ptr<ListType>& h)
 		hList = h;
 }
 
+void
+MTextList::PrefetchItems(IndexType idx, size_t n) const
+{
+	if(IsProvided())
+	{
+		const auto total(CountItems());
+		const auto first(idx < PrefetchMargin ? 0 : idx - PrefetchMargin);
+
+		if(first < total)
+		{
+			auto lst(FetchItems(first, min(total - first,
+				idx - first + n + PrefetchMargin)));
+
+			yunseq(cache_base = first, item_cache = std::move(lst));
+		}
+		else
+			ResetItemCache();
+	}
+}
+
 
 TextList::TextList(const Rect& r, const shared_ptr<ListType>& h,
 	const pair<Color, Color>& hilight_pair)
@@ -129,7 +163,7 @@ TextList::TextList(const Rect& r, const shared_ptr<ListType>& h,
 	SetSizeOf(unit, {GetWidth(), GetItemHeight()}),
 	yunseq(
 	FetchEvent<KeyDown>(*this) += [this](KeyEventArgs&& e){
-		if(!GetList().empty())
+		if(GetTotal() != 0)
 		{
 			using namespace KeyCodes;
 			const auto& k(e.GetKeys());
@@ -152,7 +186,7 @@ TextList::TextList(const Rect& r, const shared_ptr<ListType>& h,
 						//	implementation-defined.
 						vwList.IncreaseSelected((up ? -1 : 1) * SPos(k[Up]
 							|| k[Down] ? 1 : GetHeight() / GetItemHeight()),
-							GetList().size());
+							GetTotal());
 						if(old_sel == vwList.GetSelectedIndex()
 							&& CyclicTraverse)
 							goto bound_select;
@@ -278,7 +312,7 @@ TextList::SetSelected(ListType::size_type i)
 	{
 		const auto old_off(vwList.GetOffset());
 
-		if(vwList.SetSelectedIndex(i, GetList().size()))
+		if(vwList.SetSelectedIndex(i, GetTotal()))
 		{
 			CallSelected();
 			InvalidateSelected2(old_off, vwList.GetOffset());
@@ -348,7 +382,7 @@ TextList::LocateViewPosition(SDst h)
 		// NOTE: Prevent out-of-bounds partially displayed items first, then
 		//	adjust the view.
 		AdjustViewLength();
-		vwList.SetHeadIndex(h / item_h, GetList().size());
+		vwList.SetHeadIndex(h / item_h, GetTotal());
 		uTopOffset = h % item_h;
 		UpdateView(*this, true);
 	}
@@ -361,7 +395,7 @@ TextList::Refresh(PaintEventArgs&& e)
 	{
 		const Rect& bounds(e.ClipArea);
 
-		if(!bounds.IsUnstrictlyEmpty() && !GetList().empty())
+		if(!bounds.IsUnstrictlyEmpty() && GetTotal() != 0)
 		{
 			// NOTE: View length could be already changed by contents.
 			AdjustViewLength();
@@ -384,14 +418,14 @@ TextList::ResetView()
 void
 TextList::SelectFirst()
 {
-	vwList.SetSelectedIndex(0, GetList().size());
+	vwList.SetSelectedIndex(0, GetTotal());
 	AdjustOffsetForHeight(GetHeight(), true);
 }
 
 void
 TextList::SelectLast()
 {
-	const auto s(GetList().size());
+	const auto s(GetTotal());
 
 	vwList.SetSelectedIndex(s - 1, s);
 	AdjustOffsetForHeight(GetHeight(), {});
@@ -410,14 +444,23 @@ TextList::end()
 }
 
 
+SDst
+FetchMaxItemWidth(const TextList& tl)
+{
+	if(tl.IsProvided())
+		tl.PrefetchItems(tl.GetHeadIndex(), tl.GetLastLabelIndex()
+			- tl.GetHeadIndex());
+
+	const auto& lst(tl.IsProvided() ? tl.GetItemCache() : tl.GetList());
+
+	return FetchMaxTextWidth(tl.LabelBrush.Font, lst.cbegin(), lst.cend());
+}
+
 void
 ResizeForContent(TextList& tl)
 {
-	const auto& lst(tl.GetList());
-
-	SetSizeOf(tl, Size(FetchMaxTextWidth(tl.LabelBrush.Font, lst.cbegin(),
-		lst.cend()) + GetHorizontalOf(tl.LabelBrush.Margin),
-		tl.GetFullViewHeight()));
+	SetSizeOf(tl, Size(FetchMaxItemWidth(tl)
+		+ GetHorizontalOf(tl.LabelBrush.Margin), tl.GetFullViewHeight()));
 	tl.AdjustViewLength();
 }
 
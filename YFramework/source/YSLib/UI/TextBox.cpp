@@ -1,5 +1,5 @@
 ﻿/*
-	© 2014-2016 FrankHB.
+	© 2014-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file TextBox.cpp
 \ingroup UI
 \brief 样式相关的用户界面文本框。
-\version r739
+\version r740
 \author FrankHB <frankhb1989@gmail.com>
 \since build 482
 \par 创建时间:
 	2014-03-02 16:21:22 +0800
 \par 修改时间:
-	2016-06-20 12:15 +0800
+	2017-08-06 10:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -31,6 +31,7 @@
 #include YFM_YSLib_UI_YGUI
 #include YFM_YSLib_Service_TextLayout
 #include YFM_YSLib_UI_YUIContainer // for LocateForWidget;
+#include YFM_YSLib_Core_YApplication // for RequestWakeUp;
 #include <ystdex/cast.hpp> // for ystdex::polymorphic_downcast;
 #include <ystdex/scope_guard.hpp> // for ystdex::swap_guard;
 
@@ -75,7 +76,16 @@ Caret::Check(IWidget& sender)
 		&& caret_animation.GetConnectionRef().Ready)
 	{
 		if(IsEnabled(sender) && IsFocusedCascade(sender))
-			return CaretTimer.RefreshRemainder() < CaretTimer.Interval / 2;
+		{
+			const auto r(CaretTimer.RefreshRemainder());
+			const auto half(CaretTimer.Interval / 2);
+			const bool res(r < half);
+
+			// NOTE: Request to be woken up when the caret would be toggled.
+			RequestWakeUp(Timers::HighResolutionClock::now()
+				+ (res ? half : CaretTimer.Interval) - r);
+			return res;
+		}
 		else
 			Stop();
 	}
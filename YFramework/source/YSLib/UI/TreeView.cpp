@@ -1,5 +1,5 @@
 ﻿/*
-	© 2014-2016 FrankHB.
+	© 2014-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file TreeView.cpp
 \ingroup UI
 \brief 树形视图控件。
-\version r826
+\version r829
 \author FrankHB <frankhb1989@gmail.com>
 \since build 532
 \par 创建时间:
 	2014-08-24 16:29:28 +0800
 \par 修改时间:
-	2016-09-17 12:10 +0800
+	2017-07-26 20:48 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -325,10 +325,15 @@ TreeList::ExpandOrCollapseNodeImpl(NodeState st, size_t idx)
 	if(st == NodeState::Branch)
 	{
 		Expand(idx);
+
+		const auto& branch(AccessNode(TreeRoot, branch_pth));
+
+		// NOTE: Lazy branches may be still empty after %Expand.
+		if(branch.empty())
+			return;
 		// TODO: Check state.
 		expanded.insert(branch_pth);
 
-		const auto& branch(AccessNode(TreeRoot, branch_pth));
 		auto i(ystdex::as_const(indent_map).lower_bound(idx));
 
 		YAssert(i != indent_map.cend(), "Invalid state found.");
@@ -449,7 +454,9 @@ TreeList::ExpandOrCollapseNodeImpl(NodeState st, size_t idx)
 TreeList::NodeState
 TreeList::QueryNodeState(IndexType idx) const
 {
-	if(!GetNodeRef(idx).empty())
+	const auto& node(GetNodeRef(idx));
+
+	if(!node.empty() || (IsLazyBranch && IsLazyBranch(node)))
 	{
 		auto i(indent_map.find(idx));
 		const auto e(indent_map.cend());
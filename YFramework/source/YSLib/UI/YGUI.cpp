@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YGUI.cpp
 \ingroup UI
 \brief 平台无关的图形用户界面。
-\version r4411
+\version r4413
 \author FrankHB <frankhb1989@gmail.com>
 \since 早于 build 132
 \par 创建时间:
 	2009-11-16 20:06:58 +0800
 \par 修改时间:
-	2016-02-13 15:26 +0800
+	2017-07-25 21:14 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -46,6 +46,14 @@ IWidget&
 FetchTopEnabledAndVisibleWidget(IWidget& con, const Point& pt,
 	VisualEvent id)
 {
+	if(const auto p_index = FetchChildIndexPtr(con))
+	{
+		const auto p(p_index->Find(con, pt, [=](IWidget& wgt){
+			return IsVisible(wgt) && wgt.GetController().IsEventEnabled(id);
+		}));
+
+		return p ? *p : con;
+	}
 	for(auto pr(con.GetChildren()); pr.first != pr.second; ++pr.first)
 	{
 		auto& wgt(*pr.first);
@@ -123,6 +131,15 @@ CallInputEvent(IWidget& wgt, const String& str, const KeyInput& k)
 }
 
 
+Timers::TimePoint
+GUIState::GetHeldDeadline() const ynothrow
+{
+	return KeyHeldState != InputTimer::Free
+		|| TouchHeldState != InputTimer::Free || checked_held.any()
+		? HeldTimer.GetBaseTick() + HeldTimer.Interval
+		: Timers::TimePoint::max();
+}
+
 bool
 GUIState::CheckHeldState(const KeyInput& keys, InputTimer::HeldStateType& s)
 {
@@ -11,13 +11,13 @@
 /*!	\file YPanel.cpp
 \ingroup UI
 \brief 样式无关的 GUI 面板。
-\version r299
+\version r301
 \author FrankHB <frankhb1989@gmail.com>
 \since build 201
 \par 创建时间:
 	2011-04-13 20:44:51 +0800
 \par 修改时间:
-	2016-02-12 01:10 +0800
+	2017-07-25 21:14 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -63,6 +63,7 @@ Panel::ClearContents()
 {
 	ClearFocusingOf(*this);
 	mWidgets.clear();
+	InvalidateChildIndexOf(*this);
 	SetInvalidationOf(*this);
 }
 
@@ -80,6 +81,7 @@ Panel::MoveToFront(IWidget& wgt)
 
 		mWidgets.erase(i);
 		mWidgets.emplace(z, ystdex::ref(wgt));
+		InvalidateChildIndexOf(*this);
 		Invalidate(wgt);
 		return true;
 	}
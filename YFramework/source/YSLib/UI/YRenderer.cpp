@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YRenderer.cpp
 \ingroup UI
 \brief 样式无关的 GUI 部件渲染器。
-\version r680
+\version r683
 \author FrankHB <frankhb1989@gmail.com>
 \since build 237
 \par 创建时间:
 	2011-09-03 23:46:22 +0800
 \par 修改时间:
-	2016-12-01 22:07 +0800
+	2017-08-06 21:30 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -29,6 +29,11 @@
 #include YFM_YSLib_UI_YRenderer
 #include YFM_YSLib_UI_YControl
 #include YFM_YSLib_Service_YGDI
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+#	include <thread> // for std::thread::hardware_concurrency;
+#	include <future> // for std::future;
+#	include <exception> // for std::exception_ptr;
+#endif
 
 namespace YSLib
 {
@@ -36,6 +41,27 @@ namespace YSLib
 namespace UI
 {
 
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+namespace
+{
+
+//! \since build 823
+//@{
+thread_local bool is_paint_worker;
+
+//! \brief 取并发数：参数为 0 时为硬件线程数。
+size_t
+FetchPaintConcurrency(size_t n)
+{
+	return std::max<size_t>(n != 0 ? n : std::thread::hardware_concurrency(),
+		1);
+}
+//@}
+
+} // unnamed namespace;
+#endif
+
+
 Rect
 Renderer::Paint(IWidget& wgt, PaintEventArgs&& e)
 {
@@ -143,6 +169,129 @@ BufferedRenderer::Validate(IWidget& wgt, IWidget& sender,
 	return {};
 }
 
+
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+ConcurrentPainter::ConcurrentPainter(size_t n)
+	: pool(FetchPaintConcurrency(n) - 1, []() ynothrow{
+		is_paint_worker = true;
+	}), concurrency(FetchPaintConcurrency(n))
+{}
+#else
+ConcurrentPainter::ConcurrentPainter(size_t)
+	: concurrency(1)
+{}
+#endif
+ImplDeDtor(ConcurrentPainter)
+
+void
+ConcurrentPainter::PaintVisibleChildren(const vector<lref<IWidget>>& children,
+	PaintEventArgs& e)
+{
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+	if(concurrency > 1 && !is_paint_worker && !e.ClipArea.IsUnstrictlyEmpty())
+	{
+		// NOTE: Only visible children intersecting with the clip area are
+		//	painted, as %PaintChild does.
+		vector<pair<lref<IWidget>, Rect>> items;
+
+		for(IWidget& wgt : children)
+			if(IsVisible(wgt))
+			{
+				const auto r(e.ClipArea & Rect(e.Location
+					+ GetLocationOf(wgt), GetSizeOf(wgt)));
+
+				if(!r.IsUnstrictlyEmpty())
+					items.emplace_back(wgt, r);
+			}
+		if(items.empty())
+			return;
+
+		// NOTE: Batches are painted in order. Children in a batch are
+		//	thread-safe and have disjoint clip areas. The children of a batch
+		//	are partitioned to tasks, so each child is painted exactly once
+		//	by only one thread.
+		vector<size_t> batch;
+		vector<Rect> res;
+		const auto flush([&]{
+			if(!batch.empty())
+			{
+				const auto m(batch.size());
+				const auto n(std::min(concurrency, m));
+
+				res.assign(m, {});
+				RunConcurrently(n, [&](size_t i){
+					for(auto j(m * i / n); j != m * (i + 1) / n; ++j)
+						res[j] = PaintChild(items[batch[j]].first, e);
+				});
+				for(const auto& r : res)
+					e.ClipArea |= r;
+				batch.clear();
+			}
+		});
+
+		for(size_t i(0); i != items.size(); ++i)
+		{
+			const auto& item(items[i]);
+
+			if(IsPaintThreadSafe(item.first))
+			{
+				// NOTE: Adjacent children sharing only edges are disjoint.
+				if(std::any_of(batch.cbegin(), batch.cend(), [&](size_t j){
+					return !(items[j].second & item.second)
+						.IsUnstrictlyEmpty();
+				}))
+					flush();
+				batch.push_back(i);
+			}
+			else
+			{
+				flush();
+				PaintChildAndCommit(item.first, e);
+			}
+		}
+		flush();
+		return;
+	}
+#endif
+	for(IWidget& wgt : children)
+		PaintVisibleChildAndCommit(wgt, e);
+}
+
+void
+ConcurrentPainter::RunConcurrently(size_t n, std::function<void(size_t)> f)
+{
+	YAssert(n <= concurrency, "Invalid task number found.");
+#if YF_Multithread == 1 && YB_HAS_THREAD_LOCAL
+	vector<std::future<void>> futures;
+	std::exception_ptr p_ex;
+
+	futures.reserve(n);
+	for(size_t i(1); i < n; ++i)
+		futures.push_back(pool.enqueue([&, i]{
+			f(i);
+		}));
+	TryExpr(f(0))
+	CatchExpr(..., p_ex = std::current_exception())
+	// NOTE: All tasks shall be finished before unwinding since they refer to
+	//	the caller's frame.
+	for(auto& fut : futures)
+		try
+		{
+			fut.get();
+		}
+		catch(...)
+		{
+			if(!p_ex)
+				p_ex = std::current_exception();
+		}
+	if(p_ex)
+		std::rethrow_exception(p_ex);
+#else
+	for(size_t i(0); i < n; ++i)
+		f(i);
+#endif
+}
+
 } // namespace UI;
 
 } // namespace YSLib;
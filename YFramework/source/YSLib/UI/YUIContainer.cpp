@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YUIContainer.cpp
 \ingroup UI
 \brief 样式无关的 GUI 容器。
-\version r1942
+\version r1946
 \author FrankHB <frankhb1989@gmail.com>
 \since build 188
 \par 创建时间:
 	2011-01-22 08:03:49 +0800
 \par 修改时间:
-	2016-02-12 01:06 +0800
+	2017-08-05 11:10 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -28,6 +28,7 @@
 #include "YSLib/UI/YModules.h"
 #include YFM_YSLib_UI_YDesktop
 #include <ystdex/functional.hpp> // for ystdex::bind1;
+#include <cmath> // for std::ceil, std::sqrt;
 
 using namespace ystdex;
 
@@ -160,6 +161,98 @@ MoveToTop(IWidget& wgt)
 }
 
 
+yconstexpr const size_t WidgetGridIndex::MaxCellCount;
+
+size_t
+WidgetGridIndex::LocateCell(const Point& pt) const ynothrowv
+{
+	YAssert(extent.Contains(pt), "Point is out of the index extent.");
+	return min(size_t(SDst(pt.Y - extent.Y) / cell_height), rows - 1) * columns
+		+ min(size_t(SDst(pt.X - extent.X) / cell_width), columns - 1);
+}
+
+void
+WidgetGridIndex::Rebuild(IWidget& con)
+{
+	vector<pair<observer_ptr<IWidget>, Rect>> children;
+	Rect ext;
+
+	for(auto pr(con.GetChildren()); pr.first != pr.second; ++pr.first)
+	{
+		auto& wgt(*pr.first);
+		const auto r(GetBoundsOf(wgt));
+
+		if(!r.IsUnstrictlyEmpty())
+		{
+			children.emplace_back(make_observer(&wgt), r);
+			ext |= r;
+		}
+	}
+
+	// NOTE: Each axis is split into about the square root of child count
+	//	cells so the average size of a cell is kept bounded.
+	const auto n(min(max(size_t(std::ceil(std::sqrt(children.size()))),
+		size_t(1)), MaxCellCount));
+	const auto cw(max(SDst((ext.Width + n - 1) / n), SDst(1))),
+		ch(max(SDst((ext.Height + n - 1) / n), SDst(1)));
+	const size_t cols((size_t(ext.Width) + cw - 1) / cw),
+		rws((size_t(ext.Height) + ch - 1) / ch), cnt(cols * rws);
+	vector<size_t> offs(cnt + 1);
+	// NOTE: Offsets are computed in signed arithmetic and clamped to the
+	//	cells of the extent before conversion.
+	const auto locate([](std::ptrdiff_t d, SDst c, size_t m) ynothrow{
+		return d > 0 ? min(size_t(d) / c, m - 1) : size_t(0);
+	});
+	const auto for_cells([&](const Rect& r, std::function<void(size_t)> f){
+		const auto x0(locate(std::ptrdiff_t(r.X) - ext.X, cw, cols)),
+			x1(locate(std::ptrdiff_t(r.GetRight()) - 1 - ext.X, cw, cols));
+
+		for(auto y(locate(std::ptrdiff_t(r.Y) - ext.Y, ch, rws)),
+			y1(locate(std::ptrdiff_t(r.GetBottom()) - 1 - ext.Y, ch, rws));
+			y <= y1; ++y)
+			for(auto x(x0); x <= x1; ++x)
+				f(y * cols + x);
+	});
+
+	for(const auto& pr : children)
+		for_cells(pr.second, [&](size_t idx){
+			++offs[idx + 1];
+		});
+	for(size_t i(0); i != cnt; ++i)
+		offs[i + 1] += offs[i];
+
+	vector<observer_ptr<IWidget>> its(offs.back());
+	auto pos(offs);
+
+	for(const auto& pr : children)
+		for_cells(pr.second, [&](size_t idx){
+			its[pos[idx]++] = pr.first;
+		});
+	yunseq(extent = ext, columns = cols, rows = rws, cell_width = cw,
+		cell_height = ch, offsets = std::move(offs), items = std::move(its),
+		valid = true);
+}
+
+
+void
+InvalidateChildIndexOf(IWidget& wgt)
+{
+	if(const auto p = FetchChildIndexPtr(wgt))
+		p->Invalidate();
+}
+
+void
+SetChildIndexingOf(IWidget& wgt, bool b)
+{
+	auto& p(wgt.GetView().ChildIndexPtr);
+
+	if(!b)
+		p.reset();
+	else if(!p)
+		p = make_shared<WidgetGridIndex>();
+}
+
+
 bool
 RemoveFrom(IWidget& wgt, IWidget& con)
 {
@@ -252,10 +345,8 @@ MUIContainer::Contains(IWidget& wgt)
 void
 MUIContainer::PaintVisibleChildren(PaintEventArgs& e)
 {
-	std::for_each(mWidgets.cbegin() | get_value, mWidgets.cend() | get_value,
-		[&](const ItemType& wgt_ref){
-		PaintVisibleChildAndCommit(wgt_ref, e);
-	});
+	PaintVisibleChildrenAndCommit({mWidgets.cbegin() | get_value | get_get,
+		mWidgets.cend() | get_value | get_get}, e);
 }
 
 ZOrder
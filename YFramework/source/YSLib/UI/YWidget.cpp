@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2016 FrankHB.
+	© 2009-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YWidget.cpp
 \ingroup UI
 \brief 样式无关的 GUI 部件。
-\version r4490
+\version r4492
 \author FrankHB <frankhb1989@gmail.com>
 \since 早于 build 132
 \par 创建时间:
 	2009-11-16 20:06:58 +0800
 \par 修改时间:
-	2016-12-01 22:05 +0800
+	2017-08-04 20:15 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -59,6 +59,18 @@ SetBoundsOf(IWidget& wgt, const Rect& r)
 	SetSizeOf(wgt, r.GetSize());
 }
 
+void
+SetContainerPtrOf(IWidget& wgt, observer_ptr<IWidget> p_con)
+{
+	auto& p(wgt.GetView().ContainerPtr);
+
+	if(p)
+		InvalidateChildIndexOf(*p);
+	p = p_con;
+	if(p_con)
+		InvalidateChildIndexOf(*p_con);
+}
+
 void
 SetInvalidationOf(IWidget& wgt)
 {
@@ -191,6 +203,16 @@ PaintChildAndCommit(IWidget& wgt, PaintEventArgs& e)
 	e.ClipArea |= PaintChild(wgt, e);
 }
 
+void
+PaintVisibleChildrenAndCommit(WidgetRange pr, PaintEventArgs& e)
+{
+	if(const auto p_painter = FetchConcurrentPainterPtr(e.GetSender()))
+		p_painter->PaintVisibleChildren({pr.first, pr.second}, e);
+	else
+		for(; pr.first != pr.second; ++pr.first)
+			PaintVisibleChildAndCommit(*pr.first, e);
+}
+
 void
 RequestToFront(IWidget& wgt)
 {
@@ -264,8 +286,7 @@ void
 Widget::Refresh(PaintEventArgs&& e)
 {
 	if(!e.ClipArea.IsUnstrictlyEmpty())
-		for(auto pr(GetChildren()); pr.first != pr.second; ++pr.first)
-			PaintVisibleChildAndCommit(*pr.first, e);
+		PaintVisibleChildrenAndCommit(GetChildren(), e);
 }
 
 } // namespace UI;
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2009-2013, 2015-2016 FrankHB.
+	© 2009-2013, 2015-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file YWidgetView.cpp
 \ingroup UI
 \brief 样式无关的 GUI 部件。
-\version r245
+\version r250
 \author FrankHB <frankhb1989@gmail.com>
 \since build 258
 \par 创建时间:
 	2009-11-16 20:06:58 +0800
 \par 修改时间:
-	2016-07-14 23:08 +0800
+	2017-08-04 20:15 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -26,7 +26,7 @@
 
 
 #include "YSLib/UI/YModules.h"
-#include YFM_YSLib_UI_YWidget
+#include YFM_YSLib_UI_YUIContainer
 #include <ystdex/scope_guard.hpp> // for ystdex::swap_guard;
 
 namespace YSLib
@@ -47,7 +47,17 @@ swap(AView& x, AView& y) ynothrow
 {
 	std::swap(x.ContainerPtr, y.ContainerPtr),
 	std::swap(x.DependencyPtr, y.DependencyPtr),
-	std::swap(x.FocusingPtr, y.FocusingPtr);
+	std::swap(x.FocusingPtr, y.FocusingPtr),
+	std::swap(x.ChildIndexPtr, y.ChildIndexPtr),
+	std::swap(x.ConcurrentPainterPtr, y.ConcurrentPainterPtr),
+	std::swap(x.PaintThreadSafe, y.PaintThreadSafe);
+}
+
+void
+InvalidateContainerIndexOf(const AView& v)
+{
+	if(const auto p_con = v.ContainerPtr)
+		InvalidateChildIndexOf(*p_con);
 }
 
 void
@@ -75,6 +85,12 @@ View::IsVisible() const ynothrow
 		DependencyPtr ? DependencyPtr->GetView().IsVisible() : visual.Visible;
 }
 
+void
+View::SetHeight(SDst h)
+{
+	GetSizeRef().Height = h;
+	InvalidateContainerIndexOf(*this);
+}
 void
 View::SetVisible(bool b)
 {
@@ -83,6 +99,42 @@ View::SetVisible(bool b)
 	else
 		visual.Visible = b;
 }
+void
+View::SetWidth(SDst w)
+{
+	GetSizeRef().Width = w;
+	InvalidateContainerIndexOf(*this);
+}
+void
+View::SetX(SPos x)
+{
+	GetLocationRef().X = x;
+	InvalidateContainerIndexOf(*this);
+}
+void
+View::SetY(SPos y)
+{
+	GetLocationRef().Y = y;
+	InvalidateContainerIndexOf(*this);
+}
+void
+View::SetBounds(const Rect& r)
+{
+	visual.Bounds = r;
+	InvalidateContainerIndexOf(*this);
+}
+void
+View::SetLocation(const Point& pt)
+{
+	visual.Bounds.GetPointRef() = pt;
+	InvalidateContainerIndexOf(*this);
+}
+void
+View::SetSize(const Size& s)
+{
+	visual.Bounds.GetSizeRef() = s;
+	InvalidateContainerIndexOf(*this);
+}
 
 } // namespace UI;
 
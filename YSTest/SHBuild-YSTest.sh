@@ -1,5 +1,5 @@
 #!/usr/bin/env sh
-# (C) 2014-2016 FrankHB.
+# (C) 2014-2017 FrankHB.
 # Build script for YSTest using SHBuild.
 
 set -e
@@ -7,6 +7,8 @@ set -e
 SHBuild_CheckHostPlatform
 SHBuild_AssertNonempty SHBuild_Host_Platform
 SHBuild_AppBaseDir=$(cd `dirname "$0"`/../build/$SHBuild_Host_Platform; pwd)
+: ${YSLib_BuildDir:="$SHBuild_AppBaseDir"}
+export YSLib_BuildDir
 . SHBuild-BuildApp.sh $@
 SrcDir=$(cd `dirname "$0"`; pwd)
 SHBuild_BuildApp -xid,Android -xid,DS -xid,DS_ARM7 -xid,DS_ARM9 "$SrcDir" \
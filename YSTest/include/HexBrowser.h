@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2015 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file HexBrowser.h
 \ingroup YReader
 \brief 十六进制浏览器。
-\version r550
+\version r563
 \author FrankHB <frankhb1989@gmail.com>
 \since build 253
 \par 创建时间:
 	2011-10-14 18:13:04 +0800
 \par 修改时间:
-	2015-11-26 14:45 +0800
+	2017-08-06 14:15 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -47,20 +47,51 @@ namespace UI
 */
 class HexModel final
 {
+public:
+	/*!
+	\brief 数据视图类型。
+	\since build 803
+	*/
+	using View = string_view;
+	/*!
+	\brief 文件大小和位置类型。
+	\note 不依赖 size_t 的宽度，以支持超过地址空间大小的文件。
+	\since build 823
+	*/
+	using SizeType = std::uint64_t;
+
 private:
+	/*!
+	\brief 映射的文件数据源。
+	\note 为空时使用文件流数据源。
+	\since build 803
+	*/
+	MappedFile mapped{};
 	/*!
 	\brief 文件流数据源。
+	\note 仅在映射失败或不支持映射时使用。
 	\since build 619
 	*/
 	mutable filebuf source{};
-	//! \since build 597
-	size_t size = 0;
+	//! \since build 823
+	SizeType size = 0;
+	//! \since build 803
+	//@{
+	/*!
+	\brief 最近读取的位置。
+	\since build 823
+	*/
+	mutable SizeType position = 0;
+	//! \brief 文件流读取的缓冲区。
+	mutable vector<char> buffer{};
+	//@}
 
 public:
 	DefDeCtor(HexModel)
 	/*!
 	\brief 构造：以二进制只读模式打开文件并初始化大小。
 	\pre 间接断言：路径参数非空。
+	\note 宿主平台：优先映射文件，失败或大小超过 size_t 的范围时使用文件流。
 	\since build 412
 	*/
 	YB_NONNULL(2)
@@ -69,27 +100,28 @@ public:
 
 	DefDeMoveAssignment(HexModel)
 
-	DefPred(const ynothrow, Valid, source.is_open())
+	//! \since build 803
+	DefPred(const ynothrow, Valid, bool(mapped) || source.is_open())
 
 public:
-	//! \since build 587
-	DefGetter(const, size_t, Position,
-		size_t(source.pubseekoff(0, std::ios_base::cur, std::ios_base::in)))
-	DefGetter(const ynothrow, size_t, Size, size)
+	//! \since build 823
+	//@{
+	DefGetter(const ynothrow, SizeType, Position, position)
+	DefGetter(const ynothrow, SizeType, Size, size)
+	//@}
 
-	//! \since build 620
-	DefBoolNeg(explicit, source.is_open())
+	//! \since build 803
+	DefBoolNeg(explicit, IsValid())
 
 	/*!
-	\pre 间接断言；参数非空。
-	\since build 597
+	\brief 读取指定位置起始的不超过指定长度的数据并设置当前位置。
+	\return 数据视图；位置越界时为空。
+	\note 映射文件时不复制数据，并按位置变化方向提示预读后续数据。
+	\warning 返回的视图在下一次读取或修改模型后可能失效。
+	\since build 823
 	*/
-	PDefH(std::streamsize, Fill, char* dst, std::streamsize n) const
-		ImplRet(source.sgetn(Nonnull(dst), n))
-
-	//! \since build 632
-	PDefH(void, Seek, std::streamoff off) const
-		ImplExpr(source.pubseekoff(off, std::ios_base::beg, std::ios_base::in))
+	View
+	Read(SizeType, size_t) const;
 };
 
 
@@ -104,7 +136,8 @@ public:
 	static yconstexpr const size_t ItemPerLine = 8; //!< 每行数据总数（字节）。
 
 	using IndexType = std::uintptr_t; //!< 索引类型。
-	using DataType = vector<char>; //!< 显示数据类型。
+	//! \since build 803
+	using DataType = HexModel::View; //!< 显示数据类型。
 
 protected:
 	Drawing::TextState TextState; //!< 文本状态。
@@ -115,6 +148,7 @@ private:
 protected:
 	/*!
 	\brief 当前显示的数据。
+	\note 引用模型中的数据，绘制时转换为十六进制文本。
 	\since 356
 	*/
 	DataType datCurrent;
@@ -188,10 +222,10 @@ public:
 
 	/*!
 	\brief 定位视图顶端至指定竖直位置（行数）。
-	\since build 474
+	\since build 823
 	*/
 	void
-	LocateViewPosition(size_t);
+	LocateViewPosition(HexModel::SizeType);
 
 	/*!
 	\brief 刷新：按指定参数绘制界面并更新状态。
@@ -203,8 +237,9 @@ public:
 	void
 	Reset();
 
+	//! \since build 823
 	void
-	UpdateData(std::uint32_t);
+	UpdateData(HexModel::SizeType);
 
 	/*!
 	\brief 更新视图。
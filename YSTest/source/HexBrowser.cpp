@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2015 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file HexBrowser.cpp
 \ingroup YReader
 \brief 十六进制浏览器。
-\version r670
+\version r683
 \author FrankHB <frankhb1989@gmail.com>
 \since build 253
 \par 创建时间:
 	2011-10-14 18:12:20 +0800
 \par 修改时间:
-	2015-09-11 18:03 +0800
+	2017-08-06 14:15 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -27,6 +27,7 @@
 
 #include "HexBrowser.h"
 #include <new>
+#include <limits> // for std::numeric_limits;
 
 namespace YSLib
 {
@@ -39,9 +40,64 @@ namespace UI
 
 HexModel::HexModel(const char* path)
 {
-	source.open(Nonnull(path), std::ios_base::ate | std::ios_base::binary
-		| std::ios_base::in);
-	size = GetPosition();
+	if(source.open(Nonnull(path), std::ios_base::ate | std::ios_base::binary
+		| std::ios_base::in))
+	{
+		const std::streamoff off(source.pubseekoff(0, std::ios_base::cur,
+			std::ios_base::in));
+
+		size = off < 0 ? 0 : SizeType(off);
+#if YF_Hosted
+		// NOTE: Empty files cannot be mapped. For platform %DS, the mapping is
+		//	emulated by reading the whole file, so it is not used here. Files
+		//	larger than %size_t can represent are not mapped and they are
+		//	browsed by the file stream.
+		if(size != 0 && size <= std::numeric_limits<size_t>::max())
+			try
+			{
+				mapped = MappedFile(path);
+				source.close();
+			}
+			CatchExpr(std::exception& e, YTraceDe(Informative,
+				"Failed mapping file, using file stream: %s.", e.what()))
+#endif
+	}
+}
+
+HexModel::View
+HexModel::Read(SizeType pos, size_t n) const
+{
+	if(pos < size && n != 0)
+	{
+		n = size_t(min<SizeType>(n, size - pos));
+		if(mapped)
+		{
+			// NOTE: The mapping is only used when the size fits in %size_t.
+			const auto off(static_cast<size_t>(pos));
+
+			// NOTE: Read ahead in the direction of the position change, so
+			//	scrolling would not stall on page faults.
+			if(pos < position)
+				mapped.Advise(off < n ? 0 : off - n, min(off, n));
+			else
+				mapped.Advise(off + n, n);
+			position = pos;
+			return {reinterpret_cast<const char*>(mapped.GetPtr()) + off, n};
+		}
+		if(source.is_open())
+		{
+			buffer.resize(n);
+			// XXX: Conversion to 'std::streamoff' and 'std::streamsize' might
+			//	be implementation-defined.
+			source.pubseekoff(std::streamoff(pos), std::ios_base::beg,
+				std::ios_base::in);
+			buffer.resize(size_t(source.sgetn(buffer.data(),
+				std::streamsize(n))));
+			position = pos;
+			return {buffer.data(), buffer.size()};
+		}
+	}
+	return {};
 }
 
 HexView::HexView(FontCache& fc)
@@ -98,7 +154,7 @@ HexViewArea::Load(const char* path)
 
 	if(model)
 	{
-		const IndexType n_total_ln((model.GetSize() + ItemPerLine - 1)
+		const auto n_total_ln((model.GetSize() + ItemPerLine - 1)
 			/ ItemPerLine);
 
 		if(n_total_ln > GetItemNum())
@@ -112,9 +168,9 @@ HexViewArea::Load(const char* path)
 }
 
 void
-HexViewArea::LocateViewPosition(size_t line)
+HexViewArea::LocateViewPosition(HexModel::SizeType line)
 {
-	UpdateData(std::uint32_t(ItemPerLine * line));
+	UpdateData(ItemPerLine * line);
 	UpdateView(true);
 }
 
@@ -130,15 +186,19 @@ HexViewArea::Refresh(PaintEventArgs&& e)
 	ScrollableContainer::Refresh(std::move(e));
 	TextState.ResetPen();
 
+	const auto fsize(model.GetSize());
+	// NOTE: Addresses are shown in 8 hexadecimal digits, or 16 digits if the
+	//	file is not less than 4 GiB.
+	const SDst n_addr(fsize > 0xFFFFFFFFU ? 16 : 8);
 	auto& y(TextState.Pen.Y);
 	const SDst lh(GetItemHeight()), h(GetHeight()),
 		w_all(GetWidth() - vsbVertical.GetWidth()
 			- GetHorizontalOf(TextState.Margin)),
-		w_blank(w_all / (10 + ItemPerLine * 3)),
-		w_ch((w_all - w_blank * (1 + ItemPerLine)) / (8 + ItemPerLine * 2)),
-		w_addr(w_ch * 8 + w_blank),
+		w_blank(w_all / (n_addr + 2 + ItemPerLine * 3)),
+		w_ch((w_all - w_blank * (1 + ItemPerLine))
+			/ (n_addr + ItemPerLine * 2)),
+		w_addr(w_ch * n_addr + w_blank),
 		w_item(w_ch * 2 + w_blank);
-	const auto fsize(model.GetSize());
 	auto& pen_x(TextState.Pen.X);
 	TextRenderer tr(TextState, e.Target);
 	auto pos(model.GetPosition());
@@ -151,22 +211,31 @@ HexViewArea::Refresh(PaintEventArgs&& e)
 		auto x(pen_x);
 
 		{
-			char straddr[(32 >> 2) + 1];
+			char straddr[(64 >> 2) + 1];
 
-			std::sprintf(straddr, "%08tX", pos);
+			std::sprintf(straddr, "%0*llX", int(n_addr),
+				static_cast<unsigned long long>(pos));
 			PutLine(tr, straddr);
 		}
 		// XXX: Conversion to 'SPos' might be implementation-defined.
 		x += SPos(w_addr);
 
-		const auto n(min<IndexType>(fsize - pos, IndexType(ItemPerLine)));
+		const auto n(IndexType(min<HexModel::SizeType>(fsize - pos,
+			ItemPerLine)));
 
 		// XXX: Conversion to 'ptrdiff_t' might be implementation-defined.
-		for(IndexType j(0); j < n;
-			yunseq(++j, i_data += 2, x += ptrdiff_t(w_item)))
+		for(IndexType j(0); j < n && i_data != datCurrent.cend();
+			yunseq(++j, ++i_data, x += ptrdiff_t(w_item)))
 		{
+			const auto c(*i_data);
+			char str[2];
+
+			yunseq(str[0] = (c >> 4 & 0x0F) + '0', str[1] = (c & 0x0F) + '0');
+			for(auto& d : str)
+				if(d > '9')
+					d += 'A' - '9' - 1;
 			pen_x = x;
-			PutLine(tr, &*i_data, &*i_data + 2);
+			PutLine(tr, &str[0], &str[0] + 2);
 		}
 		// XXX: Conversion to 'SPos' might be implementation-defined.
 		yunseq(y += SPos(lh + TextState.LineGap), pos += ItemPerLine);
@@ -177,50 +246,29 @@ void
 HexViewArea::Reset()
 {
 	vsbVertical.SetValue(0);
-	datCurrent.clear();
+	datCurrent = {};
 	UpdateItemNum(GetHeight());
 	UpdateView();
 }
 
 void
-HexViewArea::UpdateData(std::uint32_t pos)
+HexViewArea::UpdateData(HexModel::SizeType pos)
 {
 	if(model.IsValid() && pos < model.GetSize())
 	{
-		const DataType::size_type n(ItemPerLine * GetItemNum());
-		DataType v_buf(n);
+		const auto n(ItemPerLine * GetItemNum());
 
-		if(YB_UNLIKELY(v_buf.empty()))
+		if(YB_UNLIKELY(n == 0))
 		{
 			YTraceDe(Notice, "Give up empty view area.");
 			return;
 		}
-		// XXX: Conversion to 'std::streamoff' might be implementation-defined.
-		model.Seek(std::streamoff(pos));
-		v_buf.resize(DataType::size_type(model.Fill(&v_buf[0],
-			std::streamsize(n))));
-		datCurrent.resize(v_buf.size() * 2);
-
+		// NOTE: 'Refresh' uses the position of the model to check if it is
+		//	towards EOF.
+		datCurrent = model.Read(pos, n);
 		if(YB_UNLIKELY(datCurrent.empty()))
-		{
 			YTraceDe(Warning, "Empty data read.");
-			return;
-		}
-
-		auto b(&datCurrent[0]);
-
-		for(const char c : v_buf)
-		{
-			char h, l;
-
-			yunseq(h = (c >> 4 & 0x0F) + '0', l = (c & 0x0F) + '0');
-			*b++ = h > '9' ? h + 'A' - '9' - 1 : h;
-			*b++ = l > '9' ? l + 'A' - '9' - 1 : l;
-		}
 	//	vsbVertical.SetValue(pos / ItemPerLine);
-		// NOTE: 'Refresh' needs this to check if it is towards EOF.
-		// XXX: Conversion to 'std::streamoff' might be implementation-defined.
-		model.Seek(std::streamoff(pos));
 	}
 }
 
@@ -1,5 +1,5 @@
 ﻿/*
-	© 2011-2016 FrankHB.
+	© 2011-2017 FrankHB.
 
 	This file is part of the YSLib project, and may only be used,
 	modified, and distributed under the terms of the YSLib project
@@ -11,13 +11,13 @@
 /*!	\file ShlReader.cpp
 \ingroup YReader
 \brief Shell 阅读器框架。
-\version r4891
+\version r4892
 \author FrankHB <frankhb1989@gmail.com>
 \since build 263
 \par 创建时间:
 	2011-11-24 17:13:41 +0800
 \par 修改时间:
-	2016-09-17 12:40 +0800
+	2017-08-06 10:40 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -584,6 +584,7 @@ void
 ShlTextReader::Scroll()
 {
 	if(tmrScrollActive)
+	{
 		if(YB_UNLIKELY(tmrScroll.Refresh()))
 		{
 			if(CurrentSetting.SmoothScroll)
@@ -591,6 +592,8 @@ ShlTextReader::Scroll()
 			else
 				reader.Execute(DualScreenReader::LineDownScroll);
 		}
+		RequestWakeUp(FetchDeadline(tmrScroll));
+	}
 }
 
 void
@@ -617,6 +620,8 @@ ShlTextReader::StartAutoScroll()
 	fBackgroundTask = std::bind(&ShlTextReader::Scroll, this);
 	Activate(tmrScroll),
 	tmrScrollActive = tmrScroll.Interval != Timers::Duration::zero();
+	if(tmrScrollActive)
+		RequestWakeUp(FetchDeadline(tmrScroll));
 }
 
 void
@@ -11,13 +11,13 @@
 /*!	\file test.cpp
 \ingroup Test
 \brief YBase 测试。
-\version r630
+\version r641
 \author FrankHB <frankhb1989@gmail.com>
 \since build 519
 \par 创建时间:
 	2014-07-10 05:09:57 +0800
 \par 修改时间:
-	2017-01-03 10:45 +0800
+	2017-08-05 17:55 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -26,6 +26,7 @@
 
 
 #include <ytest/test.h>
+#include <ytest/bench.h>
 #include <ystdex/functional.hpp>
 #include <vector>
 #include <list>
@@ -39,6 +40,41 @@
 #include <ystdex/tstring_view.hpp>
 #include <ystdex/mixin.hpp>
 #include <ystdex/bitseg.hpp>
+#include <ystdex/any.h>
+#include <ystdex/memory.hpp>
+#include <ystdex/set.hpp>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+/*!
+\brief 全局分配函数的调用次数。
+\since build 823
+*/
+std::size_t allocation_count;
+
+} // unnamed namespace;
+
+//! \since build 823
+//@{
+void*
+operator new(std::size_t size)
+{
+	++allocation_count;
+	if(const auto p = std::malloc(size != 0 ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) ynothrow
+{
+	std::free(p);
+}
+//@}
+
 
 namespace
 {
@@ -248,12 +284,99 @@ expect(const string& str, vector<byte>&& seq)
 
 } // namespace bitseg_test;
 
+//! \since build 823
+namespace any_test
+{
+
+//! \brief 能在内部存储中保存 string 的 any 。
+using large_any = basic_any<any_ops::basic_any_storage<
+	sizeof(string) + sizeof(void*)>>;
+
+//! \brief 构造、复制、转移和交换保存短字符串的对象时的分配次数。
+template<class _tAny>
+size_t
+count_allocations()
+{
+	const auto n(allocation_count);
+	_tAny x(string("foo")), y(x), z(std::move(y));
+
+	swap(x, z);
+	return any_cast<string&>(x) == "foo" ? allocation_count - n : size_t(-1);
+}
+
+} // namespace any_test;
+
+//! \since build 818
+//@{
+YTEST_BENCH(ContainerVectorPushBack, n)
+{
+	for(size_t i(0); i != n; ++i)
+	{
+		vector<int> v;
+
+		for(int j(0); j != 64; ++j)
+			v.push_back(j);
+		bench::do_not_optimize(v);
+	}
+}
+
+YTEST_BENCH(SetMappedFind, n)
+{
+	mapped_set<string, ystdex::less<>> x{string("foo"), string("bar"),
+		string("baz")};
+
+	for(size_t i(0); i != n; ++i)
+		bench::do_not_optimize(x.find("bar"));
+}
+//@}
+
+//! \since build 823
+//@{
+template<class _tAny>
+void
+bench_any_copy(size_t n)
+{
+	const _tAny x(string("foo"));
+
+	for(size_t i(0); i != n; ++i)
+	{
+		_tAny y(x);
+
+		bench::do_not_optimize(y);
+	}
+}
+
+YTEST_BENCH(AnyCopyString, n)
+{
+	bench_any_copy<ystdex::any>(n);
+}
+
+YTEST_BENCH(AnyCopyStringLargeStorage, n)
+{
+	bench_any_copy<any_test::large_any>(n);
+}
+//@}
+
 } // unnamed namespace;
 
 
 int
-main()
+main(int argc, char* argv[])
 {
+	bench::options bench_opts;
+
+	// NOTE: Run benchmarks instead of tests when '--bench' is specified.
+	if(argc > 1 && string(argv[1]) == "--bench")
+	{
+		if(!bench_opts.parse(argc, argv))
+		{
+			cerr << "Invalid benchmark options." << endl;
+			return 2;
+		}
+		return bench::registry::instance().run(bench_opts, cout) == 0 ? 0 : 1;
+	}
+
+
 	const auto make_guard([](const string& subject){
 		return group_guard(subject, [](group_guard& printer){
 			cout << "CASES: " << printer.subject << ':' << endl;
@@ -547,6 +670,87 @@ main()
 		bitseg_test::expect<4, true>("0102030517c0f0ff",
 			{1, 2, 3, 5, 0x17, 0xC0, 0xF0, 0xFF})
 	);
+	// 5 cases covering: ystdex::basic_any.
+	seq_apply(make_guard("YStandard.Any").get(pass, fail),
+		// NOTE: The default storage is too small to hold a string in place.
+		//	The holders are allocated for construction and copy.
+		any_test::count_allocations<ystdex::any>() == 2,
+		any_test::count_allocations<any_test::large_any>() == 0,
+		expect(make_pair(string("foo"), string("bar")), []{
+			using any_t = basic_any<any_ops::basic_any_storage<
+				sizeof(string) + sizeof(void*)>>;
+			any_t x(string("foo")), y(string("bar"));
+
+			swap(x, y);
+			swap(x, y);
+			return make_pair(any_cast<string>(x), any_cast<const string&>(y));
+		}),
+		expect(string("bar"), []{
+			using any_t = basic_any<any_ops::basic_any_storage<
+				sizeof(string) + sizeof(void*)>>;
+			any_t x(string("bar")), y(x), z(std::move(x));
+
+			return !x.has_value() && any_cast<string&>(y)
+				== *any_cast<string>(&z) ? any_cast<string>(z) : string();
+		}),
+		expect(true, []{
+			using any_t = basic_any<any_ops::basic_any_storage<
+				sizeof(string) + sizeof(void*)>>;
+			static_assert(is_nothrow_move_constructible<any_t>(), "");
+			any_t x(string("baz"), any_ops::use_holder);
+			const auto p(x.get_holder());
+
+			return static_cast<const void*>(p) >= static_cast<const void*>(&x)
+				&& static_cast<const void*>(p) < static_cast<const void*>(&x + 1);
+		})
+	);
+	// 2 cases covering: ystdex::pooled_allocator.
+	seq_apply(make_guard("YStandard.PooledAllocator").get(pass, fail),
+		expect(true, []{
+			pooled_allocator<long> a;
+			const auto p(a.allocate(1));
+
+			a.deallocate(p, 1);
+
+			const auto q(a.allocate(1));
+			const bool res(p == q);
+
+			a.deallocate(q, 1);
+			return res;
+		}),
+		expect(string("bar"), []{
+			using set_t = mapped_set<string, ystdex::less<>,
+				pooled_allocator<string>>;
+			set_t x{string("foo"), string("bar")};
+			const auto p(&*x.find("bar"));
+			set_t y(std::move(x));
+
+			return &*y.find("bar") == p ? *y.begin() : string();
+		})
+	);
+	// 4 cases covering: ytest::bench::percentile,
+	//	ytest::bench::result::update_statistics.
+	seq_apply(make_guard("YTest.Bench").get(pass, fail),
+		std::fabs(bench::percentile({1, 2, 3, 4}, .5) - 2.5)
+			< numeric_limits<double>::epsilon(),
+		std::fabs(bench::percentile({1, 2, 3, 4}, 1) - 4.)
+			< numeric_limits<double>::epsilon(),
+		expect(size_t(1), []{
+			bench::result r;
+
+			r.samples = {10, 11, 9, 10, 12, 10, 100};
+			r.update_statistics();
+			return r.outliers;
+		}),
+		expect(size_t(1), []{
+			vector<bench::result> results(2);
+			istringstream iss("name,median_ns\nA,10\nB,10\n");
+
+			yunseq(results[0].name = "A", results[0].median = 10.5,
+				results[1].name = "B", results[1].median = 12);
+			return bench::compare(iss, results, .1);
+		})
+	);
 	show_result(cout, "ALL", pass_n, fail_n);
 }
 
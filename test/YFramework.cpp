@@ -0,0 +1,979 @@
+﻿/*
+	© 2017 FrankHB.
+
+	This file is part of the YSLib project, and may only be used,
+	modified, and distributed under the terms of the YSLib project
+	license, LICENSE.TXT.  By continuing to use, modify, or distribute
+	this file you indicate that you have read the license and
+	understand and accept it fully.
+*/
+
+/*!	\file YFramework.cpp
+\ingroup Test
+\brief YFramework 测试和基准测试。
+\version r14
+\author FrankHB <frankhb1989@gmail.com>
+\since build 819
+\par 创建时间:
+	2017-08-02 14:10:26 +0800
+\par 修改时间:
+	2017-08-06 21:30 +0800
+\par 文本编码:
+	UTF-8
+\par 模块名称:
+	Test::YFramework
+
+默认运行测试；第一个参数为 --bench 时运行基准测试。
+测试检查分配次数时替换全局分配函数。
+基准测试覆盖图形、文本、 NPL 、文件 IO 、消息队列、事件和命中测试的热点路径。
+使用以下环境变量：
+YTest_DataDir 数据目录，用于载入 cp113.bin 和界面测试；
+YTest_FontFile 字体文件，用于文本渲染和界面测试；
+YTest_WorkDir 生成测试输入文件的目录，默认为当前目录。
+未找到所需的文件时，跳过对应的测试或基准测试。
+*/
+
+
+#include <ytest/test.h>
+#include <ytest/bench.h>
+#include <YSBuild.h>
+#include YFM_NPL_NPLA1
+#include YFM_NPL_Dependency
+#include YFM_CHRLib_MappingEx
+#include YFM_YCLib_Host // for platform_ex::FetchPersistentCommandOutput;
+#include YFM_YSLib_Service_FileSystem // for IO::TraverseRecursively;
+#include <ystdex/concurrency.h> // for ystdex::task_pool;
+#include YFM_YSLib_Service_TextRenderer
+#include YFM_YSLib_Service_TextManager
+#include <ystdex/functional.hpp> // for ystdex::seq_apply;
+#include <algorithm> // for std::count, std::sort;
+#include <atomic>
+#include <cstdio> // for std::remove;
+#include <cstdlib>
+#include <cstring> // for std::memcmp;
+#include <fstream>
+#include <iostream>
+#include <iterator> // for std::istreambuf_iterator;
+#include <new>
+#include <sstream>
+
+namespace
+{
+
+/*!
+\brief 全局分配函数的调用次数。
+\since build 823
+*/
+std::atomic<std::size_t> AllocationCount{};
+
+} // unnamed namespace;
+
+//! \since build 823
+//@{
+void*
+operator new(std::size_t size)
+{
+	++AllocationCount;
+	if(const auto p = std::malloc(size != 0 ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) ynothrow
+{
+	std::free(p);
+}
+//@}
+
+
+namespace
+{
+
+using namespace YSLib;
+using namespace CHRLib;
+using namespace Drawing;
+using namespace UI;
+using namespace NPL;
+using namespace ytest;
+
+//! \brief 图形测试使用的屏幕大小。
+yconstexpr const Size ScreenSize(1280, 720);
+//! \brief 生成的文本和文件的大小。
+yconstexpr const size_t TextSize(4U << 20);
+
+string
+FetchEnv(const char* name, const char* def = "")
+{
+	const auto val(std::getenv(name));
+
+	return val && *val != char() ? string(val) : string(def);
+}
+
+string
+MakeWorkPath(const string& name)
+{
+	auto dir(FetchEnv("YTest_WorkDir", "."));
+
+	if(dir.back() != '/')
+		dir += '/';
+	return dir + name;
+}
+
+
+//! \brief 生成包含中文和拉丁字符的文本页。
+String
+MakePage()
+{
+	static yconstexpr const char16_t cjk[]{u"基准测试覆盖文本渲染的热点路径，"
+		u"包括字形缓存、光栅化和混合。"};
+	static yconstexpr const char16_t latin[]{u"The quick brown fox jumps over "
+		u"the lazy dog. 0123456789 "};
+	String res;
+
+	for(size_t i(0); i != 24; ++i)
+		res += String(i % 2 == 0 ? cjk : latin) + u'\n';
+	return res;
+}
+
+/*!
+\brief 生成指定编码的文本。
+\note GBK 文本仅包含 GB2312 区域的双字节字符和 ASCII 字符。
+*/
+string
+MakeText(Encoding enc)
+{
+	string res;
+
+	res.reserve(TextSize);
+	for(size_t i(0); res.size() < TextSize; ++i)
+	{
+		if(i % 8 == 7)
+			res += "Latin text 0123456789.\n";
+		else if(enc == CharSet::GBK)
+		{
+			res += char(0xB0 + i % 0x28);
+			res += char(0xA1 + i % 0x5E);
+		}
+		else
+		{
+			const auto c(char32_t(0x4E00 + (i * 7) % 0x5000));
+
+			res += char(0xE0 | c >> 12);
+			res += char(0x80 | (c >> 6 & 0x3F));
+			res += char(0x80 | (c & 0x3F));
+		}
+	}
+	return res;
+}
+
+void
+WriteFile(const string& path, const string& content)
+{
+	std::ofstream ofs(path, std::ios_base::binary);
+
+	if(!(ofs << content))
+		throw std::runtime_error("Failed writing '" + path + "'.");
+}
+
+//! \brief 生成多次调用函数的 NPLA1 表达式。
+string
+MakeScript(size_t n)
+{
+	std::ostringstream oss;
+
+	oss << "list";
+	for(size_t i(0); i != n; ++i)
+		oss << " (bench-concat (bench-concat \"a" << i << "\" \"b\") "
+			"($if (null? ()) \"c\" \"d\"))";
+	return oss.str();
+}
+
+
+//! \since build 819
+//@{
+YTEST_BENCH(RenderCopyFullScreen, n)
+{
+	static const CompactPixmap src([]{
+		CompactPixmap buf(nullptr, ScreenSize.Width, ScreenSize.Height);
+		const auto p(buf.GetBufferPtr());
+
+		for(size_t i(0); i != GetAreaOf(ScreenSize); ++i)
+			p[i] = Color(byte(i), byte(i >> 8), byte(i >> 16));
+		return buf;
+	}());
+	static CompactPixmap dst(nullptr, ScreenSize.Width, ScreenSize.Height);
+
+	for(size_t i(0); i != n; ++i)
+	{
+		CopyTo(dst.GetBufferPtr(), src.GetContext(), ScreenSize, {}, {},
+			ScreenSize);
+		bench::do_not_optimize(dst.GetBufferPtr()[i % ScreenSize.Width]);
+	}
+}
+
+YTEST_BENCH(RenderAlphaBlitFullScreen, n)
+{
+	static const CompactPixmapEx src([]{
+		CompactPixmapEx buf(nullptr, ScreenSize.Width, ScreenSize.Height);
+		const auto p(buf.GetBufferPtr());
+		const auto pa(buf.GetBufferAlphaPtr());
+
+		for(size_t i(0); i != GetAreaOf(ScreenSize); ++i)
+			yunseq(p[i] = Color(byte(i), byte(i >> 4), byte(i >> 8)),
+				pa[i] = AlphaType(i % ScreenSize.Width));
+		return buf;
+	}());
+	static CompactPixmap dst(nullptr, ScreenSize.Width, ScreenSize.Height);
+
+	for(size_t i(0); i != n; ++i)
+	{
+		BlitTo(dst.GetBufferPtr(), src, ScreenSize, {}, {}, ScreenSize);
+		bench::do_not_optimize(dst.GetBufferPtr()[i % ScreenSize.Width]);
+	}
+}
+
+YTEST_BENCH(TextDecodeUTF8, n)
+{
+	static const auto text(MakeText(CharSet::UTF_8));
+
+	for(size_t i(0); i != n; ++i)
+	{
+		const char* p(&text[0]);
+		const auto e(p + text.size());
+		char16_t c;
+		size_t cnt(0);
+
+		while(p != e && MBCToUC(c, p, e, CharSet::UTF_8)
+			== ConversionResult::OK)
+			++cnt;
+		bench::do_not_optimize(cnt);
+	}
+}
+
+YTEST_BENCH(TextFileBufferIterateUTF8, n)
+{
+	// NOTE: Only complete lines in a part of the text are used to keep
+	//	sampling time reasonable since each iteration converts the whole buffer.
+	static const auto text([]{
+		const auto str(MakeText(CharSet::UTF_8));
+
+		return str.substr(0, str.rfind('\n', TextSize / 8) + 1);
+	}());
+
+	for(size_t i(0); i != n; ++i)
+	{
+		std::stringbuf sb(text, std::ios_base::in);
+		Text::TextFileBuffer tbuf(sb, CharSet::UTF_8);
+		size_t cnt(0);
+
+		for(auto it(tbuf.begin()); it != tbuf.end(); ++it)
+			cnt += *it;
+		bench::do_not_optimize(cnt);
+	}
+}
+
+YTEST_BENCH(NPLAnalyze, n)
+{
+	static const auto src(MakeScript(4000));
+
+	for(size_t i(0); i != n; ++i)
+		bench::do_not_optimize(SContext::Analyze(Session(src)));
+}
+
+YTEST_BENCH(NPLA1Evaluate, n)
+{
+	static const auto src(MakeScript(1000));
+	static A1::REPLContext context;
+	static const bool initialized([]{
+		A1::Forms::LoadNPLContextForSHBuild(context);
+		context.Perform("$def! bench-concat $lambda (x y) ++ x y");
+		return true;
+	}());
+
+	yunused(initialized);
+	for(size_t i(0); i != n; ++i)
+		bench::do_not_optimize(context.Perform(src));
+}
+
+//! \since build 823
+YTEST_BENCH(NPLA1TailRecursion, n)
+{
+	// NOTE: Each step is a tail call of a closure, which should not nest
+	//	native frames or retain the environment of the previous step.
+	static const auto src([]{
+		string str("bench-drop (list");
+
+		for(size_t i(0); i != 1024; ++i)
+			str += " ()";
+		return str + ")";
+	}());
+	static A1::REPLContext context;
+	static const bool initialized([]{
+		A1::Forms::LoadNPLContextForSHBuild(context);
+		context.Perform("$defl! bench-drop (l) $if (null? l) l"
+			" (bench-drop (rest l))");
+		return true;
+	}());
+
+	yunused(initialized);
+	for(size_t i(0); i != n; ++i)
+		bench::do_not_optimize(context.Perform(src));
+}
+
+YTEST_BENCH(MappedFileRead, n)
+{
+	static const auto path([]{
+		const auto res(MakeWorkPath("YFramework.bench.mapped"));
+
+		WriteFile(res, MakeText(CharSet::UTF_8));
+		return res;
+	}());
+
+	for(size_t i(0); i != n; ++i)
+	{
+		const MappedFile mapped(path);
+		const auto p(mapped.GetPtr());
+		size_t sum(0);
+
+		for(size_t j(0); j < mapped.GetSize(); j += 64)
+			sum += p[j];
+		bench::do_not_optimize(sum);
+	}
+}
+//@}
+
+//! \since build 823
+//@{
+YTEST_BENCH(MessageQueuePushPop, n)
+{
+	static MessageQueue queue;
+	Message msg;
+
+	for(size_t i(0); i != n; ++i)
+	{
+		for(size_t j(0); j != 256; ++j)
+			queue.Push(Message(Messaging::ID(j + 1), j), Messaging::Priority(
+				j * 37 % MessageQueue::PriorityCount));
+		while(!queue.empty())
+			bench::do_not_optimize(queue.Pop(msg));
+	}
+}
+
+YTEST_BENCH(MessageQueuePushConcurrentPop, n)
+{
+	static MessageQueue queue;
+	Message msg;
+
+	for(size_t i(0); i != n; ++i)
+	{
+		for(size_t j(0); j != 256; ++j)
+			queue.PushConcurrent(Message(Messaging::ID(j + 1), j),
+				Messaging::Priority(j * 37 % MessageQueue::PriorityCount));
+		while(!queue.empty())
+			bench::do_not_optimize(queue.Pop(msg));
+	}
+}
+
+YTEST_BENCH(EventDispatch, n)
+{
+	static const auto evt([]{
+		GEvent<void(size_t&)> res;
+
+		for(size_t i(0); i != 8; ++i)
+			res += [i](size_t& x) ynothrow{
+				x += i;
+			};
+		return res;
+	}());
+
+	for(size_t i(0); i != n; ++i)
+	{
+		size_t x(i);
+
+		evt(x);
+		bench::do_not_optimize(x);
+	}
+}
+//@}
+
+
+/*!
+\brief 注册依赖外部数据的基准测试。
+\since build 819
+*/
+//@{
+void
+RegisterGBK(MappedFile& mapping)
+{
+	const auto data_dir(FetchEnv("YTest_DataDir"));
+
+	TryExpr(mapping = MappedFile(data_dir + "/cp113.bin"))
+	catch(std::exception& e)
+	{
+		std::cerr << "Skipped GBK benchmarks: " << e.what() << std::endl;
+		return;
+	}
+	CHRLib::cp113 = mapping.GetPtr();
+	bench::registry::instance().add("TextDecodeGBK", [](size_t n){
+		static const auto text(MakeText(CharSet::GBK));
+
+		for(size_t i(0); i != n; ++i)
+		{
+			const char* p(&text[0]);
+			const auto e(p + text.size());
+			char16_t c;
+			size_t cnt(0);
+
+			while(p != e && MBCToUC(c, p, e, CharSet::GBK)
+				== ConversionResult::OK)
+				++cnt;
+			bench::do_not_optimize(cnt);
+		}
+	});
+}
+
+void
+RegisterTextRendering(FontCache& cache)
+{
+	const auto path(FetchEnv("YTest_FontFile"));
+	shared_ptr<TextState> p_ts;
+
+	if(!path.empty() && cache.LoadTypefaces(path) != 0)
+	{
+		cache.InitializeDefaultTypeface();
+		// NOTE: Only faces with regular style can be used by default.
+		TryExpr(p_ts = make_shared<TextState>(cache))
+		CatchIgnore(LoggedEvent&)
+	}
+	if(!p_ts)
+	{
+		std::cerr << "Skipped text rendering benchmarks: no usable font loaded"
+			" from YTest_FontFile." << std::endl;
+		return;
+	}
+
+	const auto render([=](size_t n, GlyphCache* p_cache){
+		static const auto page(MakePage());
+		static CompactPixmap buf(nullptr, ScreenSize.Width, ScreenSize.Height);
+		const Rect bounds(ScreenSize);
+
+		p_ts->GlyphCachePtr = make_observer(p_cache);
+		for(size_t i(0); i != n; ++i)
+		{
+			p_ts->ResetPen(bounds.GetPoint());
+			DrawClippedText(buf.GetContext(), bounds, *p_ts, page, true);
+			bench::do_not_optimize(buf.GetBufferPtr()[i % ScreenSize.Width]);
+		}
+	});
+
+	bench::registry::instance().add("TextRenderPage", [=](size_t n){
+		render(n, {});
+	});
+	bench::registry::instance().add("TextRenderPageCached", [=](size_t n){
+		static GlyphCache glyph_cache;
+
+		render(n, &glyph_cache);
+	});
+	bench::registry::instance().add("TextRenderPageRun", [=](size_t n){
+		static const auto page(MakePage());
+		static CompactPixmap buf(nullptr, ScreenSize.Width, ScreenSize.Height);
+		const Rect bounds(ScreenSize);
+
+		p_ts->GlyphCachePtr = {};
+		p_ts->ResetPen(bounds.GetPoint());
+
+		const TextRun run(*p_ts, ScreenSize, page, true);
+
+		for(size_t i(0); i != n; ++i)
+		{
+			DrawClippedText(buf.GetContext(), bounds, *p_ts, run);
+			bench::do_not_optimize(buf.GetBufferPtr()[i % ScreenSize.Width]);
+		}
+	});
+}
+//@}
+
+/*!
+\brief 注册命中测试基准测试。
+\note 计时前构造包含 800 个控件的面板和子部件索引。
+\since build 823
+*/
+void
+RegisterHitTesting()
+{
+	struct Fixture
+	{
+		Panel Root{{0, 0, 1600, 1200}};
+		vector<unique_ptr<Control>> Controls{};
+
+		Fixture(bool indexed)
+		{
+			for(size_t i(0); i != 800; ++i)
+			{
+				Controls.push_back(make_unique<Control>(Rect(SPos(i * 7919
+					% 1560), SPos(i * 104729 % 1170), 40, 30)));
+				Root += *Controls.back();
+			}
+			SetChildIndexingOf(Root, indexed);
+			if(const auto p_index = FetchChildIndexPtr(Root))
+				p_index->Rebuild(Root);
+		}
+	};
+	const auto is_target([](IWidget& wgt){
+		return IsVisible(wgt) && IsEnabled(wgt);
+	});
+	const auto run([](size_t n, std::function<IWidget*(const Point&)> find){
+		for(size_t i(0); i != n; ++i)
+			bench::do_not_optimize(find(Point(SPos(i * 613 % 1600),
+				SPos(i * 397 % 1200))));
+	});
+	const auto p_linear(make_shared<Fixture>(false));
+	const auto p_grid(make_shared<Fixture>(true));
+
+	bench::registry::instance().add("UIHitTestLinear", [=](size_t n){
+		run(n, [&](const Point& pt) -> IWidget*{
+			for(auto pr(p_linear->Root.GetChildren()); pr.first != pr.second;
+				++pr.first)
+			{
+				auto& wgt(*pr.first);
+
+				if(Contains(wgt, pt) && is_target(wgt))
+					return &wgt;
+			}
+			return {};
+		});
+	});
+	bench::registry::instance().add("UIHitTestGrid", [=](size_t n){
+		run(n, [&](const Point& pt){
+			return Deref(FetchChildIndexPtr(p_grid->Root)).Find(p_grid->Root,
+				pt, is_target).get();
+		});
+	});
+}
+
+
+/*!
+\brief 初始化界面测试使用的应用程序实例。
+\return 是否成功。
+\note 使用 YTest_DataDir 和 YTest_FontFile 覆盖应用程序的配置文件。
+\since build 823
+
+部件的默认字体需要应用程序实例中的默认字体缓存。
+配置文件位于可执行文件所在的目录。
+*/
+bool
+InitializeApplication(unique_ptr<GUIApplication>& p_app)
+{
+	const auto data_dir(FetchEnv("YTest_DataDir", "."));
+	const auto font_path(FetchEnv("YTest_FontFile"));
+
+	if(font_path.empty())
+	{
+		std::cerr << "Skipped UI tests: no font file specified by"
+			" YTest_FontFile." << std::endl;
+		return {};
+	}
+	try
+	{
+		ValueNode root;
+
+		root.insert(ValueNode(NodeLiteral{"YFramework",
+			{{"DataDirectory", data_dir + '/'}, {"FontFile", font_path},
+			{"FontDirectory", data_dir + '/'}}}));
+		SaveConfiguration(root);
+		p_app = make_unique<GUIApplication>();
+		FetchDefaultTypeface();
+		return true;
+	}
+	CatchExpr(std::exception& e, std::cerr << "Skipped UI tests: " << e.what()
+		<< std::endl)
+	p_app.reset();
+	return {};
+}
+
+/*!
+\brief 运行测试并输出结果。
+\param ui 是否运行需要应用程序实例的界面测试。
+\return 失败的测试用例数。
+\since build 823
+*/
+size_t
+RunTests(bool ui)
+{
+	using ystdex::seq_apply;
+	using std::cout;
+	using std::endl;
+	using Event = GEvent<void(string&)>;
+	// NOTE: Equality comparable handler to be removed by %GEvent::operator-=.
+	struct Append
+	{
+		char Value;
+
+		void
+		operator()(string& str) const
+		{
+			str += Value;
+		}
+
+		PDefHOp(bool, ==, const Append& x) const ynothrow
+			ImplRet(Value == x.Value)
+	};
+	const auto make_guard([](const string& subject){
+		return group_guard(subject, [](group_guard& printer){
+			cout << "CASES: " << printer.subject << ':' << endl;
+		}, [](group_guard& printer){
+			cout << printer.subject << ": " << printer.pass_n << '/'
+				<< printer.pass_n + printer.fail_n << '.' << endl;
+		});
+	});
+	size_t pass_n(0), fail_n(0), case_n(0);
+	const auto pass([&]{
+		yunseq(++pass_n, cout << '#' << ++case_n << ": PASS." << endl);
+	});
+	const auto fail([&]{
+		yunseq(++fail_n, cout << '#' << ++case_n << ": FAIL." << endl);
+	});
+
+	// 1 case covering: YSLib::ValueObject.
+	seq_apply(make_guard("YSLib.Core.YObject").get(pass, fail),
+		// NOTE: Short strings are held in place by %ValueStorage.
+		expect(size_t(0), []{
+			const size_t n(AllocationCount);
+			ValueObject x(string("foo")), y(x), z(std::move(y));
+
+			swap(x, z);
+			return x.GetObject<string>() == "foo" ? AllocationCount - n
+				: size_t(-1);
+		})
+	);
+	// 5 cases covering: YSLib::GEvent, YSLib::GHandlerList.
+	seq_apply(make_guard("YSLib.Core.YEvent").get(pass, fail),
+		// NOTE: No allocation for one handler.
+		expect(make_pair(string("aa"), size_t(0)), []{
+			const size_t n(AllocationCount);
+			Event e;
+			string str;
+
+			e(str);
+			e += Append{'a'};
+			e(str);
+
+			Event e2(std::move(e));
+
+			e2(str);
+			return make_pair(str, AllocationCount - n);
+		}),
+		expect(string("33b21"), []{
+			Event e;
+			string str;
+
+			e.Add(Append{'1'}, 1);
+			e.Add([](string& s){
+				s += "3";
+			}, 3);
+			e.Add(Append{'2'}, 2);
+			e.Add([](string& s){
+				s += "3b";
+			}, 3);
+			e(str);
+			return e.count(3) == 2 ? str : string();
+		}),
+		// NOTE: Removed handlers are no longer called.
+		expect(string("ard/rd"), []{
+			Event e;
+			string str;
+
+			e += Append{'a'};
+			e += [&](string& s){
+				s += 'r';
+				e -= Append{'a'};
+				e -= Append{'c'};
+			};
+			e += Append{'c'};
+			e += Append{'d'};
+			e(str);
+			str += '/';
+			e(str);
+			return e.size() == 2 ? str : string();
+		}),
+		// NOTE: Added handlers are called after the invocation ends.
+		expect(string("x/nx"), []{
+			Event e;
+			string str;
+
+			e += [&](string& s){
+				s += 'x';
+				e.Add(Append{'n'}, 0xFF);
+			};
+			e(str);
+			str += '/';
+			e(str);
+			return e.size() == 3 ? str : string();
+		}),
+		expect(string("ook"), []{
+			Event e;
+			string str;
+			size_t depth(0);
+
+			e += [&](string& s){
+				s += 'o';
+				if(depth++ == 0)
+					e(s);
+			};
+			e += [&](string& s){
+				s += 'k';
+				e.clear();
+			};
+			e += Append{'z'};
+			e(str);
+			return e.empty() ? str : string();
+		})
+	);
+#if !YCL_Win32
+	// 1 case covering: platform_ex::FetchPersistentCommandOutput.
+	seq_apply(make_guard("YCLib.Host").get(pass, fail),
+		// NOTE: Results with nonzero exit status are not cached, so the
+		//	failed command is run twice.
+		expect(make_pair(size_t(2), size_t(1)), []{
+			const auto dir(MakeWorkPath(".command-cache"));
+			const auto log(MakeWorkPath("command-cache.log"));
+			// NOTE: Commands are distinct in each run to avoid entries cached
+			//	by previous runs.
+			const auto suffix(" # " + to_string(
+				Timers::HighResolutionClock::now().time_since_epoch().count()));
+			const auto count_runs([&](const string& cmd){
+				std::remove(log.c_str());
+				for(size_t i(0); i != 2; ++i)
+					platform_ex::FetchPersistentCommandOutput("echo >> '" + log
+						+ "'; " + cmd + suffix, dir);
+
+				std::ifstream ifs(log);
+
+				return size_t(std::count(std::istreambuf_iterator<char>(ifs),
+					std::istreambuf_iterator<char>(), '\n'));
+			});
+
+			IO::EnsureDirectory(dir);
+			return make_pair(count_runs("exit 3"), count_runs("true"));
+		})
+	);
+#endif
+#if YF_Multithread == 1
+	// 1 case covering: IO::TraverseRecursively.
+	seq_apply(make_guard("YSLib.Service.FileSystem").get(pass, fail),
+		// NOTE: The concurrent traversal visits the same nodes as the
+		//	sequential one, including pruning of directories.
+		expect(true, []{
+			using namespace IO;
+			const Path root(MakeWorkPath(".traverse-test"));
+			std::function<void(const Path&, size_t)> generate;
+
+			// NOTE: Existing directories from previous runs are reused.
+			generate = [&](const Path& dir, size_t depth){
+				umkdir(string(dir).c_str());
+				for(size_t i(0); i != 3; ++i)
+					std::ofstream(string(dir / String("f" + to_string(i))));
+				std::ofstream(string(dir / u"xskip"));
+				if(depth != 0)
+				{
+					umkdir(string(dir / u"xpruned").c_str());
+					std::ofstream(string(dir / u"xpruned" / u"f"));
+					for(size_t i(0); i != 4; ++i)
+						generate(dir / String("d" + to_string(i)), depth - 1);
+				}
+			};
+			generate(root, 3);
+
+			const auto visit([](const Path& dir, NodeCategory c,
+				NativePathView npv){
+				return string(dir / String(npv))
+					+ (bool(c & NodeCategory::Directory) ? "/" : "");
+			});
+			const auto is_pruned([](NativePathView npv){
+				return !npv.empty() && npv[0] == 'x';
+			});
+			vector<string> seq, con;
+			std::function<void(const Path&)> traverse_seq;
+			std::mutex mtx;
+			ystdex::task_pool pool(4);
+
+			traverse_seq = [&](const Path& dir){
+				TraverseChildren(dir, [&](NodeCategory c, NativePathView npv){
+					seq.push_back(visit(dir, c, npv));
+					if(bool(c & NodeCategory::Directory) && !is_pruned(npv))
+						traverse_seq(dir / String(npv));
+				});
+			};
+			traverse_seq(root);
+			TraverseRecursively(pool, root, [&](const Path& dir,
+				NodeCategory c, NativePathView npv){
+				auto str(visit(dir, c, npv));
+				std::lock_guard<std::mutex> lck(mtx);
+
+				con.push_back(std::move(str));
+				return !is_pruned(npv);
+			});
+			std::sort(seq.begin(), seq.end());
+			std::sort(con.begin(), con.end());
+			return seq.size() > 100 && seq == con;
+		})
+	);
+#endif
+	if(ui)
+	{
+		using ListType = ListBox::ListType;
+		// NOTE: The first item is the widest one.
+		const auto p_items([]{
+			auto res(make_shared<ListType>(ListType{u"The widest item"}));
+
+			for(size_t i(1); i != 100; ++i)
+				res->push_back(String(to_string(i)));
+			return res;
+		}());
+		const auto set_provider([=](TextList& tl){
+			yunseq(
+			tl.CountItems = [=]{
+				return p_items->size();
+			},
+			tl.FetchItems = [=](size_t idx, size_t n){
+				const auto i(p_items->cbegin() + ptrdiff_t(idx));
+
+				return ListType(i, i + ptrdiff_t(n));
+			}
+			);
+		});
+
+		// 1 case covering: YSLib::RequestWakeUp, UI::TimedHoverState,
+		//	GUIApplication::GetIdleWaitDuration.
+		seq_apply(make_guard("Helper.GUIApplication").get(pass, fail),
+			// NOTE: The idle message loop is woken up at the deadline of the
+			//	timer rather than after %GUIApplication::MaxIdleWait.
+			expect(true, []{
+				using Timers::HighResolutionClock;
+				auto& app(FetchGlobalInstance());
+				const auto d(std::chrono::milliseconds(20));
+				TimedHoverState st(TimedHoverState::DefaultLocate, d);
+				const auto start(HighResolutionClock::now());
+				const bool res(!st.Check() && app.GetIdleWaitDuration() <= d);
+
+				while(!st.Check())
+					app.WaitForMessage(app.GetIdleWaitDuration());
+
+				const auto t(HighResolutionClock::now() - start);
+
+				return res && d <= t && t < app.MaxIdleWait;
+			})
+		);
+		// 3 cases covering: UI::ListBox, UI::DropDownList, UI::MTextList.
+		seq_apply(make_guard("YSLib.UI.ComboList").get(pass, fail),
+			expect(true, [&]{
+				ListBox lb({}, p_items), lb_provided;
+
+				set_provider(lb_provided.GetTextListRef());
+				lb.ResizeForPreferred({0, 100});
+				lb_provided.ResizeForPreferred({0, 100});
+				return lb_provided.GetList().empty() && lb_provided.GetTotal()
+					== lb.GetTotal() && lb_provided.GetWidth() == lb.GetWidth();
+			}),
+			// NOTE: The item equal to the text is selected when the list is
+			//	shown.
+			expect(size_t(3), [&]{
+				Panel pnl({0, 0, 320, 240});
+				DropDownList ddl({8, 8, 80, 20});
+
+				set_provider(ddl.GetTextListRef());
+				ddl.Text = (*p_items)[3];
+				pnl += ddl;
+				CallEvent<TouchDown>(ddl, CursorEventArgs(ddl, {}, {1, 1}));
+				return ddl.GetTextListRef().IsSelected()
+					? ddl.GetTextListRef().GetSelectedIndex() : size_t();
+			}),
+			expect(String(u"7"), [&]{
+				DropDownList ddl;
+
+				set_provider(ddl.GetTextListRef());
+				ddl.GetConfirmed()(IndexEventArgs(ddl, 7));
+				return ddl.Text;
+			})
+		);
+#if YF_Multithread == 1
+		// 1 case covering: UI::ConcurrentPainter, UI::SetConcurrentPainterOf,
+		//	UI::SetPaintThreadSafeOf, UI::PaintVisibleChildrenAndCommit.
+		seq_apply(make_guard("YSLib.UI.ConcurrentPainter").get(pass, fail),
+			// NOTE: Thread-safe children are batched only when they are
+			//	disjoint. Other children are painted in order, so the result
+			//	is the same as the sequential one even if unsafe children
+			//	overlap thread-safe ones painted before and after them.
+			expect(true, []{
+				using namespace ColorSpace;
+				const Size s(64, 48);
+				Panel pnl{Rect(s)};
+				Control a({0, 0, 16, 16}, SolidBrush(Red)),
+					b({16, 0, 16, 16}, SolidBrush(Lime)),
+					c({32, 0, 16, 16}, SolidBrush(Blue)),
+					u({8, 8, 24, 16}, SolidBrush(Yellow)),
+					d({20, 12, 16, 16}, SolidBrush(Fuchsia)),
+					f({40, 8, 16, 16}, SolidBrush(Aqua)),
+					v({0, 32, 16, 16}, SolidBrush(Black));
+				const auto paint([&]{
+					CompactPixmap buf(nullptr, s.Width, s.Height);
+
+					PaintChild(pnl, {buf.GetContext(), {}, Rect(s)});
+					return buf;
+				});
+
+				for(auto p : {&a, &b, &c, &u, &d, &f, &v})
+					pnl += *p;
+				for(auto p : {&a, &b, &c, &d, &f})
+					SetPaintThreadSafeOf(*p, true);
+
+				const auto seq(paint());
+
+				SetConcurrentPainterOf(pnl, make_shared<ConcurrentPainter>(4));
+
+				const auto con(paint());
+
+				return bool(FetchConcurrentPainterPtr(pnl))
+					&& std::memcmp(seq.GetBufferPtr(), con.GetBufferPtr(),
+					s.Width * s.Height * sizeof(Pixel)) == 0;
+			})
+		);
+#endif
+	}
+	cout << "ALL: " << pass_n << '/' << pass_n + fail_n << '.' << endl;
+	return fail_n;
+}
+
+} // unnamed namespace;
+
+
+int
+main(int argc, char* argv[])
+{
+	return FilterExceptions([&]{
+		// NOTE: Run benchmarks instead of tests when '--bench' is specified.
+		if(argc > 1 && string(argv[1]) == "--bench")
+		{
+			bench::options opts;
+			MappedFile mapping;
+			FontCache cache;
+
+			if(!opts.parse(argc, argv))
+				throw std::invalid_argument("Invalid benchmark options.");
+			RegisterGBK(mapping);
+			RegisterTextRendering(cache);
+			RegisterHitTesting();
+			if(bench::registry::instance().run(opts, std::cout) != 0)
+				throw LoggedEvent("Performance regression found.");
+		}
+		else
+		{
+			unique_ptr<GUIApplication> p_app;
+
+			if(RunTests(InitializeApplication(p_app)) != 0)
+				throw LoggedEvent("Test failed.");
+		}
+	}, yfsig) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
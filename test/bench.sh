@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+# (C) 2017 FrankHB.
+# Script for testing and benchmarking YFramework.
+# Requires: G++/Clang++, YSLib libraries and scripts installed in sysroot.
+
+set -e
+: ${TestDir:=$(cd `dirname "$0"`; pwd)}
+: ${YSLib_BaseDir:="$TestDir/.."}
+YSLib_BaseDir=$(cd "$YSLib_BaseDir" && pwd)
+: ${SHBuild_SysRoot:="$YSLib_BaseDir/sysroot"}
+: ${SHBuild_Bin:="$SHBuild_SysRoot/usr/bin"}
+
+SHBuild_NoAdjustSubsystem=true
+
+: ${AR:='gcc-ar'}
+. "$SHBuild_Bin/SHBuild-BuildApp.sh"
+
+# NOTE: Output format of the results. It can be 'text', 'json' or 'csv'.
+: ${YTest_BenchFormat:='csv'}
+# NOTE: A previous result in CSV format to find regressions.
+: ${YTest_BenchBaseline:=''}
+: ${YTest_DataDir:="$YSLib_BaseDir/Data"}
+export YTest_DataDir
+export YTest_FontFile
+
+SHBuild_CheckHostPlatform
+Test_BuildDir="$YSLib_BaseDir/build/$SHBuild_Host_Platform/.bench"
+mkdir -p $Test_BuildDir
+SHBuild_Pushd $Test_BuildDir
+
+: ${YTest_BenchOutput:="$Test_BuildDir/YFramework.$YTest_BenchFormat"}
+
+# NOTE: The flags and libraries contain quoted paths.
+eval "\"$CXX\" \"$TestDir/YFramework.cpp\" -oYFramework$EXESFX $CXXFLAGS \
+	$LDFLAGS $SHBuild_YSLib_Flags $LIBS" '"$@"'
+
+Bench_Opts="--bench-format=$YTest_BenchFormat \
+--bench-output=$YTest_BenchOutput"
+if [[ "$YTest_BenchBaseline" != '' ]]; then
+	Bench_Opts="$Bench_Opts --bench-baseline=$YTest_BenchBaseline"
+fi
+./YFramework
+YTest_WorkDir="$Test_BuildDir" ./YFramework --bench $Bench_Opts \
+	$YTest_BenchOptions
+
+SHBuild_Popd
+
+SHBuild_Puts Results are written to \"$YTest_BenchOutput\".
+echo Done.
+
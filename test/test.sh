@@ -27,9 +27,11 @@ INCLUDES=" \
 	"
 
 LIBS=" \
+	$YSLib_BaseDir/YBase/source/ystdex/any.cpp \
 	$YSLib_BaseDir/YBase/source/ystdex/cassert.cpp \
 	$YSLib_BaseDir/YBase/source/ystdex/cstdio.cpp \
 	$YSLib_BaseDir/YBase/source/ytest/test.cpp \
+	$YSLib_BaseDir/YBase/source/ytest/bench.cpp \
 	"
 
 SHBuild_CheckHostPlatform
@@ -43,6 +45,9 @@ SHBuild_CheckPCH "$INCLUDE_PCH" "stdinc.h"
 	$INCLUDES $LIBS "$@"
 
 ./YBase
+if [[ "$YTest_Bench" != '' ]]; then
+	./YBase --bench $YTest_BenchOptions
+fi
 
 SHBuild_Popd
 